@@ -189,6 +189,7 @@ const std::string& GetLayerName(LayerType layer)
       {LayerType::GlobalGame, "Global GameINI"},
       {LayerType::LocalGame, "Local GameINI"},
       {LayerType::Netplay, "Netplay"},
+      {LayerType::SceneProfile, "Scene Profile"},
       {LayerType::Movie, "Movie"},
       {LayerType::CommandLine, "Command Line"},
       {LayerType::CurrentRun, "Current Run"},
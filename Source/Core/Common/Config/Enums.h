@@ -16,6 +16,7 @@ enum class LayerType
   LocalGame,
   Movie,
   Netplay,
+  SceneProfile,
   CurrentRun,
   Meta,
 };
@@ -36,8 +37,9 @@ enum class System
   Achievements,
 };
 
-constexpr std::array<LayerType, 7> SEARCH_ORDER{{
+constexpr std::array<LayerType, 8> SEARCH_ORDER{{
     LayerType::CurrentRun,
+    LayerType::SceneProfile,
     LayerType::Netplay,
     LayerType::Movie,
     LayerType::LocalGame,
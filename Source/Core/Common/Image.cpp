@@ -3,8 +3,10 @@
 
 #include "Common/Image.h"
 
+#include <cstdlib>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <spng.h>
 
@@ -55,12 +57,10 @@ bool LoadPNG(std::span<const u8> input, Common::UniqueBuffer<u8>* data_out, u32*
   return true;
 }
 
-bool SavePNG(const std::string& path, const u8* input, ImageByteFormat format, u32 width,
-             u32 height, u32 stride, int level)
+// Sets up the header of an encoder and encodes the image row by row. Returns an spng error code.
+static int EncodePNGImage(spng_ctx* ctx, const u8* input, ImageByteFormat format, u32 width,
+                          u32 height, u32 stride, int level)
 {
-  Common::Timer timer;
-  timer.Start();
-
   spng_color_type color_type;
   switch (format)
   {
@@ -72,44 +72,56 @@ bool SavePNG(const std::string& path, const u8* input, ImageByteFormat format, u
     break;
   default:
     ASSERT_MSG(FRAMEDUMP, false, "Invalid format {}", static_cast<int>(format));
-    return false;
+    return SPNG_EINVAL;
   }
 
-  auto ctx = make_spng_ctx(SPNG_CTX_ENCODER);
-  if (!ctx)
-    return false;
-
-  auto outfile = File::IOFile(path, "wb");
-  if (spng_set_png_file(ctx.get(), outfile.GetHandle()))
-    return false;
-
-  if (spng_set_option(ctx.get(), SPNG_IMG_COMPRESSION_LEVEL, level))
-    return false;
+  if (const int err = spng_set_option(ctx, SPNG_IMG_COMPRESSION_LEVEL, level))
+    return err;
 
   spng_ihdr ihdr{};
   ihdr.width = width;
   ihdr.height = height;
   ihdr.color_type = color_type;
   ihdr.bit_depth = 8;
-  if (spng_set_ihdr(ctx.get(), &ihdr))
-    return false;
+  if (const int err = spng_set_ihdr(ctx, &ihdr))
+    return err;
 
-  if (spng_encode_image(ctx.get(), nullptr, 0, SPNG_FMT_PNG,
-                        SPNG_ENCODE_PROGRESSIVE | SPNG_ENCODE_FINALIZE))
+  if (const int err = spng_encode_image(ctx, nullptr, 0, SPNG_FMT_PNG,
+                                        SPNG_ENCODE_PROGRESSIVE | SPNG_ENCODE_FINALIZE))
   {
-    return false;
+    return err;
   }
   for (u32 row = 0; row < height; row++)
   {
-    const int err = spng_encode_row(ctx.get(), &input[row * stride], stride);
+    const int err = spng_encode_row(ctx, &input[row * stride], stride);
     if (err == SPNG_EOI)
       break;
     if (err)
-    {
-      ERROR_LOG_FMT(FRAMEDUMP, "Failed to save {} by {} image to {} at level {}: error {}", width,
-                    height, path, level, err);
-      return false;
-    }
+      return err;
+  }
+
+  return 0;
+}
+
+bool SavePNG(const std::string& path, const u8* input, ImageByteFormat format, u32 width,
+             u32 height, u32 stride, int level)
+{
+  Common::Timer timer;
+  timer.Start();
+
+  auto ctx = make_spng_ctx(SPNG_CTX_ENCODER);
+  if (!ctx)
+    return false;
+
+  auto outfile = File::IOFile(path, "wb");
+  if (spng_set_png_file(ctx.get(), outfile.GetHandle()))
+    return false;
+
+  if (const int err = EncodePNGImage(ctx.get(), input, format, width, height, stride, level))
+  {
+    ERROR_LOG_FMT(FRAMEDUMP, "Failed to save {} by {} image to {} at level {}: error {}", width,
+                  height, path, level, err);
+    return false;
   }
 
   size_t image_len = 0;
@@ -119,6 +131,35 @@ bool SavePNG(const std::string& path, const u8* input, ImageByteFormat format, u
   return true;
 }
 
+bool EncodePNG(std::vector<u8>* output, const u8* input, ImageByteFormat format, u32 width,
+               u32 height, u32 stride, int level)
+{
+  auto ctx = make_spng_ctx(SPNG_CTX_ENCODER);
+  if (!ctx)
+    return false;
+
+  if (spng_set_option(ctx.get(), SPNG_ENCODE_TO_BUFFER, 1))
+    return false;
+
+  if (const int err = EncodePNGImage(ctx.get(), input, format, width, height, stride, level))
+  {
+    ERROR_LOG_FMT(FRAMEDUMP, "Failed to encode {} by {} image at level {}: error {}", width,
+                  height, level, err);
+    return false;
+  }
+
+  size_t png_size = 0;
+  int err = 0;
+  void* const png = spng_get_png_buffer(ctx.get(), &png_size, &err);
+  if (!png)
+    return false;
+
+  const u8* const png_bytes = static_cast<const u8*>(png);
+  output->assign(png_bytes, png_bytes + png_size);
+  std::free(png);
+  return true;
+}
+
 static Common::UniqueBuffer<u8> RGBAToRGB(const u8* input, u32 width, u32 height, u32 row_stride)
 {
   Common::UniqueBuffer<u8> buffer;
@@ -5,6 +5,7 @@
 
 #include <span>
 #include <string>
+#include <vector>
 
 #include "Common/Buffer.h"
 #include "Common/CommonTypes.h"
@@ -22,6 +23,9 @@ enum class ImageByteFormat
 
 bool SavePNG(const std::string& path, const u8* input, ImageByteFormat format, u32 width,
              u32 height, u32 stride, int level = 6);
+// Like SavePNG, but replaces the contents of output with the PNG file instead of writing it to disk.
+bool EncodePNG(std::vector<u8>* output, const u8* input, ImageByteFormat format, u32 width,
+               u32 height, u32 stride, int level = 6);
 bool ConvertRGBAToRGBAndSavePNG(const std::string& path, const u8* input, u32 width, u32 height,
                                 u32 stride, int level);
 }  // namespace Common
@@ -0,0 +1,91 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+// a lockless thread-safe,
+// multiple producer, single consumer queue
+
+#include <atomic>
+#include <cassert>
+#include <utility>
+
+#include "Common/TypeUtils.h"
+
+namespace Common
+{
+// Producers never wait on each other or on the consumer: a push is one allocation and one atomic
+// exchange. A push that is still in progress may make the queue look empty to the consumer for a
+// moment, so producers should signal the consumer after pushing if it might be waiting.
+template <typename T>
+class MPSCQueue final
+{
+public:
+  MPSCQueue() = default;
+  ~MPSCQueue()
+  {
+    Clear();
+    delete m_read_ptr;
+  }
+
+  MPSCQueue(const MPSCQueue&) = delete;
+  MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+  // The following are safe from any thread:
+  void Push(const T& arg) { Emplace(arg); }
+  void Push(T&& arg) { Emplace(std::move(arg)); }
+  template <typename... Args>
+  void Emplace(Args&&... args)
+  {
+    Node* const new_node = new Node;
+    new_node->value.Construct(std::forward<Args>(args)...);
+
+    Node* const prev = m_write_ptr.exchange(new_node, std::memory_order_acq_rel);
+    prev->next.store(new_node, std::memory_order_release);
+  }
+
+  // The following are only safe from the "consumer thread":
+  bool Empty() const { return m_read_ptr->next.load(std::memory_order_acquire) == nullptr; }
+
+  T& Front() { return m_read_ptr->next.load(std::memory_order_acquire)->value.Ref(); }
+  const T& Front() const { return m_read_ptr->next.load(std::memory_order_acquire)->value.Ref(); }
+
+  void Pop()
+  {
+    assert(!Empty());
+
+    // The front value lives in the node after the read pointer, which becomes the new read
+    // pointer once its value is gone.
+    Node* const old_node = m_read_ptr;
+    m_read_ptr = old_node->next.load(std::memory_order_acquire);
+    m_read_ptr->value.Destroy();
+    delete old_node;
+  }
+
+  bool Pop(T& result)
+  {
+    if (Empty())
+      return false;
+
+    result = std::move(Front());
+    Pop();
+    return true;
+  }
+
+  void Clear()
+  {
+    while (!Empty())
+      Pop();
+  }
+
+private:
+  struct Node
+  {
+    ManuallyConstructedValue<T> value;
+    std::atomic<Node*> next = nullptr;
+  };
+
+  Node* m_read_ptr = new Node;
+  std::atomic<Node*> m_write_ptr = m_read_ptr;
+};
+}  // namespace Common
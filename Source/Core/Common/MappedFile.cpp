@@ -0,0 +1,138 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Common/MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+#include "Common/StringUtil.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef ANDROID
+#include "jni/AndroidCommon/AndroidCommon.h"
+#endif
+
+#include "Common/CommonFuncs.h"
+#include "Common/Logging/Log.h"
+
+namespace File
+{
+MappedFile::MappedFile() = default;
+
+MappedFile::MappedFile(const std::string& filename)
+{
+  Open(filename);
+}
+
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+bool MappedFile::Open(const std::string& filename)
+{
+  Close();
+
+#ifdef _WIN32
+  const HANDLE file = CreateFile(UTF8ToTStr(filename).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                 nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    ERROR_LOG_FMT(COMMON, "Failed to open {}: {}", filename, Common::GetLastErrorString());
+    return false;
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size))
+  {
+    ERROR_LOG_FMT(COMMON, "Failed to get the size of {}: {}", filename, Common::GetLastErrorString());
+    CloseHandle(file);
+    return false;
+  }
+
+  // Empty files can't be mapped, but there is nothing to map anyway
+  if (size.QuadPart != 0)
+  {
+    const HANDLE mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping)
+    {
+      // The view keeps the mapping and the file alive on its own
+      m_data = static_cast<const u8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+      CloseHandle(mapping);
+    }
+    if (!m_data)
+    {
+      ERROR_LOG_FMT(COMMON, "Failed to map {}: {}", filename, Common::GetLastErrorString());
+      CloseHandle(file);
+      return false;
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+  }
+  CloseHandle(file);
+#else
+  int fd;
+#ifdef ANDROID
+  if (IsPathAndroidContent(filename))
+    fd = OpenAndroidContent(filename, "r");
+  else
+#endif
+    fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+
+  if (fd < 0)
+  {
+    ERROR_LOG_FMT(COMMON, "Failed to open {}: {}", filename, Common::LastStrerrorString());
+    return false;
+  }
+
+  struct stat file_info;
+  if (fstat(fd, &file_info) != 0)
+  {
+    ERROR_LOG_FMT(COMMON, "Failed to get the size of {}: {}", filename, Common::LastStrerrorString());
+    close(fd);
+    return false;
+  }
+
+  // Empty files can't be mapped, but there is nothing to map anyway
+  if (file_info.st_size != 0)
+  {
+    void* const data =
+        mmap(nullptr, static_cast<size_t>(file_info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+      ERROR_LOG_FMT(COMMON, "Failed to map {}: {}", filename, Common::LastStrerrorString());
+      close(fd);
+      return false;
+    }
+    m_data = static_cast<const u8*>(data);
+    m_size = static_cast<size_t>(file_info.st_size);
+  }
+  // The mapping stays valid after the descriptor is closed
+  close(fd);
+#endif
+
+  m_is_open = true;
+  return true;
+}
+
+void MappedFile::Close()
+{
+  if (m_data)
+  {
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(const_cast<u8*>(m_data), m_size);
+#endif
+  }
+
+  m_data = nullptr;
+  m_size = 0;
+  m_is_open = false;
+}
+}  // namespace File
@@ -0,0 +1,38 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+namespace File
+{
+// Read-only view of a whole file. The contents are paged in by the OS as they are touched, rather
+// than read into a buffer up front.
+class MappedFile
+{
+public:
+  MappedFile();
+  explicit MappedFile(const std::string& filename);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool Open(const std::string& filename);
+  void Close();
+
+  bool IsOpen() const { return m_is_open; }
+  std::span<const u8> GetData() const { return {m_data, m_size}; }
+
+private:
+  const u8* m_data = nullptr;
+  size_t m_size = 0;
+  bool m_is_open = false;
+};
+}  // namespace File
@@ -27,6 +27,7 @@
 #include "Core/HW/Memmap.h"
 #include "Core/HW/SI/SI_Device.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/State.h"
 #include "DiscIO/Enums.h"
 #include "VideoCommon/VideoBackendBase.h"
 
@@ -263,6 +264,16 @@ const Info<DiscIO::Region> MAIN_FALLBACK_REGION{{System::Main, "Core", "Fallback
 const Info<bool> MAIN_AUTO_DISC_CHANGE{{System::Main, "Core", "AutoDiscChange"}, false};
 const Info<bool> MAIN_ALLOW_SD_WRITES{{System::Main, "Core", "WiiSDCardAllowWrites"}, true};
 const Info<bool> MAIN_ENABLE_SAVESTATES{{System::Main, "Core", "EnableSaveStates"}, false};
+// The chunked types are opt-in, as builds from before they were added can't load them.
+const Info<State::CompressionType> MAIN_SAVESTATE_COMPRESSION{
+    {System::Main, "Core", "SaveStateCompression"}, State::CompressionType::LZ4};
+// Only used by Zstandard.
+const Info<int> MAIN_SAVESTATE_COMPRESSION_LEVEL{
+    {System::Main, "Core", "SaveStateCompressionLevel"}, 1};
+const Info<bool> MAIN_SAVESTATE_THUMBNAILS{{System::Main, "Core", "SaveStateThumbnails"}, true};
+const Info<bool> MAIN_REWIND_ENABLED{{System::Main, "Core", "EnableRewind"}, false};
+const Info<u32> MAIN_REWIND_FRAMES{{System::Main, "Core", "RewindFrames"}, 30};
+const Info<u32> MAIN_REWIND_MEMORY_MB{{System::Main, "Core", "RewindMemoryMB"}, 512};
 const Info<bool> MAIN_REAL_WII_REMOTE_REPEAT_REPORTS{
     {System::Main, "Core", "RealWiiRemoteRepeatReports"}, true};
 const Info<bool> MAIN_WII_WIILINK_ENABLE{{System::Main, "Core", "EnableWiiLink"}, false};
@@ -32,6 +32,11 @@ namespace AudioCommon
 enum class DPL2Quality;
 }
 
+namespace State
+{
+enum CompressionType : u16;
+}
+
 namespace ExpansionInterface
 {
 enum class EXIDeviceType : int;
@@ -156,6 +161,13 @@ extern const Info<u32> MAIN_CUSTOM_RTC_VALUE;
 extern const Info<bool> MAIN_AUTO_DISC_CHANGE;
 extern const Info<bool> MAIN_ALLOW_SD_WRITES;
 extern const Info<bool> MAIN_ENABLE_SAVESTATES;
+extern const Info<State::CompressionType> MAIN_SAVESTATE_COMPRESSION;
+extern const Info<int> MAIN_SAVESTATE_COMPRESSION_LEVEL;
+extern const Info<bool> MAIN_SAVESTATE_THUMBNAILS;
+extern const Info<bool> MAIN_REWIND_ENABLED;
+// How many frames apart rewind snapshots are taken
+extern const Info<u32> MAIN_REWIND_FRAMES;
+extern const Info<u32> MAIN_REWIND_MEMORY_MB;
 extern const Info<DiscIO::Region> MAIN_FALLBACK_REGION;
 extern const Info<bool> MAIN_REAL_WII_REMOTE_REPEAT_REPORTS;
 extern const Info<s32> MAIN_OVERRIDE_BOOT_IOS;
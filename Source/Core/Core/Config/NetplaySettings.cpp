@@ -45,6 +45,9 @@ const Info<u32> NETPLAY_CHUNKED_UPLOAD_LIMIT{{System::Main, "NetPlay", "ChunkedU
 
 const Info<u32> NETPLAY_BUFFER_SIZE{{System::Main, "NetPlay", "BufferSize"}, 5};
 const Info<u32> NETPLAY_CLIENT_BUFFER_SIZE{{System::Main, "NetPlay", "BufferSizeClient"}, 1};
+const Info<bool> NETPLAY_AUTO_BUFFER_SIZE{{System::Main, "NetPlay", "AutoBufferSize"}, false};
+const Info<u32> NETPLAY_AUTO_BUFFER_SIZE_MIN{{System::Main, "NetPlay", "AutoBufferSizeMin"}, 1};
+const Info<u32> NETPLAY_AUTO_BUFFER_SIZE_MAX{{System::Main, "NetPlay", "AutoBufferSizeMax"}, 20};
 
 const Info<bool> NETPLAY_SAVEDATA_LOAD{{System::Main, "NetPlay", "SyncSaves"}, true};
 const Info<bool> NETPLAY_SAVEDATA_WRITE{{System::Main, "NetPlay", "WriteSaveData"}, true};
@@ -58,5 +61,13 @@ const Info<std::string> NETPLAY_NETWORK_MODE{{System::Main, "NetPlay", "NetworkM
                                              "fixeddelay"};
 const Info<bool> NETPLAY_GOLF_MODE_OVERLAY{{System::Main, "NetPlay", "GolfModeOverlay"}, true};
 const Info<bool> NETPLAY_HIDE_REMOTE_GBAS{{System::Main, "NetPlay", "HideRemoteGBAs"}, false};
+const Info<bool> NETPLAY_MEMORY_HASH{{System::Main, "NetPlay", "MemoryHash"}, false};
+const Info<u32> NETPLAY_MEMORY_HASH_FRAMES{{System::Main, "NetPlay", "MemoryHashFrames"}, 60};
+const Info<bool> NETPLAY_SPECTATOR_RELAY{{System::Main, "NetPlay", "SpectatorRelay"}, false};
+const Info<u32> NETPLAY_SPECTATOR_KEYFRAME_FRAMES{
+    {System::Main, "NetPlay", "SpectatorKeyframeFrames"}, 600};
+const Info<u32> NETPLAY_SIMULATED_RTT{{System::Main, "NetPlay", "SimulatedRTT"}, 0};
+const Info<u32> NETPLAY_SIMULATED_JITTER{{System::Main, "NetPlay", "SimulatedJitter"}, 0};
+const Info<float> NETPLAY_SIMULATED_LOSS{{System::Main, "NetPlay", "SimulatedLoss"}, 0.0f};
 
 }  // namespace Config
@@ -41,6 +41,9 @@ extern const Info<u32> NETPLAY_CHUNKED_UPLOAD_LIMIT;
 
 extern const Info<u32> NETPLAY_BUFFER_SIZE;
 extern const Info<u32> NETPLAY_CLIENT_BUFFER_SIZE;
+extern const Info<bool> NETPLAY_AUTO_BUFFER_SIZE;
+extern const Info<u32> NETPLAY_AUTO_BUFFER_SIZE_MIN;
+extern const Info<u32> NETPLAY_AUTO_BUFFER_SIZE_MAX;
 
 extern const Info<bool> NETPLAY_SAVEDATA_LOAD;
 extern const Info<bool> NETPLAY_SAVEDATA_WRITE;
@@ -51,5 +54,14 @@ extern const Info<bool> NETPLAY_STRICT_SETTINGS_SYNC;
 extern const Info<std::string> NETPLAY_NETWORK_MODE;
 extern const Info<bool> NETPLAY_GOLF_MODE_OVERLAY;
 extern const Info<bool> NETPLAY_HIDE_REMOTE_GBAS;
+extern const Info<bool> NETPLAY_MEMORY_HASH;
+extern const Info<u32> NETPLAY_MEMORY_HASH_FRAMES;
+extern const Info<bool> NETPLAY_SPECTATOR_RELAY;
+extern const Info<u32> NETPLAY_SPECTATOR_KEYFRAME_FRAMES;
+// Network conditions to simulate between this client and the host, for testing. The loss is in
+// percent.
+extern const Info<u32> NETPLAY_SIMULATED_RTT;
+extern const Info<u32> NETPLAY_SIMULATED_JITTER;
+extern const Info<float> NETPLAY_SIMULATED_LOSS;
 
 }  // namespace Config
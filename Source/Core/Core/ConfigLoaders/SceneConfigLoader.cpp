@@ -0,0 +1,95 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/ConfigLoaders/SceneConfigLoader.h"
+
+#include <memory>
+#include <optional>
+
+#include "Common/Config/Config.h"
+
+#include "Core/Config/GraphicsSettings.h"
+
+namespace ConfigLoaders
+{
+namespace
+{
+struct EffectiveValues
+{
+  int safe_texture_cache_color_samples;
+  int efb_scale;
+  bool skip_efb_copy_to_ram;
+
+  bool operator==(const EffectiveValues&) const = default;
+};
+
+EffectiveValues GetEffectiveValues()
+{
+  // Uncached, since the layer is edited in place before the config version is bumped.
+  return {Config::GetUncached(Config::GFX_SAFE_TEXTURE_CACHE_COLOR_SAMPLES),
+          Config::GetUncached(Config::GFX_EFB_SCALE),
+          Config::GetUncached(Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM)};
+}
+
+template <typename T>
+void SetOrDelete(Config::Layer* layer, const Config::Info<T>& info, const std::optional<T>& value)
+{
+  if (value)
+    layer->Set(info, *value);
+  else
+    layer->DeleteKey(info.GetLocation());
+}
+}  // namespace
+
+class SceneConfigLayerLoader final : public Config::ConfigLayerLoader
+{
+public:
+  explicit SceneConfigLayerLoader(const SceneConfigProfile& profile)
+      : ConfigLayerLoader(Config::LayerType::SceneProfile), m_profile(profile)
+  {
+  }
+
+  void Load(Config::Layer* layer) override
+  {
+    SetOrDelete(layer, Config::GFX_SAFE_TEXTURE_CACHE_COLOR_SAMPLES,
+                m_profile.safe_texture_cache_color_samples);
+    SetOrDelete(layer, Config::GFX_EFB_SCALE, m_profile.efb_scale);
+    SetOrDelete(layer, Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM, m_profile.skip_efb_copy_to_ram);
+  }
+
+  // Scene profiles only live for the current run and are never saved.
+  void Save(Config::Layer*) override {}
+
+private:
+  const SceneConfigProfile m_profile;
+};
+
+std::unique_ptr<Config::ConfigLayerLoader>
+GenerateSceneConfigLoader(const SceneConfigProfile& profile)
+{
+  return std::make_unique<SceneConfigLayerLoader>(profile);
+}
+
+bool ApplySceneConfigProfile(const SceneConfigProfile& profile)
+{
+  const EffectiveValues old_values = GetEffectiveValues();
+
+  const std::shared_ptr<Config::Layer> layer = Config::GetLayer(Config::LayerType::SceneProfile);
+  if (!layer)
+  {
+    // The first profile of a run installs the layer, which notifies listeners once by itself.
+    Config::AddLayer(GenerateSceneConfigLoader(profile));
+    return GetEffectiveValues() != old_values;
+  }
+
+  // Rewrite the existing layer without going through Config::Set, which would notify listeners
+  // (and make the video backend re-check its state) once per setting.
+  SceneConfigLayerLoader(profile).Load(layer.get());
+
+  if (GetEffectiveValues() == old_values)
+    return false;
+
+  Config::OnConfigChanged();
+  return true;
+}
+}  // namespace ConfigLoaders
@@ -0,0 +1,34 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <optional>
+
+namespace Config
+{
+class ConfigLayerLoader;
+}
+
+namespace ConfigLoaders
+{
+// Graphics settings a game can force while a particular scene is running.
+// Settings left empty fall through to the layers below.
+struct SceneConfigProfile
+{
+  std::optional<int> safe_texture_cache_color_samples;
+  std::optional<int> efb_scale;
+  std::optional<bool> skip_efb_copy_to_ram;
+
+  bool operator==(const SceneConfigProfile&) const = default;
+};
+
+std::unique_ptr<Config::ConfigLayerLoader>
+GenerateSceneConfigLoader(const SceneConfigProfile& profile);
+
+// Replaces the contents of the scene profile layer with the given profile as a single change.
+// Config changed callbacks run at most once, and only if an effective value actually changed.
+// Returns whether any effective value changed.
+bool ApplySceneConfigProfile(const SceneConfigProfile& profile);
+}  // namespace ConfigLoaders
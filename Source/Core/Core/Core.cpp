@@ -152,6 +152,8 @@ void FrameUpdateOnCPUThread()
 
 void OnFrameEnd(Core::System& system)
 {
+  ::State::OnFrameForRewind(system);
+
 #ifdef USE_MEMORYWATCHER
   if (s_memory_watcher)
   {
@@ -8,6 +8,7 @@
 #include <queue>
 
 #include "AudioCommon/AudioCommon.h"
+#include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
 #include "Common/Thread.h"
@@ -127,6 +128,13 @@ void CPUManager::Run()
     ExecutePendingJobs(state_lock);
     CPUThreadConfigCallback::CheckForConfigChanges();
 
+    if (m_state_yielding)
+    {
+      m_state_yielding = false;
+      m_state = State::Running;
+      m_time_played_finish_sync.Set();
+    }
+
     Common::Event gdb_step_sync_event;
     switch (m_state)
     {
@@ -297,6 +305,7 @@ bool CPUManager::SetStateLocked(State s)
 {
   if (m_state == State::PowerDown)
     return false;
+  m_state_yielding = false;
   if (s == State::Stepping)
     m_system.GetPowerPC().GetBreakPoints().ClearTemporary();
   m_state = s;
@@ -364,7 +373,7 @@ bool CPUManager::PauseAndLock(bool do_lock, bool unpause_on_unlock, bool control
     std::unique_lock state_lock(m_state_change_lock);
     m_state_paused_and_locked = true;
 
-    was_unpaused = m_state == State::Running;
+    was_unpaused = m_state == State::Running || m_state_yielding;
     SetStateLocked(State::Stepping);
 
     while (m_state_cpu_thread_active)
@@ -420,4 +429,20 @@ void CPUManager::AddCPUThreadJob(Common::MoveOnlyFunction<void()> function)
   m_pending_jobs.push(std::move(function));
 }
 
+void CPUManager::AddCPUThreadJobAndYield(Common::MoveOnlyFunction<void()> function)
+{
+  ASSERT(Core::IsCPUThread());
+
+  std::lock_guard state_lock(m_state_change_lock);
+  m_pending_jobs.push(std::move(function));
+
+  // If we aren't running, the job is picked up wherever the CPU Thread is waiting anyway.
+  if (m_state != State::Running)
+    return;
+
+  // Makes the run loop exit without pausing the adjacent systems, as we're back right away.
+  m_state = State::Stepping;
+  m_state_yielding = true;
+}
+
 }  // namespace CPU
@@ -101,6 +101,12 @@ public:
   // PauseAndLock(), as while the CPU is in the run loop, it won't execute the function.
   void AddCPUThreadJob(Common::MoveOnlyFunction<void()> function);
 
+  // Adds a job like AddCPUThreadJob, but for use by the CPU Thread itself while it's running, e.g.
+  // from a CoreTiming event that needs the emulated state to be at rest. The CPU Thread leaves the
+  // run loop once the current event is done, runs the job and carries on running. It reads as
+  // stepping until then.
+  void AddCPUThreadJobAndYield(Common::MoveOnlyFunction<void()> function);
+
 private:
   void FlushStepSyncEventLocked();
   void ExecutePendingJobs(std::unique_lock<std::mutex>& state_lock);
@@ -133,6 +139,9 @@ private:
   bool m_state_cpu_thread_active = false;
   bool m_state_paused_and_locked = false;
   bool m_state_system_request_stepping = false;
+  // Set by AddCPUThreadJobAndYield, so that the CPU Thread goes back to running after the job.
+  // Any other state change clears it.
+  bool m_state_yielding = false;
   bool m_state_cpu_step_instruction = false;
   Common::Event* m_state_cpu_step_instruction_sync = nullptr;
   std::queue<Common::MoveOnlyFunction<void()>> m_pending_jobs;
@@ -11,51 +11,180 @@
 #include <Core/State.h>
 #include "Core/System.h"
 #include "Common/Logging/Log.h"
+#include "Common/Thread.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+/* Discord throttles clients that update more than about five times per 20 seconds */
+#define MPN_DISCORD_INTERVAL std::chrono::seconds(4)
+
+/* What the presence is built from. The strings all point into the constant game tables, so a
+   snapshot can be handed to another thread as is, and compared by pointer. */
+typedef struct mpn_presence_t
+{
+  const char* Image;
+  const char* Title;
+  const char* SceneName;
+  const char* BoardIcon;
+  const char* BoardName;
+  bool HasAddresses;
+  int Players;
+  int CurrentTurn;
+  int TotalTurns;
+
+  bool operator==(const mpn_presence_t&) const = default;
+} mpn_presence_t;
 
 static int previousSceneId = -1;
 static bool hasSaved = false; 
 
-bool mpn_update_discord()
+static void mpn_send_presence(const mpn_presence_t& Presence)
 {
   DiscordRichPresence RichPresence = {};
+  char Details[128] = "";
 
-  RichPresence.largeImageKey = CurrentState.Image ? CurrentState.Image : "default";
-  RichPresence.largeImageText = CurrentState.Title ? CurrentState.Title : "In-Game";
+  RichPresence.largeImageKey = Presence.Image ? Presence.Image : "default";
+  RichPresence.largeImageText = Presence.Title ? Presence.Title : "In-Game";
 
-  if (CurrentState.Scenes != NULL && CurrentState.Scene != NULL)
-    RichPresence.state = CurrentState.Scene->Name.c_str();
+  if (Presence.SceneName != NULL)
+    RichPresence.state = Presence.SceneName;
 
-  int gameID = mpn_read_value(0x00000000, 4);
-  int sceneValue = -1;
-  bool shouldSave = false;
+  if (Presence.HasAddresses)
+  {
+    if (Presence.BoardName != NULL)
+    {
+      snprintf(Details, sizeof(Details), "Players: %d/4 Turn: %d/%d", Presence.Players,
+               Presence.CurrentTurn, Presence.TotalTurns);
 
-  if (gameID == MPN_GAMEID_MP4)
+      RichPresence.smallImageKey = Presence.BoardIcon;
+      RichPresence.smallImageText = Presence.BoardName;
+    }
+    else
+    {
+      snprintf(Details, sizeof(Details), "Players: %d/4", Presence.Players);
+      RichPresence.smallImageKey = "";
+      RichPresence.smallImageText = "";
+    }
+    RichPresence.details = Details;
+  }
+  else
   {
-    sceneValue = mpn_read_value(0x001D3CE3, 1);
-    shouldSave = (sceneValue == 0x4E);
+    // Handle the case where CurrentState.Addresses is NULL
+    RichPresence.details = "Invalid state: Addresses are NULL";
+    RichPresence.smallImageKey = "";
+    RichPresence.smallImageText = "";
   }
-  else if (gameID == MPN_GAMEID_MP5)
+
+  RichPresence.startTimestamp = std::time(nullptr);
+  Discord_UpdatePresence(&RichPresence);
+}
+
+/* Sends presence updates from its own thread, at most once per MPN_DISCORD_INTERVAL. Posting
+   while an update is pending replaces it, and repeats of the last sent presence are dropped. */
+class mpn_presence_worker_t
+{
+public:
+  ~mpn_presence_worker_t()
   {
-    sceneValue = mpn_read_value(0x00288863, 1);
-    shouldSave = (sceneValue == 0x69);
+    if (!m_thread.joinable())
+      return;
+
+    {
+      std::lock_guard Lock(m_lock);
+      m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
   }
-  else if (gameID == MPN_GAMEID_MP6)
+
+  void Post(const mpn_presence_t& Presence)
   {
-    sceneValue = mpn_read_value(0x002C0257, 1);
-    shouldSave = (sceneValue == 0x5C);
+    {
+      std::lock_guard Lock(m_lock);
+      m_pending = Presence;
+      if (!m_thread.joinable())
+        m_thread = std::thread(&mpn_presence_worker_t::Run, this);
+    }
+    m_wake.notify_one();
   }
-  else if (gameID == MPN_GAMEID_MP7)
+
+private:
+  void Run()
   {
-    sceneValue = mpn_read_value(0x002F2F3F, 1);
-    shouldSave = (sceneValue == 0x1);
+    Common::SetCurrentThreadName("MPN Discord Presence");
+
+    std::optional<mpn_presence_t> LastSent;
+    auto NextAllowed = std::chrono::steady_clock::now();
+
+    std::unique_lock Lock(m_lock);
+    while (true)
+    {
+      m_wake.wait(Lock, [this] { return m_stop || m_pending.has_value(); });
+      if (m_stop)
+        return;
+
+      /* Keep collecting newer posts until the rate limit allows another update */
+      if (m_wake.wait_until(Lock, NextAllowed, [this] { return m_stop; }))
+        return;
+
+      const mpn_presence_t Presence = *std::exchange(m_pending, std::nullopt);
+      if (LastSent && *LastSent == Presence)
+        continue;
+
+      Lock.unlock();
+      mpn_send_presence(Presence);
+      Lock.lock();
+
+      LastSent = Presence;
+      NextAllowed = std::chrono::steady_clock::now() + MPN_DISCORD_INTERVAL;
+    }
   }
 
+  std::thread m_thread;
+  std::mutex m_lock;
+  std::condition_variable m_wake;
+  std::optional<mpn_presence_t> m_pending;
+  bool m_stop = false;
+};
+
+static mpn_presence_worker_t s_presence_worker;
+
+bool mpn_update_discord()
+{
+  mpn_presence_t Presence = {};
+
+  Presence.Image = CurrentState.Image;
+  Presence.Title = CurrentState.Title;
+
+  if (CurrentState.Scenes != NULL && CurrentState.Scene != NULL)
+    Presence.SceneName = CurrentState.Scene->Name;
+
+  uint32_t gameID = 0;
+  uint8_t sceneValue = 0;
+  bool shouldSave = false;
+
+  mpn_read_u32(0x00000000, &gameID);
+  if (gameID == MPN_GAMEID_MP4)
+    shouldSave = mpn_read_u8(0x001D3CE3, &sceneValue) && sceneValue == 0x4E;
+  else if (gameID == MPN_GAMEID_MP5)
+    shouldSave = mpn_read_u8(0x00288863, &sceneValue) && sceneValue == 0x69;
+  else if (gameID == MPN_GAMEID_MP6)
+    shouldSave = mpn_read_u8(0x002C0257, &sceneValue) && sceneValue == 0x5C;
+  else if (gameID == MPN_GAMEID_MP7)
+    shouldSave = mpn_read_u8(0x002F2F3F, &sceneValue) && sceneValue == 0x1;
+
   
   if (shouldSave) {
     // Check if the Scene ID hasn't changed and we haven't already saved
     if (previousSceneId == CurrentState.CurrentSceneId && !hasSaved) {
         // Scene ID hasn't changed, and we haven't saved yet, so save the state
-        State::Save(Core::System::GetInstance(), 1);
+        State::Save(Core::System::GetInstance(), 1,
+                    State::SaveOptions{.saved_message = "MPN: auto saved state to {}"});
         hasSaved = true;  // Mark as saved to prevent further saves until conditions change
     }
     
@@ -68,50 +197,28 @@ bool mpn_update_discord()
 
   if (CurrentState.Addresses != NULL)
   {
+    uint8_t Ports[4] = {};
+    mpn_read_u8(CurrentState.Addresses->ControllerPortAddress1, &Ports[0]);
+    mpn_read_u8(CurrentState.Addresses->ControllerPortAddress2, &Ports[1]);
+    mpn_read_u8(CurrentState.Addresses->ControllerPortAddress3, &Ports[2]);
+    mpn_read_u8(CurrentState.Addresses->ControllerPortAddress4, &Ports[3]);
 
-    // Add controller port values
-    int value1 = mpn_read_value(CurrentState.Addresses->ControllerPortAddress1, 1);
-    int value2 = mpn_read_value(CurrentState.Addresses->ControllerPortAddress2, 1);
-    int value3 = mpn_read_value(CurrentState.Addresses->ControllerPortAddress3, 1);
-    int value4 = mpn_read_value(CurrentState.Addresses->ControllerPortAddress4, 1);
-
-    // Modify values based on the given conditions
-    value1 = (value1 == 0) ? 1 : 0;
-    value2 = (value2 == 0) ? 1 : 0;
-    value3 = (value3 == 0) ? 1 : 0;
-    value4 = (value4 == 0) ? 1 : 0;
-
-    int controller_port_sum = value1 + value2 + value3 + value4;
-
-    char Details[128] = "";
+    // A port value of 0 means a human is on that port
+    Presence.HasAddresses = true;
+    for (uint8_t Port : Ports)
+      Presence.Players += (Port == 0) ? 1 : 0;
 
     if (CurrentState.Boards && CurrentState.Board)
     {
-      snprintf(Details, sizeof(Details), "Players: %d/4 Turn: %d/%d", controller_port_sum,
-               mpn_read_value(CurrentState.Addresses->CurrentTurn, 1),
-               mpn_read_value(CurrentState.Addresses->TotalTurns, 1));
-
-      RichPresence.smallImageKey = CurrentState.Board->Icon.c_str();
-      RichPresence.smallImageText = CurrentState.Board->Name.c_str();
-    }
-    else
-    {
-      snprintf(Details, sizeof(Details), "Players: %d/4", controller_port_sum);
-      RichPresence.smallImageKey = "";
-      RichPresence.smallImageText = "";
+      Presence.CurrentTurn = mpn_read_value(CurrentState.Addresses->CurrentTurn, 1);
+      Presence.TotalTurns = mpn_read_value(CurrentState.Addresses->TotalTurns, 1);
+      Presence.BoardIcon = CurrentState.Board->Icon;
+      Presence.BoardName = CurrentState.Board->Name;
     }
-    RichPresence.details = Details;
-  }
-  else
-  {
-    // Handle the case where CurrentState.Addresses is NULL
-    RichPresence.details = "Invalid state: Addresses are NULL";
-    RichPresence.smallImageKey = "";
-    RichPresence.smallImageText = "";
   }
 
-  RichPresence.startTimestamp = std::time(nullptr);
-  Discord_UpdatePresence(&RichPresence);
+  /* Only the RAM reads and the auto-save above happen on the CPU thread */
+  s_presence_worker.Post(Presence);
 
   return true;
 }
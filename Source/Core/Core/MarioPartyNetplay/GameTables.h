@@ -0,0 +1,94 @@
+/*
+*  Dolphin for Mario Party Netplay
+*  Copyright (C) 2025 Tabitha Hanegan <tabithahanegan.com>
+*/
+
+#ifndef MPN_GAMETABLES_H
+#define MPN_GAMETABLES_H
+
+#include <iterator>
+#include "Gamestate.h"
+
+/* Builds a table mapping every ID below MPN_MAX_ID to the first entry it matches. Taking the
+   first match keeps the behaviour of the old sentinel-terminated scans for IDs that appear twice. */
+template <typename T, size_t N, typename Matches>
+consteval mpn_index_t mpn_make_index(const T (&Entries)[N], Matches Match)
+{
+  mpn_index_t Index{};
+  Index.fill(NONE);
+
+  for (size_t Id = 0; Id < MPN_MAX_ID; Id++)
+  {
+    for (size_t i = 0; i < N; i++)
+    {
+      if (Match(Entries[i], static_cast<int16_t>(Id)))
+      {
+        Index[Id] = static_cast<int16_t>(i);
+        break;
+      }
+    }
+  }
+
+  return Index;
+}
+
+/* Every ID in a data file has to land inside the index tables */
+template <typename T, size_t N>
+consteval bool mpn_ids_fit(const T (&Entries)[N])
+{
+  for (size_t i = 0; i < N; i++)
+  {
+    if (Entries[i].SceneId < NONE || Entries[i].SceneId >= MPN_MAX_ID)
+      return false;
+    if constexpr (requires { Entries[i].MiniGameId; })
+    {
+      if (Entries[i].MiniGameId < NONE || Entries[i].MiniGameId >= MPN_MAX_ID)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+template <typename T>
+constexpr const T* mpn_lookup(const mpn_index_t* Index, const T* Entries, int32_t Id)
+{
+  if (Index == NULL || Id < 0 || Id >= MPN_MAX_ID || (*Index)[Id] == NONE)
+    return NULL;
+
+  return &Entries[(*Index)[Id]];
+}
+
+/* One namespace per title. Adding a game means adding its data file to Games/ and three lines
+   here; the lookup tables are generated from the data file by GameTable.inc. */
+namespace MP4
+{
+#define MPN_GAME_DATA "Core/MarioPartyNetplay/Games/MP4.inc"
+#include "Core/MarioPartyNetplay/GameTable.inc"
+}  // namespace MP4
+
+namespace MP5
+{
+#define MPN_GAME_DATA "Core/MarioPartyNetplay/Games/MP5.inc"
+#include "Core/MarioPartyNetplay/GameTable.inc"
+}  // namespace MP5
+
+namespace MP6
+{
+#define MPN_GAME_DATA "Core/MarioPartyNetplay/Games/MP6.inc"
+#include "Core/MarioPartyNetplay/GameTable.inc"
+}  // namespace MP6
+
+namespace MP7
+{
+#define MPN_GAME_DATA "Core/MarioPartyNetplay/Games/MP7.inc"
+#include "Core/MarioPartyNetplay/GameTable.inc"
+}  // namespace MP7
+
+namespace MP8
+{
+#define MPN_GAME_DATA "Core/MarioPartyNetplay/Games/MP8.inc"
+#include "Core/MarioPartyNetplay/GameTable.inc"
+}  // namespace MP8
+
+#endif
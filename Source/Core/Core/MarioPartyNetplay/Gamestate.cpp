@@ -4,20 +4,38 @@
 */
 
 #include "Gamestate.h"
+#include "GameTables.h"
 #include "Core/System.h"
 #include "Core/ConfigManager.h"
+#include "Core/ConfigLoaders/SceneConfigLoader.h"
 #include "TurnCountLogger.h"
 
 #include <chrono>
-static auto lastTriggerTime = std::chrono::steady_clock::now();
-static bool waiting = false;
-static int storedSceneId = -1; // Variable to store the previous scene ID
+
+/* How long the watched bytes must stay unchanged before the tracker does its settle pass */
+#define MPN_SETTLE_TIME std::chrono::milliseconds(50)
+
+/* The handful of bytes everything else is derived from. Scene, board, turn and presence logic
+   only runs when one of them changes, instead of on every frame. */
+typedef struct mpn_watch_t
+{
+  uint16_t SceneId;
+  uint8_t CurrentTurn;
+  uint8_t TotalTurns;
+  uint8_t ControllerPorts[4];
+
+  bool operator==(const mpn_watch_t&) const = default;
+} mpn_watch_t;
+
+static std::string s_tracked_game_id;
+static bool s_is_supported_game = false;
+static mpn_watch_t s_last_watch;
+static bool s_watch_primed = false;
+static bool s_settle_pending = false;
+static auto s_last_change_time = std::chrono::steady_clock::now();
 static MarioPartyNetplay::TurnCountLogger s_turn_count_logger;
-static u32 s_last_current_turn = 0;
-static u32 s_last_total_turns = 0;
 mpn_state_t CurrentState;
 
-
 bool mpn_init_state()
 {
   auto& system = Core::System::GetInstance();
@@ -25,78 +43,54 @@ bool mpn_init_state()
   if (!memory.IsInitialized())
     return false;
 
+  const mpn_game_t* Game;
   switch (mpn_read_value(0x00000000, 4))
   {
   case MPN_GAMEID_MP4:
-    CurrentState.Addresses = &MP4_ADDRESSES;
-    CurrentState.Boards = MP4_BOARDS;
-    CurrentState.Image = "box-mp4";
-    CurrentState.IsMarioParty = true;
-    CurrentState.Scenes = MP4_GAMESTATES;
-    CurrentState.Title = "Mario Party 4";
+    Game = &MP4::GAME;
     break;
   case MPN_GAMEID_MP5:
-    CurrentState.Addresses = &MP5_ADDRESSES;
-    CurrentState.Boards = MP5_BOARDS;
-    CurrentState.Image = "box-mp5";
-    CurrentState.IsMarioParty = true;
-    CurrentState.Scenes = MP5_GAMESTATES;
-    CurrentState.Title = "Mario Party 5";
+    Game = &MP5::GAME;
     break;
   case MPN_GAMEID_MP6:
-    CurrentState.Addresses = &MP6_ADDRESSES;
-    CurrentState.Boards = MP6_BOARDS;
-    CurrentState.Image = "box-mp6";
-    CurrentState.IsMarioParty = true;
-    CurrentState.Scenes = MP6_GAMESTATES;
-    CurrentState.Title = "Mario Party 6";
+    Game = &MP6::GAME;
     break;
   case MPN_GAMEID_MP7:
-    CurrentState.Addresses    = &MP7_ADDRESSES;
-    CurrentState.Boards       = MP7_BOARDS;
-    CurrentState.Image = "box-mp7";
-    CurrentState.IsMarioParty = true;
-    CurrentState.Scenes = MP7_GAMESTATES;
-    CurrentState.Title = "Mario Party 7";
+    Game = &MP7::GAME;
     break;
   case MPN_GAMEID_MP8:
-    CurrentState.Addresses = &MP8_ADDRESSES;
-    CurrentState.Boards = MP8_BOARDS;
-    CurrentState.Image = "box-mp8";
-    CurrentState.IsMarioParty = true;
-    CurrentState.Scenes = MP8_GAMESTATES;
-    CurrentState.Title = "Mario Party 8";
+    Game = &MP8::GAME;
     break;
   case MPN_GAMEID_MP9: /* TODO */
   default:
-    CurrentState.Addresses = NULL;
-    CurrentState.Boards = NULL;
-    CurrentState.Image = "box-mp9";
-    CurrentState.IsMarioParty = false;
-    CurrentState.Scenes = NULL;
+    Game = NULL;
   }
 
+  CurrentState.Game = Game;
+  CurrentState.IsMarioParty = Game != NULL;
+  CurrentState.Title = Game ? Game->Title : NULL;
+  CurrentState.Image = Game ? Game->Image : "box-mp9";
+  CurrentState.Addresses = Game ? Game->Addresses : NULL;
+  CurrentState.Boards = Game ? Game->Boards : NULL;
+  CurrentState.Scenes = Game ? Game->Scenes : NULL;
+
   return CurrentState.Scenes != NULL;
 }
 
 bool mpn_update_board()
 {
-  uint8_t i;
-
   if (CurrentState.Boards == NULL)
     CurrentState.Board = NULL;
   else if (CurrentState.CurrentSceneId != CurrentState.PreviousSceneId)
   {
-    for (i = 0;; i++)
+    const mpn_board_t* Board = mpn_lookup(CurrentState.Game->BoardsBySceneId,
+                                          CurrentState.Boards, CurrentState.CurrentSceneId);
+
+    /* Scenes that are not a board (menus, mini-games) leave the last board in place */
+    if (Board != NULL)
     {
-      /* Unknown scene ID */
-      if (CurrentState.Boards[i].SceneId == NONE)
-        break;
-      if (CurrentState.Boards[i].SceneId == CurrentState.CurrentSceneId)
-      {
-        CurrentState.Board = &CurrentState.Boards[i];
-        return true;
-      }
+      CurrentState.Board = Board;
+      return true;
     }
   }
 
@@ -105,23 +99,16 @@ bool mpn_update_board()
 
 uint8_t mpn_get_needs(uint16_t StateId, bool IsSceneId)
 {
-  uint16_t i;
-
   if (CurrentState.Scenes == NULL)
     return MPN_NEEDS_NOTHING;
   else if (CurrentState.CurrentSceneId != CurrentState.PreviousSceneId)
   {
-    for (i = 0;; i++)
-    {
-      /* Unknown scene ID */
-      if (CurrentState.Scenes[i].SceneId == NONE)
-        return MPN_NEEDS_NOTHING;
-
-      /* Scene ID found in array */
-      if ((IsSceneId && StateId == CurrentState.Scenes[i].SceneId) ||
-          (StateId == CurrentState.Scenes[i].MiniGameId))
-        return CurrentState.Scenes[i].Needs;
-    }
+    const mpn_index_t* Index =
+        IsSceneId ? CurrentState.Game->ScenesByAnyId : CurrentState.Game->ScenesByMiniGameId;
+    const mpn_scene_t* Scene = mpn_lookup(Index, CurrentState.Scenes, StateId);
+
+    if (Scene != NULL)
+      return Scene->Needs;
   }
 
   return MPN_NEEDS_NOTHING;
@@ -134,115 +121,185 @@ void mpn_push_osd_message(const std::string& Message)
 #endif
 }
 
-bool mpn_update_state()
+bool mpn_update_state(int16_t SceneId)
 {
-  if (CurrentState.Scenes == NULL && !mpn_init_state())
-    return false;
-  auto& system = Core::System::GetInstance();
-  auto& memory = system.GetMemory();
-  if (!memory.IsInitialized())
+  CurrentState.PreviousSceneId = CurrentState.CurrentSceneId;
+  CurrentState.CurrentSceneId = SceneId;
+
+  const mpn_scene_t* Scene =
+      mpn_lookup(CurrentState.Game->ScenesBySceneId, CurrentState.Scenes, SceneId);
+  if (Scene == NULL)
     return false;
 
-  CurrentState.PreviousSceneId = CurrentState.CurrentSceneId;
-  CurrentState.CurrentSceneId = mpn_read_value(CurrentState.Addresses->SceneIdAddress, 2);
+  CurrentState.Scene = Scene;
+  return true;
+}
+
+static bool mpn_is_supported_game(const std::string& GameId)
+{
+  return GameId == "GMPE01" || GameId == "GP5E01" || GameId == "GP6E01" || GameId == "GP7E01" ||
+         GameId == "RM8E01" || GameId == "GMPEDX";
+}
 
-  for (uint16_t i = 0;; i++)
+/* Forget everything about the previous title; the tables are picked again once RAM is up */
+static void mpn_track_game(const std::string& GameId)
+{
+  s_tracked_game_id = GameId;
+  s_is_supported_game = mpn_is_supported_game(GameId);
+  s_watch_primed = false;
+  s_settle_pending = false;
+  CurrentState = {};
+}
+
+/* Fields that fall outside RAM read as zero */
+static mpn_watch_t mpn_read_watch()
+{
+  const mpn_addresses_t* Addresses = CurrentState.Addresses;
+  mpn_watch_t Watch = {};
+
+  mpn_read_u16(Addresses->SceneIdAddress, &Watch.SceneId);
+  mpn_read_u8(Addresses->CurrentTurn, &Watch.CurrentTurn);
+  mpn_read_u8(Addresses->TotalTurns, &Watch.TotalTurns);
+  mpn_read_u8(Addresses->ControllerPortAddress1, &Watch.ControllerPorts[0]);
+  mpn_read_u8(Addresses->ControllerPortAddress2, &Watch.ControllerPorts[1]);
+  mpn_read_u8(Addresses->ControllerPortAddress3, &Watch.ControllerPorts[2]);
+  mpn_read_u8(Addresses->ControllerPortAddress4, &Watch.ControllerPorts[3]);
+
+  return Watch;
+}
+
+#define OSD_PUSH(a) mpn_push_osd_message(std::string("Adjusting " #a " for ") + CurrentState.Scene->Name);
+static void mpn_apply_needs(uint8_t Needs)
+{
+  ConfigLoaders::SceneConfigProfile Profile;
+
+  if (Needs == MPN_NEEDS_NOTHING)
+    return;
+
+  if (Needs & MPN_NEEDS_SAFE_TEX_CACHE)
   {
-    if (CurrentState.Scenes[i].SceneId == NONE)
-      break;
-    if (CurrentState.CurrentSceneId == CurrentState.Scenes[i].SceneId)
-    {
-      CurrentState.Scene = &CurrentState.Scenes[i];
-      return true;
-    }
+    OSD_PUSH(GFX_SAFE_TEXTURE_CACHE_COLOR_SAMPLES)
+    Profile.safe_texture_cache_color_samples = 0;
   }
+  else
+    Profile.safe_texture_cache_color_samples = 128;
 
-  return false;
+  /* Without the flag the key is left out, so the user's own setting shows through */
+  if (Needs & MPN_NEEDS_NATIVE_RES)
+  {
+    OSD_PUSH(GFX_EFB_SCALE)
+    Profile.efb_scale = 1;
+  }
+
+  if (Needs & MPN_NEEDS_EFB_TO_TEXTURE)
+  {
+    OSD_PUSH(GFX_HACK_SKIP_EFB_COPY_TO_RAM)
+    Profile.skip_efb_copy_to_ram = false;
+  }
+  else
+    Profile.skip_efb_copy_to_ram = true;
+
+  /* One layer swap per scene change; the video thread picks it up after the current frame, and
+     only if one of the values really differs from what is already active */
+  ConfigLoaders::ApplySceneConfigProfile(Profile);
+}
+
+static void mpn_publish_status(const mpn_watch_t& Watch)
+{
+  MarioPartyNetplay::GameStatus Status;
+
+  Status.current_turn = Watch.CurrentTurn;
+  Status.total_turns = Watch.TotalTurns;
+  Status.scene_id = Watch.SceneId;
+  if (CurrentState.Scene != NULL && CurrentState.Scene->SceneId == Watch.SceneId)
+    Status.scene_name = CurrentState.Scene->Name;
+  if (CurrentState.Board != NULL)
+  {
+    Status.board_id = CurrentState.Board->BoardId;
+    Status.board_name = CurrentState.Board->Name;
+  }
+
+  s_turn_count_logger.PublishStatus(Status);
+}
+
+static void mpn_on_watch_changed(const mpn_watch_t& Watch, bool SceneChanged, bool TurnChanged)
+{
+  if (SceneChanged)
+  {
+    mpn_update_state(Watch.SceneId);
+    mpn_update_board();
+  }
+
+  mpn_update_discord();
+
+  if (TurnChanged)
+    s_turn_count_logger.LogTurnCount(Watch.CurrentTurn, Watch.TotalTurns);
+  mpn_publish_status(Watch);
+
+  if (SceneChanged)
+    mpn_apply_needs(mpn_get_needs(Watch.SceneId, true));
 }
 
-#define OSD_PUSH(a) mpn_push_osd_message("Adjusting #a for " + CurrentState.Scene->Name);
 void mpn_per_frame()
 {
-  
-  if (SConfig::GetInstance().GetGameID() == "GMPE01" || SConfig::GetInstance().GetGameID() == "GP5E01" || SConfig::GetInstance().GetGameID() == "GP6E01" || SConfig::GetInstance().GetGameID() == "GP7E01" || SConfig::GetInstance().GetGameID() == "RM8E01" || SConfig::GetInstance().GetGameID() == "GMPEDX")
+  const std::string GameId = SConfig::GetInstance().GetGameID();
+  if (GameId != s_tracked_game_id)
+    mpn_track_game(GameId);
+
+  if (!s_is_supported_game)
+    return;
+
+  if (CurrentState.Scenes == NULL)
   {
-    uint8_t Needs = 0;
+    if (!mpn_init_state())
+      return;
 
     // Initialize turn count logger if not already done
     s_turn_count_logger.Initialize();
+  }
 
-    if (!mpn_update_state() || CurrentState.PreviousSceneId == CurrentState.CurrentSceneId) {
-      if (!waiting) {
-          lastTriggerTime = std::chrono::steady_clock::now();
-          storedSceneId = CurrentState.PreviousSceneId;
-          waiting = true;
-      }
-
-      if (std::chrono::steady_clock::now() - lastTriggerTime < std::chrono::duration<double>(0.05)) {
-          return;
-      }
-      waiting = false;
-    }
-
-    mpn_update_board();
-    mpn_update_discord();
+  const mpn_watch_t Watch = mpn_read_watch();
 
-    // Log turn count changes
-    if (CurrentState.IsMarioParty && CurrentState.Addresses)
-    {
-      u32 current_turn = mpn_read_value(CurrentState.Addresses->CurrentTurn, 1);
-      u32 total_turns = mpn_read_value(CurrentState.Addresses->TotalTurns, 1);
-      
-      // Log if turn count has changed
-      if (current_turn != s_last_current_turn || total_turns != s_last_total_turns)
-      {
-        // Log turn count in simple format
-        s_turn_count_logger.LogTurnCount(current_turn, total_turns);
-        
-        s_last_current_turn = current_turn;
-        s_last_total_turns = total_turns;
-      }
-    }
+  if (!s_watch_primed || !(Watch == s_last_watch))
+  {
+    const bool SceneChanged = !s_watch_primed || Watch.SceneId != s_last_watch.SceneId;
+    const bool TurnChanged = !s_watch_primed || Watch.CurrentTurn != s_last_watch.CurrentTurn ||
+                             Watch.TotalTurns != s_last_watch.TotalTurns;
 
-    Needs = mpn_get_needs(mpn_read_value(CurrentState.Addresses->SceneIdAddress, 2), true);
+    s_last_watch = Watch;
+    s_watch_primed = true;
+    s_settle_pending = true;
+    s_last_change_time = std::chrono::steady_clock::now();
 
-    if (Needs != MPN_NEEDS_NOTHING)
-    {
-      if (Needs & MPN_NEEDS_SAFE_TEX_CACHE)
-      {
-        OSD_PUSH(GFX_SAFE_TEXTURE_CACHE_COLOR_SAMPLES)
-        Config::SetCurrent(Config::GFX_SAFE_TEXTURE_CACHE_COLOR_SAMPLES, 0);
-      }
-      else
-        Config::SetCurrent(Config::GFX_SAFE_TEXTURE_CACHE_COLOR_SAMPLES, 128);
-
-      if (Needs & MPN_NEEDS_NATIVE_RES)
-      {
-        OSD_PUSH(GFX_EFB_SCALE)
-        Config::SetCurrent(Config::GFX_EFB_SCALE, 1);
-      }
-      else
-        Config::SetCurrent(Config::GFX_EFB_SCALE, Config::GetBase(Config::GFX_EFB_SCALE));
-
-      if (Needs & MPN_NEEDS_EFB_TO_TEXTURE)
-      {
-        OSD_PUSH(GFX_HACK_SKIP_EFB_COPY_TO_RAM)
-        Config::SetCurrent(Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM, false);
-      }
-      else
-        Config::SetCurrent(Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM, true);
-      UpdateActiveConfig();
-    }
+    mpn_on_watch_changed(Watch, SceneChanged, TurnChanged);
+  }
+  else if (s_settle_pending && std::chrono::steady_clock::now() - s_last_change_time >= MPN_SETTLE_TIME)
+  {
+    /* One more presence update once things stopped moving, which is also where Discord.cpp
+       decides whether the results screen has settled enough to auto-save */
+    s_settle_pending = false;
+    mpn_update_discord();
   }
 }
 
 uint32_t mpn_read_value(uint32_t Address, uint8_t Size)
 {
-  uint32_t Value = 0;
-  auto& system = Core::System::GetInstance();
-  auto& memory = system.GetMemory();
-  for (int8_t i = 0; i < Size; i++)
-    Value += memory.GetRAM()[Address + i] * pow(256, Size - i - 1);
+  uint8_t Value8 = 0;
+  uint16_t Value16 = 0;
+  uint32_t Value32 = 0;
 
-  return Value;
+  switch (Size)
+  {
+  case 1:
+    mpn_read_u8(Address, &Value8);
+    return Value8;
+  case 2:
+    mpn_read_u16(Address, &Value16);
+    return Value16;
+  case 4:
+    mpn_read_u32(Address, &Value32);
+    return Value32;
+  default:
+    return 0;
+  }
 }
@@ -0,0 +1,53 @@
+/*
+*  Dolphin for Mario Party Netplay
+*  Copyright (C) 2025 Tabitha Hanegan <tabithahanegan.com>
+*/
+
+#include "MemoryView.h"
+
+#include "Common/Swap.h"
+#include "Core/HW/Memmap.h"
+#include "Core/System.h"
+
+/* Pointer to Size bytes of RAM starting at Address, or NULL if that range is not all RAM */
+static const uint8_t* mpn_ram_range(uint32_t Address, size_t Size)
+{
+  auto& memory = Core::System::GetInstance().GetMemory();
+  const uint8_t* Ram = memory.GetRAM();
+  const size_t RamSize = memory.GetRamSizeReal();
+
+  if (Ram == NULL || Size > RamSize || Address > RamSize - Size)
+    return NULL;
+
+  return Ram + Address;
+}
+
+bool mpn_read_u8(uint32_t Address, uint8_t* Value)
+{
+  const uint8_t* Data = mpn_ram_range(Address, sizeof(*Value));
+  if (Data == NULL)
+    return false;
+
+  *Value = *Data;
+  return true;
+}
+
+bool mpn_read_u16(uint32_t Address, uint16_t* Value)
+{
+  const uint8_t* Data = mpn_ram_range(Address, sizeof(*Value));
+  if (Data == NULL)
+    return false;
+
+  *Value = Common::swap16(Data);
+  return true;
+}
+
+bool mpn_read_u32(uint32_t Address, uint32_t* Value)
+{
+  const uint8_t* Data = mpn_ram_range(Address, sizeof(*Value));
+  if (Data == NULL)
+    return false;
+
+  *Value = Common::swap32(Data);
+  return true;
+}
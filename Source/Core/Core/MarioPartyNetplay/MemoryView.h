@@ -0,0 +1,17 @@
+/*
+*  Dolphin for Mario Party Netplay
+*  Copyright (C) 2025 Tabitha Hanegan <tabithahanegan.com>
+*/
+
+#ifndef MPN_MEMORYVIEW_H
+#define MPN_MEMORYVIEW_H
+
+#include <stdint.h>
+
+/* Typed big-endian reads from MEM1. Addresses are physical offsets, as in the game tables.
+   Each read fails without touching *Value if any byte of it lies outside RAM. */
+bool mpn_read_u8(uint32_t Address, uint8_t* Value);
+bool mpn_read_u16(uint32_t Address, uint16_t* Value);
+bool mpn_read_u32(uint32_t Address, uint32_t* Value);
+
+#endif
@@ -3,12 +3,22 @@
 
 #include "TurnCountLogger.h"
 
+#include <cstring>
 #include <fstream>
 #include <string>
 
+#include <picojson.h>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
 #include "Common/CommonPaths.h"
 #include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
+#include "Common/Thread.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/PowerPC/MMU.h"
@@ -17,13 +27,36 @@
 namespace MarioPartyNetplay
 {
 TurnCountLogger::TurnCountLogger() = default;
-TurnCountLogger::~TurnCountLogger() = default;
+
+TurnCountLogger::~TurnCountLogger()
+{
+  if (m_writer_thread.joinable())
+  {
+    {
+      std::lock_guard lock(m_writer_mutex);
+      m_writer_stop = true;
+    }
+    m_writer_wake.notify_one();
+
+    // The writer flushes anything still pending before it exits
+    m_writer_thread.join();
+  }
+
+#ifndef _WIN32
+  if (m_status_socket >= 0)
+    close(m_status_socket);
+#endif
+}
 
 void TurnCountLogger::Initialize()
 {
   if (!m_initialized)
   {
     DetermineLogFilePath();
+#ifndef _WIN32
+    m_status_socket = socket(AF_UNIX, SOCK_DGRAM, 0);
+#endif
+    m_writer_thread = std::thread(&TurnCountLogger::WriterThread, this);
     m_initialized = true;
     NOTICE_LOG_FMT(MPN, "TurnCountLogger initialized. Log file: {}", m_log_file_path);
   }
@@ -32,21 +65,26 @@ void TurnCountLogger::Initialize()
 void TurnCountLogger::DetermineLogFilePath()
 {
   std::string user_path = File::GetUserPath(D_USER_IDX);
-  
+
   // Check if running in portable mode by looking for portable.txt in executable directory
   std::string exe_path = File::GetExeDirectory();
   std::string portable_file = exe_path + DIR_SEP + "portable.txt";
-  
+
+  std::string directory;
   if (File::Exists(portable_file))
   {
     // Portable mode - create TurnCount.txt in executable directory
-    m_log_file_path = exe_path + DIR_SEP + "TurnCount.txt";
+    directory = exe_path + DIR_SEP;
   }
   else
   {
     // Non-portable mode - create TurnCount.txt in User directory
-    m_log_file_path = user_path + "TurnCount.txt";
+    directory = user_path;
   }
+
+  m_log_file_path = directory + "TurnCount.txt";
+  m_status_file_path = directory + "MPNStatus.json";
+  m_status_socket_path = directory + "MPNStatus.sock";
 }
 
 void TurnCountLogger::LogTurnCount(u32 current_turn, u32 total_turns)
@@ -54,15 +92,29 @@ void TurnCountLogger::LogTurnCount(u32 current_turn, u32 total_turns)
   if (!m_initialized)
     Initialize();
 
-  std::ofstream log_file(m_log_file_path, std::ios::trunc);
-  if (!log_file.is_open())
   {
-    ERROR_LOG_FMT(MPN, "Failed to open log file: {}", m_log_file_path);
-    return;
+    std::lock_guard lock(m_writer_mutex);
+    m_pending_turn_count.emplace(current_turn, total_turns);
   }
+  m_writer_wake.notify_one();
+}
 
-  log_file << "Turn: " << current_turn << " / " << total_turns;
-  log_file.close();
+void TurnCountLogger::PublishStatus(const GameStatus& status)
+{
+  if (!m_initialized)
+    Initialize();
+
+  if (m_has_published_status && status == m_last_status)
+    return;
+
+  m_last_status = status;
+  m_has_published_status = true;
+
+  {
+    std::lock_guard lock(m_writer_mutex);
+    m_pending_status = status;
+  }
+  m_writer_wake.notify_one();
 }
 
 std::string TurnCountLogger::GetLogFilePath() const
@@ -72,15 +124,76 @@ std::string TurnCountLogger::GetLogFilePath() const
 
 void TurnCountLogger::ClearLog()
 {
-  if (!m_initialized)
-    Initialize();
+  LogTurnCount(0, 0);
+}
+
+void TurnCountLogger::WriterThread()
+{
+  Common::SetCurrentThreadName("MPN Status Writer");
+
+  std::unique_lock lock(m_writer_mutex);
+  while (true)
+  {
+    m_writer_wake.wait(lock, [this] {
+      return m_writer_stop || m_pending_turn_count.has_value() || m_pending_status.has_value();
+    });
+
+    // Take only the newest value of each kind; anything older was overwritten while we were busy
+    const std::optional<std::pair<u32, u32>> turn_count = std::exchange(m_pending_turn_count, {});
+    const std::optional<GameStatus> status = std::exchange(m_pending_status, {});
 
+    if (!turn_count && !status && m_writer_stop)
+      return;
+
+    lock.unlock();
+    if (turn_count)
+      WriteTurnCount(turn_count->first, turn_count->second);
+    if (status)
+      WriteStatus(*status);
+    lock.lock();
+  }
+}
+
+void TurnCountLogger::WriteTurnCount(u32 current_turn, u32 total_turns) const
+{
   std::ofstream log_file(m_log_file_path, std::ios::trunc);
-  if (log_file.is_open())
+  if (!log_file.is_open())
   {
-    log_file << "Turn: 0 / 0";
-    log_file.close();
+    ERROR_LOG_FMT(MPN, "Failed to open log file: {}", m_log_file_path);
+    return;
   }
+
+  log_file << "Turn: " << current_turn << " / " << total_turns;
+  log_file.close();
+}
+
+void TurnCountLogger::WriteStatus(const GameStatus& status) const
+{
+  picojson::object root;
+  root.emplace("current_turn", static_cast<double>(status.current_turn));
+  root.emplace("total_turns", static_cast<double>(status.total_turns));
+  root.emplace("board_id", static_cast<double>(status.board_id));
+  root.emplace("board_name", status.board_name);
+  root.emplace("scene_id", static_cast<double>(status.scene_id));
+  root.emplace("scene_name", status.scene_name);
+  const std::string json = picojson::value(std::move(root)).serialize();
+
+  // Replace the file in one step so readers never see a half-written status
+  const std::string temp_path = m_status_file_path + ".tmp";
+  if (!File::WriteStringToFile(temp_path, json) || !File::Rename(temp_path, m_status_file_path))
+    ERROR_LOG_FMT(MPN, "Failed to write status file: {}", m_status_file_path);
+
+#ifndef _WIN32
+  if (m_status_socket < 0)
+    return;
+
+  // Nobody listening is the normal case, so send errors are ignored
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, m_status_socket_path.c_str(), sizeof(address.sun_path) - 1);
+  sendto(m_status_socket, json.c_str(), json.size(), MSG_DONTWAIT,
+         reinterpret_cast<sockaddr*>(&address), sizeof(address));
+#endif
 }
 
-} // namespace MarioPartyNetplay 
+} // namespace MarioPartyNetplay
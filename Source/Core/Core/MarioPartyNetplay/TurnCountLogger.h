@@ -3,19 +3,45 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
+#include <utility>
 
 #include "Common/CommonTypes.h"
 
 namespace MarioPartyNetplay
 {
+/**
+ * Everything an overlay needs to draw the current game state
+ */
+struct GameStatus
+{
+  u32 current_turn = 0;
+  u32 total_turns = 0;
+  int board_id = -1;
+  std::string board_name;
+  int scene_id = -1;
+  std::string scene_name;
+
+  bool operator==(const GameStatus&) const = default;
+};
+
 /**
  * TurnCountLogger - A utility class for logging turn count data to a TurnCount.txt file.
  * 
  * This class handles writing turn count data to a log file in a simple format:
  * "Turn: CurrentTurn / TotalTurns"
  * 
- * The log file is created either in the executable directory (if running in portable mode)
+ * Alongside it, the full GameStatus is written as JSON to MPNStatus.json and, on Unix, sent as
+ * a datagram to the MPNStatus.sock socket so overlays can listen instead of polling the file.
+ * 
+ * All file and socket I/O happens on a background thread. Updates that arrive while it is busy
+ * are coalesced, so only the newest turn count and status are ever written.
+ * 
+ * The files are created either in the executable directory (if running in portable mode)
  * or in the User directory (if not portable).
  */
 class TurnCountLogger
@@ -37,6 +63,14 @@ public:
    */
   void LogTurnCount(u32 current_turn, u32 total_turns);
 
+  /**
+   * Publish the current game status to the status file and socket. Identical consecutive
+   * statuses are dropped.
+   * 
+   * @param status The status to publish
+   */
+  void PublishStatus(const GameStatus& status);
+
   /**
    * Get the current log file path
    * 
@@ -55,8 +89,29 @@ private:
    */
   void DetermineLogFilePath();
 
+  /**
+   * Background thread body; writes whatever is pending until asked to stop
+   */
+  void WriterThread();
+
+  void WriteTurnCount(u32 current_turn, u32 total_turns) const;
+  void WriteStatus(const GameStatus& status) const;
+
   std::string m_log_file_path;
+  std::string m_status_file_path;
+  std::string m_status_socket_path;
+  int m_status_socket = -1;
   bool m_initialized = false;
+
+  GameStatus m_last_status;
+  bool m_has_published_status = false;
+
+  std::thread m_writer_thread;
+  std::mutex m_writer_mutex;
+  std::condition_variable m_writer_wake;
+  std::optional<std::pair<u32, u32>> m_pending_turn_count;
+  std::optional<GameStatus> m_pending_status;
+  bool m_writer_stop = false;
 };
 
 } // namespace MarioPartyNetplay 
\ No newline at end of file
@@ -11,6 +11,9 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <ranges>
+#include <set>
 #include <span>
 #include <thread>
 #include <tuple>
@@ -30,6 +33,7 @@
 #include "Common/MsgHandler.h"
 #include "Common/NandPaths.h"
 #include "Common/QoSSession.h"
+#include "Common/Random.h"
 #include "Common/SFMLHelper.h"
 #include "Common/StringUtil.h"
 #include "Common/Timer.h"
@@ -43,7 +47,9 @@
 #include "Core/Config/SessionSettings.h"
 #include "Core/Config/WiimoteSettings.h"
 #include "Core/ConfigManager.h"
+#include "Core/Core.h"
 #include "Core/GeckoCode.h"
+#include "Core/HW/CPU.h"
 #include "Core/HW/EXI/EXI.h"
 #include "Core/HW/EXI/EXI_DeviceIPL.h"
 #ifdef HAS_LIBMGBA
@@ -67,7 +73,11 @@
 #include "Core/IOS/Uids.h"
 #include "Core/Movie.h"
 #include "Core/NetPlayCommon.h"
+#include "Core/NetPlayGameDigest.h"
+#include "Core/NetPlayLinkSimulator.h"
+#include "Core/NetPlayMemoryHash.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/State.h"
 #include "Core/SyncIdentifier.h"
 #include "Core/System.h"
 #include "DiscIO/Blob.h"
@@ -87,6 +97,9 @@ static std::mutex crit_netplay_client;
 static NetPlayClient* netplay_client = nullptr;
 static bool s_si_poll_batching = false;
 
+// Blocks from earlier save syncs are kept up to this size, least recently received first out.
+constexpr u64 SAVE_BLOCK_CACHE_SIZE = 256 * 1024 * 1024;
+
 // called from ---GUI--- thread
 NetPlayClient::~NetPlayClient()
 {
@@ -94,6 +107,10 @@ NetPlayClient::~NetPlayClient()
   if (m_is_running.IsSet())
     StopGame();
 
+  // These send their results through this client, so they have to go before the connection does
+  m_memory_hasher.reset();
+  m_spectator_keyframe_thread.Shutdown();
+
   if (m_is_connected)
   {
     m_should_compute_game_digest = false;
@@ -135,6 +152,10 @@ NetPlayClient::NetPlayClient(const std::string& address, const u16 port, NetPlay
 {
   ClearBuffers();
 
+  m_save_block_cache = std::make_unique<SaveBlockCache>(File::GetUserPath(D_CACHE_IDX) +
+                                                        "NetPlaySaveBlocks" DIR_SEP);
+  m_save_block_cache->Trim(SAVE_BLOCK_CACHE_SIZE);
+
   if (!traversal_config.use_traversal)
   {
     // Direct Connection
@@ -152,6 +173,25 @@ NetPlayClient::NetPlayClient(const std::string& address, const u16 port, NetPlay
     enet_address_set_host(&addr, address.c_str());
     addr.port = port;
 
+    LinkConditions link_conditions;
+    link_conditions.rtt_ms = Config::Get(Config::NETPLAY_SIMULATED_RTT);
+    link_conditions.jitter_ms = Config::Get(Config::NETPLAY_SIMULATED_JITTER);
+    link_conditions.loss =
+        std::clamp(Config::Get(Config::NETPLAY_SIMULATED_LOSS), 0.0f, 100.0f) / 100.0;
+    if (!link_conditions.IsIdeal())
+    {
+      m_link_simulator = std::make_unique<LinkSimulator>(addr, link_conditions,
+                                                         Common::Random::GenerateValue<u32>());
+      if (!m_link_simulator->IsValid())
+      {
+        m_dialog->OnConnectionError(_trans("Could not create the simulated network link."));
+        return;
+      }
+
+      addr.host = 0x0100007f;  // localhost
+      addr.port = m_link_simulator->GetPort();
+    }
+
     m_server = enet_host_connect(m_client, &addr, CHANNEL_COUNT, 0);
 
     if (m_server == nullptr)
@@ -451,6 +491,14 @@ void NetPlayClient::OnData(sf::Packet& packet)
     OnDesyncDetected(packet);
     break;
 
+  case MessageID::MemoryDesyncDetected:
+    OnMemoryDesyncDetected(packet);
+    break;
+
+  case MessageID::SpectatorKeyframe:
+    OnSpectatorKeyframe(packet);
+    break;
+
   case MessageID::SyncSaveData:
     OnSyncSaveData(packet);
     break;
@@ -684,17 +732,16 @@ void NetPlayClient::OnPadData(sf::Packet& packet)
     PadIndex map;
     packet >> map;
 
-    GCPadStatus pad;
-    packet >> pad.button;
-    if (!m_gba_config.at(map).enabled)
+    PadInput input;
+    if (!m_input_from_server.pad_data.ReadPad(map, packet, &input.number, &input.pad))
     {
-      packet >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >> pad.substickX >>
-          pad.substickY >> pad.triggerLeft >> pad.triggerRight >> pad.isConnected;
+      ERROR_LOG_FMT(NETPLAY, "Received malformed pad data.");
+      return;
     }
 
     // Trusting server for good map value (>=0 && <4)
     // add to pad buffer
-    m_pad_buffer.at(map).Push(pad);
+    m_pad_buffer.at(map).Push(input);
     m_gc_pad_event.Set();
   }
 }
@@ -706,17 +753,18 @@ void NetPlayClient::OnPadHostData(sf::Packet& packet)
     PadIndex map;
     packet >> map;
 
+    u32 number;
     GCPadStatus pad;
-    packet >> pad.button;
-    if (!m_gba_config.at(map).enabled)
+    if (!m_input_from_server.pad_host_data.ReadPad(map, packet, &number, &pad))
     {
-      packet >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >> pad.substickX >>
-          pad.substickY >> pad.triggerLeft >> pad.triggerRight >> pad.isConnected;
+      ERROR_LOG_FMT(NETPLAY, "Received malformed host pad data.");
+      return;
     }
 
     // Trusting server for good map value (>=0 && <4)
     // write to last status
     m_last_pad_status[map] = pad;
+    m_last_pad_numbers[map] = number;
 
     if (!m_first_pad_status_received[map])
     {
@@ -734,16 +782,10 @@ void NetPlayClient::OnWiimoteData(sf::Packet& packet)
     packet >> map;
 
     WiimoteEmu::SerializedWiimoteState pad;
-    packet >> pad.length;
-    ASSERT(pad.length <= pad.data.size());
-    if (pad.length <= pad.data.size())
-    {
-      for (size_t i = 0; i < pad.length; ++i)
-        packet >> pad.data[i];
-    }
-    else
+    if (!m_input_from_server.wiimote_data.ReadWiimote(map, packet, &pad))
     {
-      pad.length = 0;
+      ERROR_LOG_FMT(NETPLAY, "Received malformed Wiimote data.");
+      return;
     }
 
     // Trusting server for good map value (>=0 && <4)
@@ -824,6 +866,8 @@ void NetPlayClient::OnChangeGame(sf::Packet& packet)
   client_capabilities_packet << ExpansionInterface::CEXIIPL::HasIPLDump();
   client_capabilities_packet << Config::Get(Config::SESSION_USE_FMA);
   Send(client_capabilities_packet);
+
+  SendCachedSaveBlocks();
 }
 
 void NetPlayClient::OnGameStatus(sf::Packet& packet)
@@ -847,6 +891,7 @@ void NetPlayClient::OnStartGame(sf::Packet& packet)
     INFO_LOG_FMT(NETPLAY, "Start of game {}", m_selected_game.game_id);
 
     packet >> m_current_game;
+    m_input_from_server.Reset();
     packet >> m_net_settings.cpu_thread;
     packet >> m_net_settings.cpu_core;
     packet >> m_net_settings.enable_cheats;
@@ -932,13 +977,33 @@ void NetPlayClient::OnStartGame(sf::Packet& packet)
     packet >> m_net_settings.sync_codes;
 
     packet >> m_net_settings.golf_mode;
+    packet >> m_net_settings.rollback;
+    packet >> m_net_settings.host_input_prediction;
     packet >> m_net_settings.use_fma;
     packet >> m_net_settings.hide_remote_gbas;
+    packet >> m_net_settings.memory_hash_frames;
+    packet >> m_net_settings.spectator_keyframe_frames;
 
     for (size_t i = 0; i < sizeof(m_net_settings.sram); ++i)
       packet >> m_net_settings.sram[i];
 
     m_net_settings.is_hosting = m_local_player->IsHost();
+
+    // Rollback only knows how to predict and replay GC pad input.
+    const bool wiimotes_mapped =
+        std::ranges::any_of(m_wiimote_map, [](auto mapping) { return mapping > 0; });
+    if (m_net_settings.rollback && wiimotes_mapped)
+    {
+      m_net_settings.rollback = false;
+      m_dialog->AppendChat(
+          Common::GetStringT("Rollback does not support Wii Remotes, using fixed delay instead."));
+    }
+    if (m_net_settings.host_input_prediction && wiimotes_mapped)
+    {
+      m_net_settings.host_input_prediction = false;
+      m_dialog->AppendChat(Common::GetStringT(
+          "Input prediction does not support Wii Remotes, using host input authority instead."));
+    }
   }
 
   m_dialog->OnMsgStartGame();
@@ -968,6 +1033,15 @@ void NetPlayClient::OnPing(sf::Packet& packet)
   response_packet << ping_key;
 
   Send(response_packet);
+
+  if (m_is_running.IsSet())
+  {
+    sf::Packet stats_packet;
+    stats_packet << MessageID::PadBufferStats;
+    stats_packet << m_pad_buffer_underruns.exchange(0);
+
+    Send(stats_packet);
+  }
 }
 
 void NetPlayClient::OnPlayerPingData(sf::Packet& packet)
@@ -1005,6 +1079,67 @@ void NetPlayClient::OnDesyncDetected(sf::Packet& packet)
   m_dialog->OnDesync(frame, player);
 }
 
+void NetPlayClient::OnMemoryDesyncDetected(sf::Packet& packet)
+{
+  int pid_to_blame;
+  u32 frame;
+  u32 page;
+  packet >> pid_to_blame;
+  packet >> frame;
+  packet >> page;
+
+  std::string player = "??";
+  {
+    std::lock_guard lkp(m_crit.players);
+    const auto it = m_players.find(pid_to_blame);
+    if (it != m_players.end())
+      player = it->second.name;
+  }
+
+  std::string region = fmt::format("page {}", page);
+  {
+    std::lock_guard lk(crit_netplay_client);
+    if (m_memory_hasher)
+      region = m_memory_hasher->DescribePage(page);
+  }
+
+  INFO_LOG_FMT(NETPLAY, "Player {} ({}) desynced at frame {} in {}!", player, pid_to_blame, frame,
+               region);
+
+  m_dialog->OnDesync(frame, player);
+  m_dialog->AppendChat(
+      Common::FmtFormatT("First difference found in {0} (frame {1})", region, frame));
+}
+
+void NetPlayClient::OnSpectatorKeyframe(sf::Packet& packet)
+{
+  // The server sends this right before the game start packet when we join a game in progress.
+  // Which inputs follow the keyframe is only of interest to the server.
+  u32 poll;
+  packet >> poll;
+  for (size_t i = 0; i < m_pad_buffer_popped.size(); ++i)
+    Common::PacketReadU64(packet);
+
+  const auto state = DecompressPacketIntoBuffer(packet);
+  if (!state)
+  {
+    ERROR_LOG_FMT(NETPLAY, "Failed to decompress the keyframe to join the game from");
+    return;
+  }
+
+  INFO_LOG_FMT(NETPLAY, "Joining game in progress from keyframe at poll {} ({} bytes)", poll,
+               state->size());
+
+  ClearBuffers();
+  m_pending_spectator_keyframe.reset(state->size());
+  std::ranges::copy(*state, m_pending_spectator_keyframe.begin());
+  m_joined_mid_game = true;
+
+  m_dialog->AppendChat(Common::GetStringT(
+      "You joined a game in progress and can only spectate it. Save data and cheat codes are not "
+      "synchronized with you, so the game can look different if it uses them."));
+}
+
 void NetPlayClient::OnSyncSaveData(sf::Packet& packet)
 {
   SyncSaveDataID sub_id;
@@ -1090,7 +1225,7 @@ void NetPlayClient::OnSyncSaveDataRaw(sf::Packet& packet)
     return;
   }
 
-  const bool success = DecompressPacketIntoFile(packet, path);
+  const bool success = DecompressPacketIntoFile(packet, path, m_save_block_cache.get());
   SyncSaveDataResponse(success);
 }
 
@@ -1122,7 +1257,7 @@ void NetPlayClient::OnSyncSaveDataGCI(sf::Packet& packet)
     INFO_LOG_FMT(NETPLAY, "Received GCI: {}", file_name);
 
     if (!Common::IsFileNameSafe(file_name) ||
-        !DecompressPacketIntoFile(packet, path + DIR_SEP + file_name))
+        !DecompressPacketIntoFile(packet, path + DIR_SEP + file_name, m_save_block_cache.get()))
     {
       WARN_LOG_FMT(NETPLAY, "Received invalid GCI.");
       SyncSaveDataResponse(false);
@@ -1167,7 +1302,7 @@ void NetPlayClient::OnSyncSaveDataWii(sf::Packet& packet)
   {
     INFO_LOG_FMT(NETPLAY, "Received Mii data.");
 
-    auto buffer = DecompressPacketIntoBuffer(packet);
+    auto buffer = DecompressPacketIntoBuffer(packet, m_save_block_cache.get());
 
     temp_fs->CreateFullPath(IOS::PID_KERNEL, IOS::PID_KERNEL, "/shared2/menu/FaceLib/", 0,
                             fs_modes);
@@ -1246,7 +1381,7 @@ void NetPlayClient::OnSyncSaveDataWii(sf::Packet& packet)
 
       if (file.type == WiiSave::Storage::SaveFile::Type::File)
       {
-        auto buffer = DecompressPacketIntoBuffer(packet);
+        auto buffer = DecompressPacketIntoBuffer(packet, m_save_block_cache.get());
         if (!buffer)
         {
           SyncSaveDataResponse(false);
@@ -1272,7 +1407,7 @@ void NetPlayClient::OnSyncSaveDataWii(sf::Packet& packet)
   if (has_redirected_save)
   {
     INFO_LOG_FMT(NETPLAY, "Received redirected save.");
-    if (!DecompressPacketIntoFolder(packet, redirect_path))
+    if (!DecompressPacketIntoFolder(packet, redirect_path, m_save_block_cache.get()))
     {
       PanicAlertFmtT("Failed to write redirected save.");
       SyncSaveDataResponse(false);
@@ -1301,7 +1436,7 @@ void NetPlayClient::OnSyncSaveDataGBA(sf::Packet& packet)
     return;
   }
 
-  const bool success = DecompressPacketIntoFile(packet, path);
+  const bool success = DecompressPacketIntoFile(packet, path, m_save_block_cache.get());
   SyncSaveDataResponse(success);
 }
 
@@ -1528,7 +1663,8 @@ void NetPlayClient::OnGameDigestAbort()
 
 void NetPlayClient::Send(const sf::Packet& packet, const u8 channel_id)
 {
-  Common::ENet::SendPacket(m_server, packet, channel_id);
+  if (Common::ENet::SendPacket(m_server, packet, channel_id))
+    m_session_stats.bytes_sent += packet.getDataSize();
 }
 
 void NetPlayClient::DisplayPlayersPing()
@@ -1540,6 +1676,48 @@ void NetPlayClient::DisplayPlayersPing()
                        OSD::Duration::SHORT, OSD::Color::CYAN);
 }
 
+void NetPlayClient::SessionStats::Reset()
+{
+  frames = 0;
+  input_delay_us = 0;
+  input_delay_samples = 0;
+  stalls = 0;
+  stall_us = 0;
+  bytes_sent = 0;
+}
+
+void NetPlayClient::ReportSessionStats()
+{
+  const u32 frames = m_session_stats.frames.exchange(0);
+  if (frames == 0)
+    return;
+
+  // This is only the time local inputs spend in the pad buffer, from being polled to the game
+  // reading them. It doesn't include what it takes the game to show the result.
+  const u64 delay_samples = m_session_stats.input_delay_samples.load();
+  const double input_delay_ms =
+      delay_samples != 0 ? m_session_stats.input_delay_us.load() / 1000.0 / delay_samples : 0;
+  std::string summary = fmt::format(
+      "{} frames, {:.1f} ms average input buffer delay, {} stalls ({} ms), {:.0f} bytes sent per "
+      "frame",
+      frames, input_delay_ms, m_session_stats.stalls.load(),
+      m_session_stats.stall_us.load() / 1000, double(m_session_stats.bytes_sent.load()) / frames);
+
+  if (m_link_simulator)
+  {
+    const LinkStats upstream = m_link_simulator->GetUpstreamStats();
+    const LinkStats downstream = m_link_simulator->GetDownstreamStats();
+    summary += fmt::format(", {} of {} datagrams dropped by the simulated link",
+                           upstream.datagrams_dropped + downstream.datagrams_dropped,
+                           upstream.datagrams_dropped + downstream.datagrams_dropped +
+                               upstream.datagrams_forwarded + downstream.datagrams_forwarded);
+  }
+
+  NOTICE_LOG_FMT(NETPLAY, "Session stats: {}", summary);
+  if (m_link_simulator)
+    m_dialog->AppendChat(fmt::format("Session stats: {}", summary));
+}
+
 u32 NetPlayClient::GetPlayersMaxPing() const
 {
   return std::ranges::max_element(m_players, {}, [](const auto& kv) { return kv.second.ping; })
@@ -1577,10 +1755,8 @@ void NetPlayClient::Disconnect()
 
 void NetPlayClient::SendAsync(sf::Packet&& packet, const u8 channel_id)
 {
-  {
-    std::lock_guard lkq(m_crit.async_queue_write);
-    m_async_queue.Push(AsyncQueueEntry{std::move(packet), channel_id});
-  }
+  const SendPriority priority = GetSendPriority(packet, channel_id);
+  m_async_queue.Push(priority, AsyncQueueEntry{std::move(packet), channel_id});
   Common::ENet::WakeupThread(m_client);
 }
 
@@ -1611,17 +1787,13 @@ void NetPlayClient::ThreadFunc()
     int net;
     if (m_traversal_client)
       m_traversal_client->HandleResends();
-    net = enet_host_service(m_client, &netEvent, 250);
-    while (!m_async_queue.Empty())
-    {
-      INFO_LOG_FMT(NETPLAY, "Processing async queue event.");
-      {
-        auto& e = m_async_queue.Front();
-        Send(e.packet, e.channel_id);
-      }
-      INFO_LOG_FMT(NETPLAY, "Processing async queue event done.");
-      m_async_queue.Pop();
-    }
+    // Check back soon if bulk data is waiting for the connection to drain
+    net = enet_host_service(m_client, &netEvent,
+                            m_async_queue.HasBulk() ? BULK_DATA_POLL_INTERVAL_MS : 250);
+    m_async_queue.Drain([this](const AsyncQueueEntry& e) { Send(e.packet, e.channel_id); },
+                        [this](const AsyncQueueEntry&) {
+                          return m_server->reliableDataInTransit < MAX_BULK_DATA_IN_TRANSIT;
+                        });
     if (net > 0)
     {
       sf::Packet rpac;
@@ -1700,15 +1872,22 @@ void NetPlayClient::SendChatMessage(const std::string& msg)
 }
 
 // called from ---CPU--- thread
-void NetPlayClient::AddPadStateToPacket(const int in_game_pad, const GCPadStatus& pad,
+void NetPlayClient::AddPadStateToPacket(const int in_game_pad, const u32 number,
+                                        const GCPadStatus& pad, InputDeltaState& stream,
                                         sf::Packet& packet)
 {
   packet << static_cast<PadIndex>(in_game_pad);
-  packet << pad.button;
-  if (!m_gba_config[in_game_pad].enabled)
+
+  // Only the buttons of a GBA are used
+  if (m_gba_config[in_game_pad].enabled)
   {
-    packet << pad.analogA << pad.analogB << pad.stickX << pad.stickY << pad.substickX
-           << pad.substickY << pad.triggerLeft << pad.triggerRight << pad.isConnected;
+    GCPadStatus gba_pad;
+    gba_pad.button = pad.button;
+    stream.WritePad(in_game_pad, number, gba_pad, packet);
+  }
+  else
+  {
+    stream.WritePad(in_game_pad, number, pad, packet);
   }
 }
 
@@ -1718,9 +1897,7 @@ void NetPlayClient::AddWiimoteStateToPacket(int in_game_pad,
                                             sf::Packet& packet)
 {
   packet << static_cast<PadIndex>(in_game_pad);
-  packet << state.length;
-  for (size_t i = 0; i < state.length; ++i)
-    packet << state.data[i];
+  m_input_to_server.wiimote_data.WriteWiimote(in_game_pad, state, packet);
 }
 
 // called from ---GUI--- thread
@@ -1756,14 +1933,66 @@ bool NetPlayClient::StartGame(const std::string& path)
 
   m_timebase_frame = 0;
   m_current_golfer = 1;
+
+  // Players who joined mid-game start from a different state, so there is nothing to compare
+  if (m_net_settings.memory_hash_frames != 0 && !m_joined_mid_game)
+  {
+    m_memory_hasher = std::make_unique<MemoryHasher>(
+        Core::System::GetInstance(), m_net_settings.memory_hash_frames,
+        [this](MemoryHasher::Slice slice) {
+          sf::Packet packet;
+          packet << MessageID::MemoryHashes;
+          packet << slice.frame;
+          packet << slice.first_page;
+          packet << static_cast<u32>(slice.hashes.size());
+          for (u64 hash : slice.hashes)
+            packet << hash;
+          SendAsync(std::move(packet));
+        });
+  }
+  else
+  {
+    m_memory_hasher.reset();
+  }
   m_wait_on_input = false;
 
   m_is_running.Set();
   NetPlay_Enable(this);
 
-  ClearBuffers();
+  // When joining mid-game, the inputs to replay after the keyframe are already in the pad buffers
+  if (!m_joined_mid_game)
+  {
+    ClearBuffers();
+    m_pending_spectator_keyframe.reset();
+  }
+  m_input_to_server.Reset();
+  m_session_stats.Reset();
+
+  m_pad_buffer_popped.fill(0);
+  m_spectator_keyframe_poll = 0;
+  m_spectator_catching_up = false;
+  if (m_local_player->IsHost() && m_net_settings.spectator_keyframe_frames != 0)
+  {
+    m_spectator_keyframe_thread.Reset("NetPlay Keyframes", [this](SpectatorKeyframe keyframe) {
+      sf::Packet packet;
+      packet << MessageID::SpectatorKeyframe;
+      packet << keyframe.poll;
+      for (u64 count : keyframe.pads)
+        packet << count;
+      if (!CompressBufferIntoPacket(std::span(keyframe.state.data(), keyframe.state_size),
+                                    packet))
+        return;
+      SendAsync(std::move(packet));
+    });
+  }
+
+  m_rollback.Reset();
+  m_rollback_current = nullptr;
+  m_rollback_save_pending = false;
+  m_rollback_resimulating = false;
 
   m_first_pad_status_received.fill(false);
+  m_local_pad_numbers.fill(0);
 
   if (m_dialog->IsRecording())
   {
@@ -1836,10 +2065,18 @@ void NetPlayClient::SyncSaveDataResponse(const bool success)
       response_packet << SyncSaveDataID::Success;
 
       Send(response_packet);
+
+      // Let the host know about the blocks we just received, so the next sync can skip them.
+      m_save_block_cache->Trim(SAVE_BLOCK_CACHE_SIZE);
+      SendCachedSaveBlocks();
     }
   }
   else
   {
+    // A cached block that turned out to be missing or corrupt has been dropped from the cache.
+    // Reporting that first means the next attempt sends it in full.
+    SendCachedSaveBlocks();
+
     sf::Packet response_packet;
     response_packet << MessageID::SyncSaveData;
     response_packet << SyncSaveDataID::Failure;
@@ -1848,6 +2085,24 @@ void NetPlayClient::SyncSaveDataResponse(const bool success)
   }
 }
 
+void NetPlayClient::SendCachedSaveBlocks()
+{
+  const std::set<SaveBlockHash>& hashes = m_save_block_cache->GetHashes();
+  const u32 count = static_cast<u32>(std::min<size_t>(hashes.size(), MAX_CACHED_SAVE_BLOCKS));
+
+  sf::Packet packet;
+  packet << MessageID::SyncSaveData;
+  packet << SyncSaveDataID::CachedBlocks;
+  packet << count;
+  for (const SaveBlockHash& hash : hashes | std::views::take(count))
+  {
+    for (u8 byte : hash)
+      packet << byte;
+  }
+
+  Send(packet);
+}
+
 void NetPlayClient::SyncCodeResponse(const bool success)
 {
   // If something failed, immediately report back that code sync failed
@@ -1938,6 +2193,8 @@ void NetPlayClient::ClearBuffers()
 
     while (m_wiimote_buffer[i].Size())
       m_wiimote_buffer[i].Pop();
+
+    m_local_pad_poll_times[i].clear();
   }
 }
 
@@ -2044,13 +2301,18 @@ bool NetPlayClient::GetNetPads(const int pad_nb, const bool batching, GCPadStatu
     m_wait_on_input_event.Wait();
   }
 
+  // While re-simulating after a rollback, the local inputs for those frames were already sent.
+  // The batched poll of the first pad is the one that starts the next frame.
+  const bool replaying = IsFirstInGamePad(pad_nb) && batching ? m_rollback.IsResimulating() :
+                                                                 m_rollback_resimulating;
+
   if (IsFirstInGamePad(pad_nb) && batching)
   {
     sf::Packet packet;
     packet << MessageID::PadData;
 
     bool send_packet = false;
-    const int num_local_pads = NumLocalPads();
+    const int num_local_pads = replaying ? 0 : NumLocalPads();
     for (int local_pad = 0; local_pad < num_local_pads; local_pad++)
     {
       send_packet = PollLocalPad(local_pad, packet) || send_packet;
@@ -2063,7 +2325,7 @@ bool NetPlayClient::GetNetPads(const int pad_nb, const bool batching, GCPadStatu
       SendPadHostPoll(-1);
   }
 
-  if (!batching)
+  if (!batching && !replaying)
   {
     const int local_pad = InGamePadToLocalPad(pad_nb);
     if (local_pad < 4)
@@ -2105,19 +2367,84 @@ bool NetPlayClient::GetNetPads(const int pad_nb, const bool batching, GCPadStatu
     }
   }
 
-  // Now, we either use the data pushed earlier, or wait for the
-  // other clients to send it to us
-  while (m_pad_buffer[pad_nb].Size() == 0)
+  if (IsRollbackActive())
   {
-    if (!m_is_running.IsSet())
+    // The batched poll of the first pad starts a new frame. Every other poll reads the inputs
+    // that were settled on for the current frame, predicted or not.
+    if ((IsFirstInGamePad(pad_nb) && batching) || !m_rollback_current)
     {
-      return false;
+      if (!RollbackBeginFrame())
+        return false;
     }
 
-    m_gc_pad_event.Wait();
+    // Nothing has begun yet if a rollback came up before the first frame. This poll is thrown away
+    // by the rollback anyway.
+    *pad_status = m_rollback_current ? m_rollback_current->inputs[pad_nb] : GCPadStatus{};
+  }
+  else
+  {
+    if (IsFirstInGamePad(pad_nb) && batching)
+    {
+      if (m_local_player->IsHost() && m_net_settings.spectator_keyframe_frames != 0)
+      {
+        // Taken after the poll, so the inputs popped for it are part of the keyframe
+        if (m_spectator_keyframe_poll++ % m_net_settings.spectator_keyframe_frames == 0)
+          RunAtFrameBoundary(&NetPlayClient::SaveSpectatorKeyframe);
+      }
+      else if (m_joined_mid_game)
+      {
+        UpdateMidGameJoin(pad_nb);
+      }
+    }
+
+    // Anything that runs before the keyframe is loaded is thrown away
+    if (!m_pending_spectator_keyframe.empty())
+    {
+      *pad_status = GCPadStatus{};
+      return true;
+    }
+
+    // Now, we either use the data pushed earlier, or wait for the
+    // other clients to send it to us
+    if (m_pad_buffer[pad_nb].Size() == 0)
+    {
+      ++m_pad_buffer_underruns;
+      ++m_session_stats.stalls;
+
+      const auto stall_start = std::chrono::steady_clock::now();
+      while (m_pad_buffer[pad_nb].Size() == 0)
+      {
+        if (!m_is_running.IsSet())
+        {
+          return false;
+        }
+
+        m_gc_pad_event.Wait();
+      }
+      m_session_stats.stall_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                                      std::chrono::steady_clock::now() - stall_start)
+                                      .count();
+    }
+
+    PadInput input;
+    m_pad_buffer[pad_nb].Pop(input);
+    *pad_status = input.pad;
+    ++m_pad_buffer_popped[pad_nb];
+
+    auto& poll_times = m_local_pad_poll_times[pad_nb];
+    if (!poll_times.empty())
+    {
+      m_session_stats.input_delay_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                                            std::chrono::steady_clock::now() - poll_times.front())
+                                            .count();
+      ++m_session_stats.input_delay_samples;
+      poll_times.pop_front();
+    }
   }
 
-  m_pad_buffer[pad_nb].Pop(*pad_status);
+  // Rollback states leave out the movie, so it only sees the first time a frame is simulated.
+  if (m_rollback_resimulating)
+    return true;
 
   auto& movie = Core::System::GetInstance().GetMovie();
   if (movie.IsRecordingInput())
@@ -2133,6 +2460,174 @@ bool NetPlayClient::GetNetPads(const int pad_nb, const bool batching, GCPadStatu
   return true;
 }
 
+// called from ---CPU--- thread, outside of CoreTiming::Advance
+void NetPlayClient::SaveSpectatorKeyframe()
+{
+  SpectatorKeyframe keyframe;
+  keyframe.poll = m_spectator_keyframe_poll - 1;
+  keyframe.pads = m_pad_buffer_popped;
+  keyframe.state_size = State::SaveToBuffer(Core::System::GetInstance(), keyframe.state);
+  if (keyframe.state_size != 0)
+    m_spectator_keyframe_thread.Push(std::move(keyframe));
+}
+
+// called from ---CPU--- thread, outside of CoreTiming::Advance
+void NetPlayClient::LoadSpectatorKeyframe()
+{
+  if (!State::LoadFromKeyframeBuffer(Core::System::GetInstance(), m_pending_spectator_keyframe))
+  {
+    ERROR_LOG_FMT(NETPLAY, "Failed to load the keyframe to join the game from");
+    m_dialog->AppendChat(Common::GetStringT("Failed to load the game in progress."));
+  }
+  m_pending_spectator_keyframe.reset();
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::UpdateMidGameJoin(const int pad_nb)
+{
+  // The keyframe was taken after the host's poll, so it picks up where this one leaves off.
+  if (!m_pending_spectator_keyframe.empty())
+  {
+    RunAtFrameBoundary(&NetPlayClient::LoadSpectatorKeyframe);
+    return;
+  }
+
+  // Run unthrottled until we have caught up with the inputs that were sent since the keyframe
+  const size_t buffered = m_pad_buffer[pad_nb].Size();
+  if (!m_spectator_catching_up && buffered > m_target_buffer_size + 1)
+  {
+    m_spectator_catching_up = true;
+    Core::SetIsThrottlerTempDisabled(true);
+  }
+  else if (m_spectator_catching_up && buffered <= m_target_buffer_size)
+  {
+    m_spectator_catching_up = false;
+    Core::SetIsThrottlerTempDisabled(false);
+  }
+}
+
+bool NetPlayClient::IsRollbackActive() const
+{
+  if (m_host_input_authority)
+  {
+    // The host's inputs are the authoritative ones, so it never has anything to predict.
+    return m_net_settings.host_input_prediction && !m_net_settings.golf_mode &&
+           m_local_player->pid != m_current_golfer;
+  }
+
+  return m_net_settings.rollback;
+}
+
+bool NetPlayClient::IsSpeculativeLocalPad(const size_t pad) const
+{
+  // With host input authority, our own inputs only become final once the host has sent them back
+  // to us. Until then, we predict them from what we pressed as many frames before as the host was
+  // last seen to be behind us, rather than keeping what we were last confirmed to be pressing.
+  return m_host_input_authority && m_pad_map[pad] == m_local_player->pid;
+}
+
+// called from ---CPU--- thread
+bool NetPlayClient::RollbackBeginFrame()
+{
+  for (size_t pad = 0; pad < m_pad_map.size(); ++pad)
+  {
+    if (m_pad_map[pad] <= 0)
+      m_rollback.SetPad(pad, RollbackPad::Unused);
+    else if (IsSpeculativeLocalPad(pad))
+      m_rollback.SetPad(pad, RollbackPad::SpeculativeLocal);
+    else
+      m_rollback.SetPad(pad, RollbackPad::Remote);
+  }
+
+  const auto take_inputs = [this] {
+    for (size_t pad = 0; pad < m_pad_buffer.size(); ++pad)
+    {
+      PadInput input;
+      while (m_pad_buffer[pad].Pop(input))
+        m_rollback.AddInput(pad, input.pad, input.number);
+    }
+  };
+  take_inputs();
+
+  // A frame can't begin while a rollback is pending, as it has to be simulated again anyway.
+  const bool resimulating = m_rollback.IsResimulating();
+  RollbackFrame* entry = nullptr;
+  while (!m_rollback.IsRollbackPending() && !(entry = m_rollback.BeginFrame()))
+  {
+    if (!m_is_running.IsSet())
+      return false;
+
+    m_gc_pad_event.Wait();
+    take_inputs();
+  }
+
+  if (entry)
+  {
+    if (m_rollback_resimulating && !resimulating)
+      Core::SetIsThrottlerTempDisabled(false);
+
+    m_rollback_current = entry;
+    m_rollback_resimulating = resimulating;
+    m_rollback_save_pending = true;
+  }
+
+  // We're in the middle of CoreTiming::Advance, where the state can't be saved or loaded.
+  RunAtFrameBoundary(&NetPlayClient::RollbackAtFrameBoundary);
+
+  return true;
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::RunAtFrameBoundary(void (NetPlayClient::*job)())
+{
+  // The client might be gone by the time the job runs.
+  Core::System::GetInstance().GetCPU().AddCPUThreadJobAndYield([job] {
+    std::lock_guard lk(crit_netplay_client);
+    if (netplay_client)
+      (netplay_client->*job)();
+  });
+}
+
+// called from ---CPU--- thread, outside of CoreTiming::Advance
+void NetPlayClient::RollbackAtFrameBoundary()
+{
+  auto& system = Core::System::GetInstance();
+
+  if (m_rollback.IsRollbackPending())
+  {
+    const u64 frame = m_rollback.GetFrame();
+    RollbackFrame* entry = m_rollback.TakeRollback();
+    if (!entry)
+    {
+      ERROR_LOG_FMT(NETPLAY, "Rollback from frame {} failed, no state is stored for it", frame);
+    }
+    else if (!State::LoadFromRollbackBuffer(system, entry->state))
+    {
+      ERROR_LOG_FMT(NETPLAY, "Rollback to frame {} failed, the state could not be loaded",
+                    entry->frame + 1);
+    }
+    else
+    {
+      DEBUG_LOG_FMT(NETPLAY, "Rolled back from frame {} to frame {}", frame, entry->frame + 1);
+
+      // Polls until the next frame begins read what was polled before the state was saved.
+      m_rollback_current = entry;
+      m_rollback_save_pending = false;
+      m_rollback_resimulating = true;
+
+      // Catch back up as fast as the host allows.
+      Core::SetIsThrottlerTempDisabled(true);
+      return;
+    }
+  }
+
+  if (m_rollback_save_pending)
+  {
+    m_rollback_current->state_size = State::SaveToRollbackBuffer(system, m_rollback_current->state);
+    m_rollback_save_pending = false;
+  }
+}
+
 u64 NetPlayClient::GetInitialRTCValue() const
 {
   return m_initial_rtc;
@@ -2141,6 +2636,10 @@ u64 NetPlayClient::GetInitialRTCValue() const
 // called from ---CPU--- thread
 bool NetPlayClient::WiimoteUpdate(const std::span<WiimoteDataBatchEntry>& entries)
 {
+  // Send all local Wiimotes of the batch in one packet before waiting for any remote ones
+  sf::Packet packet;
+  packet << MessageID::WiimoteData;
+  bool send_packet = false;
   for (const WiimoteDataBatchEntry& entry : entries)
   {
     const int local_wiimote = InGameWiimoteToLocalWiimote(entry.wiimote);
@@ -2149,13 +2648,13 @@ bool NetPlayClient::WiimoteUpdate(const std::span<WiimoteDataBatchEntry>& entrie
                   entry.wiimote, local_wiimote,
                   fmt::join(std::span(entry.state->data.data(), entry.state->length), ", "));
     if (local_wiimote < 4)
-    {
-      sf::Packet packet;
-      packet << MessageID::WiimoteData;
-      if (AddLocalWiimoteToBuffer(local_wiimote, *entry.state, packet))
-        SendAsync(std::move(packet));
-    }
+      send_packet = AddLocalWiimoteToBuffer(local_wiimote, *entry.state, packet) || send_packet;
+  }
+  if (send_packet)
+    SendAsync(std::move(packet));
 
+  for (const WiimoteDataBatchEntry& entry : entries)
+  {
     // Now, we either use the data pushed earlier, or wait for the
     // other clients to send it to us
     while (m_wiimote_buffer[entry.wiimote].Size() == 0)
@@ -2199,16 +2698,21 @@ bool NetPlayClient::PollLocalPad(const int local_pad, sf::Packet& packet)
 
   if (m_host_input_authority)
   {
+    const u32 number = m_local_pad_numbers[ingame_pad]++;
     if (m_local_player->pid != m_current_golfer)
     {
       // add to packet
-      AddPadStateToPacket(ingame_pad, pad_status, packet);
+      AddPadStateToPacket(ingame_pad, number, pad_status, m_input_to_server.pad_data, packet);
       data_added = true;
+
+      // kept to predict what the host will apply, which it tells us by the number
+      m_rollback.AddLocalInput(ingame_pad, number, pad_status);
     }
     else
     {
       // set locally
       m_last_pad_status[ingame_pad] = pad_status;
+      m_last_pad_numbers[ingame_pad] = number;
       m_first_pad_status_received[ingame_pad] = true;
     }
   }
@@ -2216,13 +2720,17 @@ bool NetPlayClient::PollLocalPad(const int local_pad, sf::Packet& packet)
   {
     // adjust the buffer either up or down
     // inserting multiple padstates or dropping states
+    const auto poll_time = std::chrono::steady_clock::now();
     while (m_pad_buffer[ingame_pad].Size() <= m_target_buffer_size)
     {
+      const u32 number = m_local_pad_numbers[ingame_pad]++;
+
       // add to buffer
-      m_pad_buffer[ingame_pad].Push(pad_status);
+      m_pad_buffer[ingame_pad].Push({pad_status, number});
+      m_local_pad_poll_times[ingame_pad].push_back(poll_time);
 
       // add to packet
-      AddPadStateToPacket(ingame_pad, pad_status, packet);
+      AddPadStateToPacket(ingame_pad, number, pad_status, m_input_to_server.pad_data, packet);
       data_added = true;
     }
   }
@@ -2294,8 +2802,9 @@ void NetPlayClient::SendPadHostPoll(const PadIndex pad_num)
         continue;
 
       const GCPadStatus& pad_status = m_last_pad_status[i];
-      m_pad_buffer[i].Push(pad_status);
-      AddPadStateToPacket(static_cast<int>(i), pad_status, packet);
+      m_pad_buffer[i].Push({pad_status, m_last_pad_numbers[i]});
+      AddPadStateToPacket(static_cast<int>(i), m_last_pad_numbers[i], pad_status,
+                          m_input_to_server.pad_host_data, packet);
     }
   }
   else if (m_pad_map[pad_num] != 0)
@@ -2311,8 +2820,9 @@ void NetPlayClient::SendPadHostPoll(const PadIndex pad_num)
     if (m_pad_buffer[pad_num].Size() == 0)
     {
       const GCPadStatus& pad_status = m_last_pad_status[pad_num];
-      m_pad_buffer[pad_num].Push(pad_status);
-      AddPadStateToPacket(pad_num, pad_status, packet);
+      m_pad_buffer[pad_num].Push({pad_status, m_last_pad_numbers[pad_num]});
+      AddPadStateToPacket(pad_num, m_last_pad_numbers[pad_num], pad_status,
+                          m_input_to_server.pad_host_data, packet);
     }
   }
 
@@ -2335,6 +2845,13 @@ bool NetPlayClient::StopGame()
 {
   InvokeStop();
 
+  ReportSessionStats();
+
+  if (m_spectator_catching_up)
+    Core::SetIsThrottlerTempDisabled(false);
+  m_spectator_catching_up = false;
+  m_joined_mid_game = false;
+
   NetPlay_Disable();
 
   // stop game
@@ -2518,7 +3035,12 @@ void NetPlayClient::SendTimeBase()
 {
   std::lock_guard lk(crit_netplay_client);
 
-  if (netplay_client->m_timebase_frame % 60 == 0)
+  // Frames replayed after a rollback were already counted (and reported) the first time around.
+  if (netplay_client->m_rollback_resimulating)
+    return;
+
+  // The server doesn't compare the timebase of players who joined mid-game
+  if (netplay_client->m_timebase_frame % 60 == 0 && !netplay_client->m_joined_mid_game)
   {
     const u64 timebase = Core::System::GetInstance().GetSystemTimers().GetFakeTimeBase();
 
@@ -2530,6 +3052,11 @@ void NetPlayClient::SendTimeBase()
     netplay_client->SendAsync(std::move(packet));
   }
 
+  if (netplay_client->m_memory_hasher)
+    netplay_client->m_memory_hasher->OnFrame(netplay_client->m_timebase_frame);
+
+  ++netplay_client->m_session_stats.frames;
+
   netplay_client->m_timebase_frame++;
 }
 
@@ -2542,35 +3069,6 @@ bool NetPlayClient::DoAllPlayersHaveGame()
   });
 }
 
-static std::string SHA1Sum(const std::string& file_path, std::function<bool(int)> report_progress)
-{
-  std::vector<u8> data(8 * 1024 * 1024);
-  u64 read_offset = 0;
-
-  std::unique_ptr<DiscIO::BlobReader> file(DiscIO::CreateBlobReader(file_path));
-  u64 game_size = file->GetDataSize();
-
-  auto ctx = Common::SHA1::CreateContext();
-
-  while (read_offset < game_size)
-  {
-    size_t read_size = std::min(static_cast<u64>(data.size()), game_size - read_offset);
-    if (!file->Read(read_offset, read_size, data.data()))
-      return "";
-
-    ctx->Update(data.data(), read_size);
-    read_offset += read_size;
-
-    int progress =
-        static_cast<int>(static_cast<float>(read_offset) / static_cast<float>(game_size) * 100);
-    if (!report_progress(progress))
-      return "";
-  }
-
-  // Convert to hex
-  return fmt::format("{:02x}", fmt::join(ctx->Finish(), ""));
-}
-
 void NetPlayClient::ComputeGameDigest(const SyncIdentifier& sync_identifier)
 {
   if (m_should_compute_game_digest)
@@ -2597,7 +3095,7 @@ void NetPlayClient::ComputeGameDigest(const SyncIdentifier& sync_identifier)
   if (m_game_digest_thread.joinable())
     m_game_digest_thread.join();
   m_game_digest_thread = std::thread([this, file] {
-    std::string sum = SHA1Sum(file, [&](int progress) {
+    std::string sum = GetGameDigest(file, [&](int progress) {
       sf::Packet packet;
       packet << MessageID::GameDigestProgress;
       packet << progress;
@@ -5,7 +5,9 @@
 
 #include <SFML/Network/Packet.hpp>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -16,11 +18,16 @@
 #include <utility>
 #include <vector>
 
+#include "Common/Buffer.h"
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
 #include "Common/SPSCQueue.h"
 #include "Common/TraversalClient.h"
+#include "Common/WorkQueueThread.h"
+#include "Core/NetPlayInputDelta.h"
 #include "Core/NetPlayProto.h"
+#include "Core/NetPlayRollback.h"
+#include "Core/NetPlaySendQueue.h"
 #include "Core/SyncIdentifier.h"
 #include "InputCommon/GCPadStatus.h"
 
@@ -43,35 +50,9 @@ struct SerializedWiimoteState;
 
 namespace NetPlay
 {
-constexpr int rollback_frames_supported = 10;
-using SaveState = std::vector<u8>;
-// 0 is the closest SaveState in time from the current frame
-class SaveStateArray
-{
-public:
-  std::shared_ptr<SaveState>& New()
-  {
-    std::array<std::shared_ptr<SaveState>, rollback_frames_supported> new_array{};
-
-    for (int i = rollback_frames_supported - 2; i >= 0; i--)
-    {
-      new_array.at(i + 1) = main_array.at(i);
-    }
-    new_array.at(0) = std::shared_ptr<SaveState>{};
-    main_array = std::move(new_array);
-
-    return main_array.at(0);
-  };
-
-  void reset()
-  {
-    for (auto& save_state : main_array)
-      save_state = std::shared_ptr<SaveState>{};
-  }
-
-private:
-  std::array<std::shared_ptr<SaveState>, rollback_frames_supported> main_array;
-};
+class LinkSimulator;
+class MemoryHasher;
+class SaveBlockCache;
 
 class NetPlayUI
 {
@@ -227,24 +208,57 @@ protected:
     std::recursive_mutex game;
     // lock order
     std::recursive_mutex players;
-    std::recursive_mutex async_queue_write;
   } m_crit;
 
-  Common::SPSCQueue<AsyncQueueEntry> m_async_queue;
+  SendQueue<AsyncQueueEntry> m_async_queue;
 
-  std::array<Common::SPSCQueue<GCPadStatus>, 4> m_pad_buffer;
+  // A pad input and the number that the client which polled it gave it
+  struct PadInput
+  {
+    GCPadStatus pad;
+    u32 number = 0;
+  };
+
+  std::array<Common::SPSCQueue<PadInput>, 4> m_pad_buffer;
   std::array<Common::SPSCQueue<WiimoteEmu::SerializedWiimoteState>, 4> m_wiimote_buffer;
 
+  // Delta encoding state of the pads and Wiimotes sent to and received from the server
+  InputDeltaStreams m_input_to_server;
+  InputDeltaStreams m_input_from_server;
+
   std::array<GCPadStatus, 4> m_last_pad_status{};
+  std::array<u32, 4> m_last_pad_numbers{};
   std::array<bool, 4> m_first_pad_status_received{};
+  // The number the next input polled for each of our pads is sent with
+  std::array<u32, 4> m_local_pad_numbers{};
 
   std::chrono::time_point<std::chrono::steady_clock> m_buffer_under_target_last;
+  // Counted on the CPU thread and reported to the host for its automatic buffer size
+  std::atomic<u32> m_pad_buffer_underruns = 0;
+
+  // Measured over a game and logged when it stops, to compare network conditions and settings
+  struct SessionStats
+  {
+    std::atomic<u32> frames = 0;
+    std::atomic<u64> input_delay_us = 0;
+    std::atomic<u64> input_delay_samples = 0;
+    std::atomic<u32> stalls = 0;
+    std::atomic<u64> stall_us = 0;
+    std::atomic<u64> bytes_sent = 0;
+
+    void Reset();
+  };
+  SessionStats m_session_stats;
+  // When each entry in the pad buffers of local pads was polled, only touched on the CPU thread
+  std::array<std::deque<std::chrono::steady_clock::time_point>, 4> m_local_pad_poll_times;
 
   NetPlayUI* m_dialog = nullptr;
 
   ENetHost* m_client = nullptr;
   ENetPeer* m_server = nullptr;
   std::thread m_thread;
+  // Relays the connection to the host when a simulated round trip time, jitter or loss is set
+  std::unique_ptr<LinkSimulator> m_link_simulator;
 
   SyncIdentifier m_selected_game;
   Common::Flag m_is_running{false};
@@ -288,6 +302,7 @@ private:
   void SendStopGamePacket();
 
   void SyncSaveDataResponse(bool success);
+  void SendCachedSaveBlocks();
   void SyncCodeResponse(bool success);
 
   bool PollLocalPad(int local_pad, sf::Packet& packet);
@@ -297,7 +312,8 @@ private:
                                sf::Packet& packet);
 
   void UpdateDevices();
-  void AddPadStateToPacket(int in_game_pad, const GCPadStatus& np, sf::Packet& packet);
+  void AddPadStateToPacket(int in_game_pad, u32 number, const GCPadStatus& np,
+                           InputDeltaState& stream, sf::Packet& packet);
   void AddWiimoteStateToPacket(int in_game_pad, const WiimoteEmu::SerializedWiimoteState& np,
                                sf::Packet& packet);
   void Send(const sf::Packet& packet, u8 channel_id = DEFAULT_CHANNEL);
@@ -306,6 +322,10 @@ private:
   void SendGameStatus();
   void ComputeGameDigest(const SyncIdentifier& sync_identifier);
   void DisplayPlayersPing();
+  void ReportSessionStats();
+  void SaveSpectatorKeyframe();
+  void LoadSpectatorKeyframe();
+  void UpdateMidGameJoin(int pad_nb);
   u32 GetPlayersMaxPing() const;
 
   void OnData(sf::Packet& packet);
@@ -334,6 +354,8 @@ private:
   void OnPing(sf::Packet& packet);
   void OnPlayerPingData(sf::Packet& packet);
   void OnDesyncDetected(sf::Packet& packet);
+  void OnMemoryDesyncDetected(sf::Packet& packet);
+  void OnSpectatorKeyframe(sf::Packet& packet);
   void OnSyncSaveData(sf::Packet& packet);
   void OnSyncSaveDataNotify(sf::Packet& packet);
   void OnSyncSaveDataRaw(sf::Packet& packet);
@@ -353,6 +375,14 @@ private:
   void OnGameDigestAbort();
   void OnSendCodesMsg(sf::Packet& packet);
 
+  bool IsRollbackActive() const;
+  bool IsSpeculativeLocalPad(size_t pad) const;
+  bool RollbackBeginFrame();
+  void RollbackAtFrameBoundary();
+
+  // Runs a member function once the CPU thread is done with the current CoreTiming event, where
+  // the state can be saved and loaded. Only call from the CPU thread.
+  static void RunAtFrameBoundary(void (NetPlayClient::*job)());
 
   bool m_is_connected = false;
   ConnectionState m_connection_state = ConnectionState::Failure;
@@ -382,15 +412,39 @@ private:
 
   u64 m_initial_rtc = 0;
   u32 m_timebase_frame = 0;
+  std::unique_ptr<MemoryHasher> m_memory_hasher;
 
   std::unique_ptr<IOS::HLE::FS::FileSystem> m_wii_sync_fs;
   std::vector<u64> m_wii_sync_titles;
   std::string m_wii_sync_redirect_folder;
-
-  std::vector<std::vector<GCPadStatus>> inputs;
-  int delay = 2;
-  std::condition_variable wait_for_inputs;
-  SaveStateArray save_states;
+  std::unique_ptr<SaveBlockCache> m_save_block_cache;
+
+  // Rollback state, only touched on the CPU thread once the game is running.
+  RollbackTimeline m_rollback;
+  RollbackFrame* m_rollback_current = nullptr;
+  // Whether the state for m_rollback_current still has to be saved at the end of the poll
+  bool m_rollback_save_pending = false;
+  bool m_rollback_resimulating = false;
+
+  // Keyframes for spectators joining a game in progress. The host takes one every
+  // spectator_keyframe_frames batched polls along with how many inputs it has taken from each pad
+  // buffer, so the server knows which of the inputs it relayed have to be replayed after it.
+  struct SpectatorKeyframe
+  {
+    u32 poll = 0;
+    std::array<u64, 4> pads{};
+    SaveState state;
+    // The state buffer can be bigger than the state itself
+    size_t state_size = 0;
+  };
+  Common::WorkQueueThread<SpectatorKeyframe> m_spectator_keyframe_thread;
+  std::array<u64, 4> m_pad_buffer_popped{};
+  u32 m_spectator_keyframe_poll = 0;
+  // Set on the NETPLAY thread when the server sends us a keyframe to start from, before the game
+  // starts. The keyframe is loaded on the CPU thread after the first batched poll.
+  bool m_joined_mid_game = false;
+  bool m_spectator_catching_up = false;
+  SaveState m_pending_spectator_keyframe;
 };
 
 void NetPlay_Enable(NetPlayClient* const np);
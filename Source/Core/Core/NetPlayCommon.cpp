@@ -4,174 +4,454 @@
 #include "Core/NetPlayCommon.h"
 
 #include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <system_error>
+#include <utility>
 
 #include <fmt/format.h>
-#include <lzo/lzo1x.h>
+#include <zstd.h>
 
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/SFMLHelper.h"
+#include "Common/StringUtil.h"
+#include "DiscIO/MultithreadedCompressor.h"
 
 namespace NetPlay
 {
-constexpr u32 LZO_IN_LEN = 1024 * 64;
-constexpr u32 LZO_OUT_LEN = LZO_IN_LEN + (LZO_IN_LEN / 16) + 64 + 3;
+// Compressed data is sent as the uncompressed size (u64), then records for blocks of at most
+// BLOCK_SIZE bytes that were compressed independently, then BlockType::End. Nothing is sent after
+// the size if it is zero. A block record is a BlockType followed by the compressed size (u32) and
+// data for BlockType::Compressed, or by the SHA-1 of the uncompressed block for BlockType::Cached.
+constexpr u32 BLOCK_SIZE = 256 * 1024;
 
-bool CompressFileIntoPacket(const std::string& file_path, sf::Packet& packet)
+enum class BlockType : u8
+{
+  End = 0,
+  Compressed = 1,
+  Cached = 2,
+};
+
+static std::optional<SaveBlockHash> ParseSaveBlockHash(std::string_view name)
+{
+  SaveBlockHash hash;
+  if (name.size() != hash.size() * 2)
+    return std::nullopt;
+
+  for (size_t i = 0; i < hash.size(); ++i)
+  {
+    u8 byte;
+    if (!TryParse(std::string(name.substr(i * 2, 2)), &byte, 16))
+      return std::nullopt;
+    hash[i] = byte;
+  }
+  return hash;
+}
+
+SaveBlockCache::SaveBlockCache(std::string directory) : m_directory(std::move(directory))
+{
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator(StringToPath(m_directory), error))
+  {
+    if (!entry.is_regular_file(error))
+      continue;
+    if (const auto hash = ParseSaveBlockHash(PathToString(entry.path().filename())))
+      m_hashes.insert(*hash);
+  }
+}
+
+void SaveBlockCache::Trim(u64 max_size)
+{
+  struct Entry
+  {
+    SaveBlockHash hash;
+    u64 size;
+    std::filesystem::file_time_type time;
+  };
+
+  std::vector<Entry> entries;
+  u64 total_size = 0;
+  for (const SaveBlockHash& hash : m_hashes)
+  {
+    std::error_code error;
+    const std::filesystem::path path = StringToPath(GetPath(hash));
+    const u64 size = std::filesystem::file_size(path, error);
+    if (error)
+      continue;
+    entries.push_back({hash, size, std::filesystem::last_write_time(path, error)});
+    total_size += size;
+  }
+
+  std::ranges::sort(entries, {}, &Entry::time);
+  for (const Entry& entry : entries)
+  {
+    if (total_size <= max_size)
+      break;
+    File::Delete(GetPath(entry.hash), File::IfAbsentBehavior::NoConsoleWarning);
+    m_hashes.erase(entry.hash);
+    total_size -= entry.size;
+  }
+}
+
+std::optional<std::vector<u8>> SaveBlockCache::Read(const SaveBlockHash& hash)
+{
+  if (!m_hashes.contains(hash))
+    return std::nullopt;
+
+  const std::string path = GetPath(hash);
+  std::vector<u8> block;
+  {
+    File::IOFile file(path, "rb");
+    block.resize(file.GetSize());
+    if (file.ReadBytes(block.data(), block.size()) &&
+        Common::SHA1::CalculateDigest(block.data(), block.size()) == hash)
+    {
+      return block;
+    }
+  }
+
+  File::Delete(path, File::IfAbsentBehavior::NoConsoleWarning);
+  m_hashes.erase(hash);
+  return std::nullopt;
+}
+
+void SaveBlockCache::Write(const SaveBlockHash& hash, std::span<const u8> block)
+{
+  if (m_hashes.contains(hash))
+    return;
+
+  // Write to a temporary file first so that an interrupted write can't leave a truncated block
+  // behind under the real name.
+  const std::string path = GetPath(hash);
+  const std::string temp_path = path + ".tmp";
+  if (!File::CreateFullPath(m_directory))
+    return;
+  {
+    File::IOFile file(temp_path, "wb");
+    if (!file.WriteBytes(block.data(), block.size()))
+      return;
+  }
+  if (File::Rename(temp_path, path))
+    m_hashes.insert(hash);
+}
+
+std::string SaveBlockCache::GetPath(const SaveBlockHash& hash) const
+{
+  return m_directory + Common::BytesToHexString(hash);
+}
+
+namespace
+{
+enum class PacketItemType
+{
+  // Copied into the packet as it is
+  Framing,
+  // Uncompressed block on the way to the compress threads
+  Block,
+  // What the compress threads turn a block into
+  CompressedBlock,
+  CachedBlock,
+};
+
+struct PacketItem
+{
+  std::vector<u8> data;
+  PacketItemType type;
+};
+
+struct CompressThreadState
+{
+  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context{nullptr, ZSTD_freeCCtx};
+};
+
+DiscIO::ConversionResult<PacketItem> CompressItem(CompressThreadState* state, PacketItem item,
+                                                  const std::set<SaveBlockHash>* cached_blocks)
+{
+  if (item.type != PacketItemType::Block)
+    return item;
+
+  if (cached_blocks && !cached_blocks->empty())
+  {
+    const SaveBlockHash hash = Common::SHA1::CalculateDigest(item.data.data(), item.data.size());
+    if (cached_blocks->contains(hash))
+      return PacketItem{std::vector<u8>(hash.begin(), hash.end()), PacketItemType::CachedBlock};
+  }
+
+  if (!state->context)
+    state->context.reset(ZSTD_createCCtx());
+  if (!state->context)
+    return DiscIO::ConversionResultCode::InternalError;
+
+  std::vector<u8> compressed(ZSTD_compressBound(item.data.size()));
+  const size_t result =
+      ZSTD_compressCCtx(state->context.get(), compressed.data(), compressed.size(),
+                        item.data.data(), item.data.size(), ZSTD_CLEVEL_DEFAULT);
+  if (ZSTD_isError(result))
+    return DiscIO::ConversionResultCode::InternalError;
+
+  compressed.resize(result);
+  return PacketItem{std::move(compressed), PacketItemType::CompressedBlock};
+}
+}  // namespace
+
+struct PacketCompressor::Worker
+{
+  Worker(sf::Packet& packet, const std::set<SaveBlockHash>* cached_blocks)
+      : compressor(
+            [](CompressThreadState*) { return DiscIO::ConversionResultCode::Success; },
+            [cached_blocks](CompressThreadState* state, PacketItem item) {
+              return CompressItem(state, std::move(item), cached_blocks);
+            },
+            [&packet](PacketItem item) {
+              if (item.type == PacketItemType::CompressedBlock)
+                packet << BlockType::Compressed << static_cast<u32>(item.data.size());
+              else if (item.type == PacketItemType::CachedBlock)
+                packet << BlockType::Cached;
+              packet.append(item.data.data(), item.data.size());
+              return DiscIO::ConversionResultCode::Success;
+            })
+  {
+  }
+
+  DiscIO::MultithreadedCompressor<CompressThreadState, PacketItem, PacketItem> compressor;
+};
+
+PacketCompressor::PacketCompressor(sf::Packet& packet,
+                                   const std::set<SaveBlockHash>* cached_blocks)
+    : m_packet(packet), m_cached_blocks(cached_blocks)
+{
+}
+
+PacketCompressor::~PacketCompressor() = default;
+
+void PacketCompressor::FlushFraming()
+{
+  if (m_framing.getDataSize() == 0)
+    return;
+
+  const u8* data = static_cast<const u8*>(m_framing.getData());
+  if (m_worker)
+  {
+    m_worker->compressor.CompressAndWrite(
+        PacketItem{std::vector<u8>(data, data + m_framing.getDataSize()), PacketItemType::Framing});
+  }
+  else
+  {
+    // Nothing is in flight, so the framing can go straight into the packet.
+    m_packet.append(data, m_framing.getDataSize());
+  }
+  m_framing.clear();
+}
+
+void PacketCompressor::CompressBlock(std::vector<u8> block)
+{
+  FlushFraming();
+
+  // The threads are only started once there is something to compress.
+  if (!m_worker)
+    m_worker = std::make_unique<Worker>(m_packet, m_cached_blocks);
+
+  m_worker->compressor.CompressAndWrite(PacketItem{std::move(block), PacketItemType::Block});
+}
+
+bool PacketCompressor::AddFile(const std::string& file_path)
 {
   File::IOFile file(file_path, "rb");
   if (!file)
   {
     PanicAlertFmtT("Failed to open file \"{0}\".", file_path);
+    m_failed = true;
     return false;
   }
 
   const u64 size = file.GetSize();
-  packet << size;
+  m_framing << size;
 
   if (size == 0)
     return true;
 
-  std::vector<u8> in_buffer(LZO_IN_LEN);
-  std::vector<u8> out_buffer(LZO_OUT_LEN);
-  std::vector<u8> wrkmem(LZO1X_1_MEM_COMPRESS);
-
-  lzo_uint i = 0;
-  while (true)
+  for (u64 offset = 0; offset < size; offset += BLOCK_SIZE)
   {
-    lzo_uint32 cur_len = 0;  // number of bytes to read
-    lzo_uint out_len = 0;    // number of bytes to write
-
-    if ((i + LZO_IN_LEN) >= size)
-    {
-      cur_len = static_cast<lzo_uint32>(size - i);
-    }
-    else
-    {
-      cur_len = LZO_IN_LEN;
-    }
-
-    if (cur_len <= 0)
-      break;  // EOF
-
-    if (!file.ReadBytes(in_buffer.data(), cur_len))
+    std::vector<u8> block(static_cast<size_t>(std::min<u64>(BLOCK_SIZE, size - offset)));
+    if (!file.ReadBytes(block.data(), block.size()))
     {
       PanicAlertFmtT("Error reading file: {0}", file_path.c_str());
+      m_failed = true;
       return false;
     }
+    CompressBlock(std::move(block));
+  }
 
-    if (lzo1x_1_compress(in_buffer.data(), cur_len, out_buffer.data(), &out_len, wrkmem.data()) !=
-        LZO_E_OK)
-    {
-      PanicAlertFmtT("Internal LZO Error - compression failed");
-      return false;
-    }
+  // Mark end of data
+  m_framing << BlockType::End;
 
-    // The size of the data to write is 'out_len'
-    packet << static_cast<u32>(out_len);
-    for (size_t j = 0; j < out_len; j++)
-    {
-      packet << out_buffer[j];
-    }
+  return true;
+}
 
-    if (cur_len != LZO_IN_LEN)
-      break;
+bool PacketCompressor::AddBuffer(std::span<const u8> buffer)
+{
+  const u64 size = buffer.size();
+  m_framing << size;
+
+  if (size == 0)
+    return true;
 
-    i += cur_len;
+  for (size_t offset = 0; offset < buffer.size(); offset += BLOCK_SIZE)
+  {
+    const std::span<const u8> block =
+        buffer.subspan(offset, std::min<size_t>(BLOCK_SIZE, buffer.size() - offset));
+    CompressBlock(std::vector<u8>(block.begin(), block.end()));
   }
 
   // Mark end of data
-  packet << static_cast<u32>(0);
+  m_framing << BlockType::End;
 
   return true;
 }
 
-static bool CompressFolderIntoPacketInternal(const File::FSTEntry& folder, sf::Packet& packet)
+static bool AddFolderInternal(PacketCompressor& compressor, const File::FSTEntry& folder)
 {
   const u64 size = folder.children.size();
-  packet << size;
+  compressor.Framing() << size;
   for (const auto& child : folder.children)
   {
     const bool is_folder = child.isDirectory;
-    packet << child.virtualName;
-    packet << is_folder;
-    const bool success = is_folder ? CompressFolderIntoPacketInternal(child, packet) :
-                                     CompressFileIntoPacket(child.physicalName, packet);
+    compressor.Framing() << child.virtualName;
+    compressor.Framing() << is_folder;
+    const bool success = is_folder ? AddFolderInternal(compressor, child) :
+                                     compressor.AddFile(child.physicalName);
     if (!success)
       return false;
   }
   return true;
 }
 
-bool CompressFolderIntoPacket(const std::string& folder_path, sf::Packet& packet)
+bool PacketCompressor::AddFolder(const std::string& folder_path)
 {
   if (!File::IsDirectory(folder_path))
   {
-    packet << false;
+    m_framing << false;
     return true;
   }
 
-  packet << true;
-  return CompressFolderIntoPacketInternal(File::ScanDirectoryTree(folder_path, true), packet);
+  m_framing << true;
+  return AddFolderInternal(*this, File::ScanDirectoryTree(folder_path, true));
 }
 
-bool CompressBufferIntoPacket(const std::vector<u8>& in_buffer, sf::Packet& packet)
+bool PacketCompressor::Finish()
 {
-  const u64 size = in_buffer.size();
-  packet << size;
+  FlushFraming();
 
-  if (size == 0)
-    return true;
+  if (m_worker)
+  {
+    m_worker->compressor.Shutdown();
+    if (m_worker->compressor.GetStatus() != DiscIO::ConversionResultCode::Success)
+    {
+      PanicAlertFmtT("Internal Zstandard Error - compression failed");
+      m_failed = true;
+    }
+    m_worker.reset();
+  }
 
-  std::vector<u8> out_buffer(LZO_OUT_LEN);
-  std::vector<u8> wrkmem(LZO1X_1_MEM_COMPRESS);
+  return !m_failed;
+}
 
-  lzo_uint i = 0;
+bool CompressFileIntoPacket(const std::string& file_path, sf::Packet& packet)
+{
+  PacketCompressor compressor(packet);
+  return compressor.AddFile(file_path) && compressor.Finish();
+}
+
+bool CompressFolderIntoPacket(const std::string& folder_path, sf::Packet& packet)
+{
+  PacketCompressor compressor(packet);
+  return compressor.AddFolder(folder_path) && compressor.Finish();
+}
+
+bool CompressBufferIntoPacket(std::span<const u8> in_buffer, sf::Packet& packet)
+{
+  PacketCompressor compressor(packet);
+  return compressor.AddBuffer(in_buffer) && compressor.Finish();
+}
+
+// Reads the blocks that follow an uncompressed size of `size` and passes each one to on_block once
+// it has been decompressed.
+template <typename Callback>
+static bool DecompressBlocks(sf::Packet& packet, u64 size, SaveBlockCache* cache,
+                             Callback on_block)
+{
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context(ZSTD_createDCtx(), ZSTD_freeDCtx);
+  if (!context)
+    return false;
+
+  // A compressed size followed by the data reads the same as a string.
+  std::string compressed;
+  std::vector<u8> block(BLOCK_SIZE);
+  u64 total = 0;
   while (true)
   {
-    lzo_uint32 cur_len = 0;  // number of bytes to read
-    lzo_uint out_len = 0;    // number of bytes to write
+    BlockType type;
+    packet >> type;
+    if (!packet)
+      return false;
+    if (type == BlockType::End)
+      break;  // We reached the end of the data stream
 
-    if ((i + LZO_IN_LEN) >= size)
+    std::span<const u8> decompressed;
+    std::optional<std::vector<u8>> cached;
+    if (type == BlockType::Compressed)
     {
-      cur_len = static_cast<lzo_uint32>(size - i);
+      packet >> compressed;
+      if (!packet)
+        return false;
+
+      const size_t result = ZSTD_decompressDCtx(context.get(), block.data(), block.size(),
+                                                compressed.data(), compressed.size());
+      if (ZSTD_isError(result))
+      {
+        PanicAlertFmtT("Internal Zstandard Error - decompression failed");
+        return false;
+      }
+
+      decompressed = std::span<const u8>(block.data(), result);
+      if (cache)
+        cache->Write(Common::SHA1::CalculateDigest(block.data(), result), decompressed);
     }
-    else
+    else if (type == BlockType::Cached)
     {
-      cur_len = LZO_IN_LEN;
+      SaveBlockHash hash;
+      for (u8& byte : hash)
+        packet >> byte;
+      if (!packet || !cache)
+        return false;
+
+      cached = cache->Read(hash);
+      if (!cached)
+      {
+        ERROR_LOG_FMT(NETPLAY, "Save block {} is missing from the cache",
+                      Common::BytesToHexString(hash));
+        return false;
+      }
+      decompressed = *cached;
     }
-
-    if (cur_len <= 0)
-      break;  // end of buffer
-
-    if (lzo1x_1_compress(&in_buffer[i], cur_len, out_buffer.data(), &out_len, wrkmem.data()) !=
-        LZO_E_OK)
+    else
     {
-      PanicAlertFmtT("Internal LZO Error - compression failed");
       return false;
     }
 
-    // The size of the data to write is 'out_len'
-    packet << static_cast<u32>(out_len);
-    for (size_t j = 0; j < out_len; j++)
-    {
-      packet << out_buffer[j];
-    }
-
-    if (cur_len != LZO_IN_LEN)
-      break;
-
-    i += cur_len;
+    if (decompressed.size() > size - total || !on_block(decompressed))
+      return false;
+    total += decompressed.size();
   }
 
-  // Mark end of data
-  packet << static_cast<u32>(0);
-
-  return true;
+  return total == size;
 }
 
-bool DecompressPacketIntoFile(sf::Packet& packet, const std::string& file_path)
+bool DecompressPacketIntoFile(sf::Packet& packet, const std::string& file_path,
+                              SaveBlockCache* cache)
 {
   u64 file_size = Common::PacketReadU64(packet);
 
@@ -185,41 +465,18 @@ bool DecompressPacketIntoFile(sf::Packet& packet, const std::string& file_path)
     return false;
   }
 
-  std::vector<u8> in_buffer(LZO_OUT_LEN);
-  std::vector<u8> out_buffer(LZO_IN_LEN);
-
-  while (true)
-  {
-    u32 cur_len = 0;       // number of bytes to read
-    lzo_uint new_len = 0;  // number of bytes to write
-
-    packet >> cur_len;
-    if (!cur_len)
-      break;  // We reached the end of the data stream
-
-    for (size_t j = 0; j < cur_len; j++)
-    {
-      packet >> in_buffer[j];
-    }
-
-    if (lzo1x_decompress(in_buffer.data(), cur_len, out_buffer.data(), &new_len, nullptr) !=
-        LZO_E_OK)
-    {
-      PanicAlertFmtT("Internal LZO Error - decompression failed");
-      return false;
-    }
-
-    if (!file.WriteBytes(out_buffer.data(), new_len))
+  return DecompressBlocks(packet, file_size, cache, [&](std::span<const u8> block) {
+    if (!file.WriteBytes(block.data(), block.size()))
     {
       PanicAlertFmtT("Error writing file: {0}", file_path);
       return false;
     }
-  }
-
-  return true;
+    return true;
+  });
 }
 
-static bool DecompressPacketIntoFolderInternal(sf::Packet& packet, const std::string& folder_path)
+static bool DecompressPacketIntoFolderInternal(sf::Packet& packet, const std::string& folder_path,
+                                               SaveBlockCache* cache)
 {
   if (!File::CreateFullPath(folder_path + "/"))
     return false;
@@ -243,24 +500,26 @@ static bool DecompressPacketIntoFolderInternal(sf::Packet& packet, const std::st
     bool is_folder;
     packet >> is_folder;
     std::string path = fmt::format("{}/{}", folder_path, name);
-    const bool success = is_folder ? DecompressPacketIntoFolderInternal(packet, path) :
-                                     DecompressPacketIntoFile(packet, path);
+    const bool success = is_folder ? DecompressPacketIntoFolderInternal(packet, path, cache) :
+                                     DecompressPacketIntoFile(packet, path, cache);
     if (!success)
       return false;
   }
   return true;
 }
 
-bool DecompressPacketIntoFolder(sf::Packet& packet, const std::string& folder_path)
+bool DecompressPacketIntoFolder(sf::Packet& packet, const std::string& folder_path,
+                                SaveBlockCache* cache)
 {
   bool folder_existed;
   packet >> folder_existed;
   if (!folder_existed)
     return true;
-  return DecompressPacketIntoFolderInternal(packet, folder_path);
+  return DecompressPacketIntoFolderInternal(packet, folder_path, cache);
 }
 
-std::optional<std::vector<u8>> DecompressPacketIntoBuffer(sf::Packet& packet)
+std::optional<std::vector<u8>> DecompressPacketIntoBuffer(sf::Packet& packet,
+                                                          SaveBlockCache* cache)
 {
   u64 size = Common::PacketReadU64(packet);
 
@@ -269,31 +528,15 @@ std::optional<std::vector<u8>> DecompressPacketIntoBuffer(sf::Packet& packet)
   if (size == 0)
     return out_buffer;
 
-  std::vector<u8> in_buffer(LZO_OUT_LEN);
-
-  lzo_uint i = 0;
-  while (true)
-  {
-    u32 cur_len = 0;       // number of bytes to read
-    lzo_uint new_len = 0;  // number of bytes to write
-
-    packet >> cur_len;
-    if (!cur_len)
-      break;  // We reached the end of the data stream
-
-    for (size_t j = 0; j < cur_len; j++)
-    {
-      packet >> in_buffer[j];
-    }
-
-    if (lzo1x_decompress(in_buffer.data(), cur_len, &out_buffer[i], &new_len, nullptr) != LZO_E_OK)
-    {
-      PanicAlertFmtT("Internal LZO Error - decompression failed");
-      return {};
-    }
+  size_t offset = 0;
+  const bool success = DecompressBlocks(packet, size, cache, [&](std::span<const u8> block) {
+    std::ranges::copy(block, out_buffer.begin() + offset);
+    offset += block.size();
+    return true;
+  });
 
-    i += new_len;
-  }
+  if (!success)
+    return {};
 
   return out_buffer;
 }
@@ -7,11 +7,15 @@
 
 #include <array>
 #include <chrono>
+#include <memory>
 #include <optional>
+#include <set>
+#include <span>
 #include <string>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
 
 namespace NetPlay
 {
@@ -20,10 +24,81 @@ using namespace std::chrono_literals;
 // connection is disconnected
 constexpr std::chrono::milliseconds PEER_TIMEOUT = 30s;
 
+using SaveBlockHash = Common::SHA1::Digest;
+
+// Blocks of save data received in earlier save syncs, each stored in a file named after the SHA-1
+// of its contents. Clients tell the host which blocks they hold, so that blocks every client
+// already has can be sent as just their hash.
+class SaveBlockCache
+{
+public:
+  explicit SaveBlockCache(std::string directory);
+
+  // Deletes the least recently written blocks until the cache takes up at most max_size bytes.
+  void Trim(u64 max_size);
+
+  const std::set<SaveBlockHash>& GetHashes() const { return m_hashes; }
+
+  // Fails if the block is missing or its contents no longer match the hash. Such a block is
+  // dropped from the cache, so that it's no longer reported as held.
+  std::optional<std::vector<u8>> Read(const SaveBlockHash& hash);
+  void Write(const SaveBlockHash& hash, std::span<const u8> block);
+
+private:
+  std::string GetPath(const SaveBlockHash& hash) const;
+
+  std::string m_directory;
+  std::set<SaveBlockHash> m_hashes;
+};
+
+// Compresses files and buffers on worker threads and appends them to a packet in the order they
+// were added. Uncompressed data for the receiver, such as file names, is written to Framing() and
+// stays in order with the compressed data around it. The packet must not be touched until Finish()
+// has returned.
+class PacketCompressor
+{
+public:
+  // Blocks whose hash is in cached_blocks are sent as a reference to the receiver's SaveBlockCache.
+  // The set must stay alive and unchanged until Finish() has returned.
+  explicit PacketCompressor(sf::Packet& packet,
+                            const std::set<SaveBlockHash>* cached_blocks = nullptr);
+  ~PacketCompressor();
+
+  PacketCompressor(const PacketCompressor&) = delete;
+  PacketCompressor& operator=(const PacketCompressor&) = delete;
+
+  sf::Packet& Framing() { return m_framing; }
+
+  bool AddFile(const std::string& file_path);
+  bool AddFolder(const std::string& folder_path);
+  bool AddBuffer(std::span<const u8> buffer);
+
+  // Waits for the worker threads and appends everything that is still pending to the packet.
+  bool Finish();
+
+private:
+  struct Worker;
+
+  void FlushFraming();
+  void CompressBlock(std::vector<u8> block);
+
+  sf::Packet& m_packet;
+  const std::set<SaveBlockHash>* m_cached_blocks;
+  sf::Packet m_framing;
+  std::unique_ptr<Worker> m_worker;
+  bool m_failed = false;
+};
+
 bool CompressFileIntoPacket(const std::string& file_path, sf::Packet& packet);
 bool CompressFolderIntoPacket(const std::string& folder_path, sf::Packet& packet);
-bool CompressBufferIntoPacket(const std::vector<u8>& in_buffer, sf::Packet& packet);
-bool DecompressPacketIntoFile(sf::Packet& packet, const std::string& file_path);
-bool DecompressPacketIntoFolder(sf::Packet& packet, const std::string& folder_path);
-std::optional<std::vector<u8>> DecompressPacketIntoBuffer(sf::Packet& packet);
+bool CompressBufferIntoPacket(std::span<const u8> in_buffer, sf::Packet& packet);
+
+// Blocks sent as a reference are read from cache, and all other blocks are added to it. Without a
+// cache, a packet that contains references fails to decompress.
+bool DecompressPacketIntoFile(sf::Packet& packet, const std::string& file_path,
+                              SaveBlockCache* cache = nullptr);
+bool DecompressPacketIntoFolder(sf::Packet& packet, const std::string& folder_path,
+                                SaveBlockCache* cache = nullptr);
+std::optional<std::vector<u8>> DecompressPacketIntoBuffer(sf::Packet& packet,
+                                                          SaveBlockCache* cache = nullptr);
 }  // namespace NetPlay
@@ -0,0 +1,239 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/NetPlayGameDigest.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <system_error>
+#include <vector>
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/MultithreadedCompressor.h"
+
+namespace NetPlay
+{
+namespace
+{
+constexpr u32 CACHE_REVISION = 1;
+constexpr u64 CHUNK_SIZE = 8 * 1024 * 1024;
+
+struct CachedDigest
+{
+  std::string path;
+  u64 size = 0;
+  s64 modification_time = 0;
+  std::string digest;
+};
+
+// Loaded from gamedigest.cache, next to the game list cache, the first time it is needed.
+class GameDigestCache
+{
+public:
+  std::optional<std::string> Find(const CachedDigest& key)
+  {
+    std::lock_guard lk(m_mutex);
+    Load();
+
+    const auto it = std::ranges::find(m_entries, key.path, &CachedDigest::path);
+    if (it == m_entries.end() || it->size != key.size ||
+        it->modification_time != key.modification_time)
+    {
+      return std::nullopt;
+    }
+    return it->digest;
+  }
+
+  void Add(CachedDigest entry)
+  {
+    std::lock_guard lk(m_mutex);
+    Load();
+
+    std::erase_if(m_entries, [&entry](const CachedDigest& e) { return e.path == entry.path; });
+    m_entries.push_back(std::move(entry));
+    Save();
+  }
+
+private:
+  static std::string GetPath() { return File::GetUserPath(D_CACHE_IDX) + "gamedigest.cache"; }
+
+  void Load()
+  {
+    if (m_loaded)
+      return;
+    m_loaded = true;
+
+    File::IOFile f(GetPath(), "rb");
+    if (!f)
+      return;
+
+    std::vector<u8> buffer(f.GetSize());
+    if (buffer.empty() || !f.ReadBytes(buffer.data(), buffer.size()))
+      return;
+
+    u8* ptr = buffer.data();
+    PointerWrap p(&ptr, buffer.size(), PointerWrap::Mode::Read);
+    DoState(p);
+    if (!p.IsReadMode())
+    {
+      WARN_LOG_FMT(NETPLAY, "Discarding outdated or corrupted game digest cache.");
+      m_entries.clear();
+    }
+  }
+
+  void Save()
+  {
+    u8* ptr = nullptr;
+    PointerWrap p_measure(&ptr, 0, PointerWrap::Mode::Measure);
+    DoState(p_measure);
+    const size_t buffer_size = reinterpret_cast<size_t>(ptr);
+
+    std::vector<u8> buffer(buffer_size);
+    ptr = buffer.data();
+    PointerWrap p(&ptr, buffer_size, PointerWrap::Mode::Write);
+    DoState(p);
+
+    File::CreateFullPath(GetPath());
+    File::IOFile f(GetPath(), "wb");
+    if (!f.WriteBytes(buffer.data(), buffer.size()))
+      ERROR_LOG_FMT(NETPLAY, "Failed to write game digest cache.");
+  }
+
+  void DoState(PointerWrap& p)
+  {
+    u32 revision = CACHE_REVISION;
+    p.Do(revision);
+    if (p.IsReadMode() && revision != CACHE_REVISION)
+    {
+      p.SetMeasureMode();
+      return;
+    }
+
+    p.DoEachElement(m_entries, [](PointerWrap& state, CachedDigest& entry) {
+      state.Do(entry.path);
+      state.Do(entry.size);
+      state.Do(entry.modification_time);
+      state.Do(entry.digest);
+    });
+  }
+
+  std::mutex m_mutex;
+  std::vector<CachedDigest> m_entries;
+  bool m_loaded = false;
+};
+
+GameDigestCache s_cache;
+
+std::optional<CachedDigest> GetCacheKey(const std::string& path)
+{
+  std::error_code error;
+  const std::filesystem::path fs_path = StringToPath(path);
+  const u64 size = std::filesystem::file_size(fs_path, error);
+  if (error)
+    return std::nullopt;
+  const auto modification_time = std::filesystem::last_write_time(fs_path, error);
+  if (error)
+    return std::nullopt;
+
+  return CachedDigest{path, size, modification_time.time_since_epoch().count(), {}};
+}
+
+// BlobReaders aren't thread safe, so each read thread gets a copy of its own.
+struct ReadThreadState
+{
+  std::unique_ptr<DiscIO::BlobReader> reader;
+};
+
+struct Chunk
+{
+  u64 offset;
+  u64 size;
+};
+
+std::string ComputeDigest(const DiscIO::BlobReader& blob,
+                          const std::function<bool(int)>& report_progress)
+{
+  const u64 data_size = blob.GetDataSize();
+  auto ctx = Common::SHA1::CreateContext();
+  u64 hashed_size = 0;
+
+  // The reads run in parallel, but their results come out in order so that the digest is the same
+  // as that of a single pass over the data.
+  DiscIO::MultithreadedCompressor<ReadThreadState, Chunk, std::vector<u8>> readers(
+      [&blob](ReadThreadState* state) {
+        state->reader = blob.CopyReader();
+        return state->reader ? DiscIO::ConversionResultCode::Success :
+                               DiscIO::ConversionResultCode::InternalError;
+      },
+      [](ReadThreadState* state, Chunk chunk) -> DiscIO::ConversionResult<std::vector<u8>> {
+        std::vector<u8> data(chunk.size);
+        if (!state->reader->Read(chunk.offset, chunk.size, data.data()))
+          return DiscIO::ConversionResultCode::ReadFailed;
+        return data;
+      },
+      [&](std::vector<u8> data) {
+        ctx->Update(data.data(), data.size());
+        hashed_size += data.size();
+
+        const int progress = static_cast<int>(static_cast<float>(hashed_size) /
+                                              static_cast<float>(data_size) * 100);
+        return report_progress(progress) ? DiscIO::ConversionResultCode::Success :
+                                           DiscIO::ConversionResultCode::Canceled;
+      });
+
+  for (u64 offset = 0;
+       offset < data_size && readers.GetStatus() == DiscIO::ConversionResultCode::Success;
+       offset += CHUNK_SIZE)
+  {
+    readers.CompressAndWrite(Chunk{offset, std::min(CHUNK_SIZE, data_size - offset)});
+  }
+  readers.Shutdown();
+
+  if (readers.GetStatus() != DiscIO::ConversionResultCode::Success || hashed_size != data_size)
+    return "";
+
+  return fmt::format("{:02x}", fmt::join(ctx->Finish(), ""));
+}
+}  // namespace
+
+std::string GetGameDigest(const std::string& path,
+                          const std::function<bool(int)>& report_progress)
+{
+  std::optional<CachedDigest> key = GetCacheKey(path);
+  if (key)
+  {
+    if (std::optional<std::string> digest = s_cache.Find(*key))
+    {
+      INFO_LOG_FMT(NETPLAY, "Using cached game digest for {}.", path);
+      report_progress(100);
+      return *digest;
+    }
+  }
+
+  const std::unique_ptr<DiscIO::BlobReader> blob = DiscIO::CreateBlobReader(path);
+  if (!blob)
+    return "";
+
+  std::string digest = ComputeDigest(*blob, report_progress);
+  if (key && !digest.empty())
+  {
+    key->digest = digest;
+    s_cache.Add(std::move(*key));
+  }
+  return digest;
+}
+}  // namespace NetPlay
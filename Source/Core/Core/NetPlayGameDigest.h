@@ -0,0 +1,17 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace NetPlay
+{
+// Returns the SHA-1 of the data of the disc image or file at path as a hex string, or an empty
+// string if reading failed or report_progress returned false. The data is read by several threads
+// at once, and results are remembered in a cache keyed by path, size and modification time, so an
+// unchanged file is only read once.
+std::string GetGameDigest(const std::string& path,
+                          const std::function<bool(int)>& report_progress);
+}  // namespace NetPlay
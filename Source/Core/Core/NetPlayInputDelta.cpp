@@ -0,0 +1,169 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/NetPlayInputDelta.h"
+
+#include <SFML/Network/Packet.hpp>
+
+#include <algorithm>
+#include <tuple>
+
+namespace NetPlay
+{
+// A pad is sent as a u16 mask of the fields that changed, in the order below, followed by the
+// changed fields, then its number if that isn't the one that was expected. A Wiimote is sent as its length, then if that is not zero, a u32 mask of the
+// bytes that changed followed by those bytes.
+namespace
+{
+constexpr u16 PAD_BUTTON = 1 << 0;
+constexpr u16 PAD_IS_CONNECTED = 1 << 1;
+constexpr auto PAD_AXES = std::to_array<u8 GCPadStatus::*>({
+    &GCPadStatus::analogA,
+    &GCPadStatus::analogB,
+    &GCPadStatus::stickX,
+    &GCPadStatus::stickY,
+    &GCPadStatus::substickX,
+    &GCPadStatus::substickY,
+    &GCPadStatus::triggerLeft,
+    &GCPadStatus::triggerRight,
+});
+constexpr u16 PAD_FIRST_AXIS = 1 << 2;
+constexpr u16 PAD_NUMBER = PAD_FIRST_AXIS << PAD_AXES.size();
+constexpr u16 PAD_ALL_FIELDS = (PAD_NUMBER << 1) - 1;
+
+using WiimoteState = WiimoteEmu::SerializedWiimoteState;
+static_assert(std::tuple_size_v<decltype(WiimoteState::data)> <= 32);
+}  // namespace
+
+void InputDeltaState::Reset()
+{
+  m_pads.fill(GCPadStatus{});
+  m_next_pad_numbers.fill(0);
+  m_wiimotes.fill(WiimoteState{});
+}
+
+void InputDeltaState::WritePad(size_t slot, u32 number, const GCPadStatus& pad,
+                               sf::Packet& packet)
+{
+  GCPadStatus& previous = m_pads[slot];
+
+  u16 mask = 0;
+  if (pad.button != previous.button)
+    mask |= PAD_BUTTON;
+  if (pad.isConnected != previous.isConnected)
+    mask |= PAD_IS_CONNECTED;
+  for (size_t i = 0; i < PAD_AXES.size(); ++i)
+  {
+    if (pad.*PAD_AXES[i] != previous.*PAD_AXES[i])
+      mask |= PAD_FIRST_AXIS << i;
+  }
+  if (number != m_next_pad_numbers[slot])
+    mask |= PAD_NUMBER;
+
+  packet << mask;
+  if (mask & PAD_BUTTON)
+    packet << pad.button;
+  if (mask & PAD_IS_CONNECTED)
+    packet << pad.isConnected;
+  for (size_t i = 0; i < PAD_AXES.size(); ++i)
+  {
+    if (mask & (PAD_FIRST_AXIS << i))
+      packet << pad.*PAD_AXES[i];
+  }
+  if (mask & PAD_NUMBER)
+    packet << number;
+
+  previous = pad;
+  m_next_pad_numbers[slot] = number + 1;
+}
+
+bool InputDeltaState::ReadPad(size_t slot, sf::Packet& packet, u32* number, GCPadStatus* pad)
+{
+  if (slot >= m_pads.size())
+    return false;
+
+  u16 mask;
+  packet >> mask;
+  if (!packet || (mask & ~PAD_ALL_FIELDS) != 0)
+    return false;
+
+  GCPadStatus current = m_pads[slot];
+  if (mask & PAD_BUTTON)
+    packet >> current.button;
+  if (mask & PAD_IS_CONNECTED)
+    packet >> current.isConnected;
+  for (size_t i = 0; i < PAD_AXES.size(); ++i)
+  {
+    if (mask & (PAD_FIRST_AXIS << i))
+      packet >> current.*PAD_AXES[i];
+  }
+  u32 current_number = m_next_pad_numbers[slot];
+  if (mask & PAD_NUMBER)
+    packet >> current_number;
+  if (!packet)
+    return false;
+
+  m_pads[slot] = current;
+  m_next_pad_numbers[slot] = current_number + 1;
+  *number = current_number;
+  *pad = current;
+  return true;
+}
+
+void InputDeltaState::WriteWiimote(size_t slot, const WiimoteState& state, sf::Packet& packet)
+{
+  WiimoteState& previous = m_wiimotes[slot];
+
+  packet << state.length;
+  if (state.length != 0)
+  {
+    u32 mask = 0;
+    for (size_t i = 0; i < state.length; ++i)
+    {
+      if (state.data[i] != previous.data[i])
+        mask |= 1u << i;
+    }
+
+    packet << mask;
+    for (size_t i = 0; i < state.length; ++i)
+    {
+      if (mask & (1u << i))
+        packet << state.data[i];
+    }
+  }
+
+  previous.length = state.length;
+  std::copy_n(state.data.begin(), state.length, previous.data.begin());
+}
+
+bool InputDeltaState::ReadWiimote(size_t slot, sf::Packet& packet, WiimoteState* state)
+{
+  if (slot >= m_wiimotes.size())
+    return false;
+
+  WiimoteState current = m_wiimotes[slot];
+  packet >> current.length;
+  if (!packet || current.length > current.data.size())
+    return false;
+
+  if (current.length != 0)
+  {
+    u32 mask;
+    packet >> mask;
+    if (!packet || (mask >> current.length) != 0)
+      return false;
+
+    for (size_t i = 0; i < current.length; ++i)
+    {
+      if (mask & (1u << i))
+        packet >> current.data[i];
+    }
+    if (!packet)
+      return false;
+  }
+
+  m_wiimotes[slot] = current;
+  *state = current;
+  return true;
+}
+}  // namespace NetPlay
@@ -0,0 +1,58 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+
+#include "Common/CommonTypes.h"
+#include "Core/HW/WiimoteEmu/DesiredWiimoteState.h"
+#include "InputCommon/GCPadStatus.h"
+
+namespace sf
+{
+class Packet;
+}
+
+namespace NetPlay
+{
+// Pad and Wiimote states are sent as only the fields that changed since the previous state sent
+// for the same slot on the same stream. Both ends of a stream keep an InputDeltaState, and must
+// reset it at the same point of the stream, which is the start of a game.
+//
+// Pads also carry the number that the client which polled them gave them, counting up from 0 per
+// pad. It costs nothing as long as it is one more than the previous one sent for the slot.
+class InputDeltaState
+{
+public:
+  void Reset();
+
+  void WritePad(size_t slot, u32 number, const GCPadStatus& pad, sf::Packet& packet);
+  // Returns false if the slot is out of range or the data is malformed.
+  bool ReadPad(size_t slot, sf::Packet& packet, u32* number, GCPadStatus* pad);
+
+  void WriteWiimote(size_t slot, const WiimoteEmu::SerializedWiimoteState& state,
+                    sf::Packet& packet);
+  bool ReadWiimote(size_t slot, sf::Packet& packet, WiimoteEmu::SerializedWiimoteState* state);
+
+private:
+  std::array<GCPadStatus, 4> m_pads{};
+  std::array<u32, 4> m_next_pad_numbers{};
+  std::array<WiimoteEmu::SerializedWiimoteState, 4> m_wiimotes{};
+};
+
+// The streams of one direction of a connection, one per message type
+struct InputDeltaStreams
+{
+  void Reset()
+  {
+    pad_data.Reset();
+    pad_host_data.Reset();
+    wiimote_data.Reset();
+  }
+
+  InputDeltaState pad_data;
+  InputDeltaState pad_host_data;
+  InputDeltaState wiimote_data;
+};
+}  // namespace NetPlay
@@ -0,0 +1,242 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/NetPlayLinkSimulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "Common/Logging/Log.h"
+#include "Common/Thread.h"
+
+namespace NetPlay
+{
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// ENet never sends datagrams larger than its maximum MTU.
+constexpr size_t MAX_DATAGRAM_SIZE = 4096;
+// Upper bound for how long the relay thread sleeps, so that it notices shutdown promptly.
+constexpr auto MAX_WAIT = std::chrono::milliseconds(10);
+
+struct Datagram
+{
+  Clock::time_point due;
+  u64 sequence;
+  ENetSocket socket;
+  ENetAddress destination;
+  std::vector<u8> data;
+};
+
+// Orders the priority queue so that the datagram due first is on top. Datagrams due at the same
+// time keep the order they were received in.
+struct DueLater
+{
+  bool operator()(const Datagram& a, const Datagram& b) const
+  {
+    return a.due != b.due ? a.due > b.due : a.sequence > b.sequence;
+  }
+};
+
+struct Peer
+{
+  ENetAddress address;
+  ENetSocket socket;
+};
+
+u64 GetAddressKey(const ENetAddress& address)
+{
+  return (u64(address.host) << 16) | address.port;
+}
+
+ENetSocket CreateSocket(const ENetAddress& address)
+{
+  const ENetSocket socket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+  if (socket == ENET_SOCKET_NULL)
+    return ENET_SOCKET_NULL;
+
+  if (enet_socket_set_option(socket, ENET_SOCKOPT_NONBLOCK, 1) != 0 ||
+      enet_socket_bind(socket, &address) != 0)
+  {
+    enet_socket_destroy(socket);
+    return ENET_SOCKET_NULL;
+  }
+
+  return socket;
+}
+}  // namespace
+
+LinkSimulator::LinkSimulator(const ENetAddress& target, const LinkConditions& conditions,
+                             u32 seed)
+    : m_target(target), m_conditions(conditions)
+{
+  ENetAddress address;
+  address.host = 0x0100007f;  // localhost
+  address.port = ENET_PORT_ANY;
+  m_socket = CreateSocket(address);
+  if (m_socket == ENET_SOCKET_NULL || enet_socket_get_address(m_socket, &address) != 0)
+  {
+    ERROR_LOG_FMT(NETPLAY, "Could not create the simulated link socket.");
+    if (m_socket != ENET_SOCKET_NULL)
+      enet_socket_destroy(m_socket);
+    m_socket = ENET_SOCKET_NULL;
+    return;
+  }
+  m_port = address.port;
+
+  INFO_LOG_FMT(NETPLAY, "Simulating a link with {} ms RTT, {} ms jitter and {}% loss on port {}",
+               m_conditions.rtt_ms, m_conditions.jitter_ms, m_conditions.loss * 100, m_port);
+
+  m_running.store(true);
+  m_thread = std::thread(&LinkSimulator::ThreadFunc, this, seed);
+}
+
+LinkSimulator::~LinkSimulator()
+{
+  m_running.store(false);
+  if (m_thread.joinable())
+    m_thread.join();
+
+  if (m_socket != ENET_SOCKET_NULL)
+    enet_socket_destroy(m_socket);
+}
+
+LinkStats LinkSimulator::GetUpstreamStats() const
+{
+  std::lock_guard lk(m_stats_lock);
+  return m_upstream_stats;
+}
+
+LinkStats LinkSimulator::GetDownstreamStats() const
+{
+  std::lock_guard lk(m_stats_lock);
+  return m_downstream_stats;
+}
+
+void LinkSimulator::ThreadFunc(u32 seed)
+{
+  Common::SetCurrentThreadName("NetPlay Link Simulator");
+
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> loss_distribution(0.0, 1.0);
+  std::uniform_int_distribution<u32> jitter_distribution(0, m_conditions.jitter_ms);
+  const auto one_way_delay = std::chrono::microseconds(u64(m_conditions.rtt_ms) * 500);
+
+  std::map<u64, Peer> peers;
+  std::priority_queue<Datagram, std::vector<Datagram>, DueLater> queue;
+  u64 sequence = 0;
+  std::vector<u8> buffer(MAX_DATAGRAM_SIZE);
+
+  const auto enqueue = [&](ENetSocket socket, const ENetAddress& destination, size_t size,
+                           LinkStats* stats) {
+    if (m_conditions.loss > 0.0 && loss_distribution(rng) < m_conditions.loss)
+    {
+      std::lock_guard lk(m_stats_lock);
+      ++stats->datagrams_dropped;
+      return;
+    }
+
+    const auto delay = one_way_delay + std::chrono::milliseconds(jitter_distribution(rng));
+    queue.push({Clock::now() + delay, sequence++, socket, destination,
+                std::vector<u8>(buffer.begin(), buffer.begin() + size)});
+  };
+
+  const auto receive = [&](ENetSocket socket, ENetAddress* source) -> size_t {
+    ENetBuffer enet_buffer;
+    enet_buffer.data = buffer.data();
+    enet_buffer.dataLength = buffer.size();
+    const int size = enet_socket_receive(socket, source, &enet_buffer, 1);
+    return size > 0 ? size_t(size) : 0;
+  };
+
+  while (m_running.load())
+  {
+    // Send everything that is due
+    const Clock::time_point now = Clock::now();
+    while (!queue.empty() && queue.top().due <= now)
+    {
+      const Datagram& datagram = queue.top();
+      {
+        std::lock_guard lk(m_stats_lock);
+        LinkStats& stats = datagram.socket == m_socket ? m_downstream_stats : m_upstream_stats;
+        ++stats.datagrams_forwarded;
+        stats.bytes_forwarded += datagram.data.size();
+      }
+
+      ENetBuffer enet_buffer;
+      enet_buffer.data = const_cast<u8*>(datagram.data.data());
+      enet_buffer.dataLength = datagram.data.size();
+      enet_socket_send(datagram.socket, &datagram.destination, &enet_buffer, 1);
+      queue.pop();
+    }
+
+    // Wait for incoming datagrams, or until the next datagram is due
+    auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(MAX_WAIT);
+    if (!queue.empty())
+    {
+      timeout = std::min(timeout, std::chrono::ceil<std::chrono::milliseconds>(
+                                      queue.top().due - Clock::now()));
+      timeout = std::max(timeout, std::chrono::milliseconds(0));
+    }
+
+    ENetSocketSet read_set;
+    ENET_SOCKETSET_EMPTY(read_set);
+    ENET_SOCKETSET_ADD(read_set, m_socket);
+    ENetSocket max_socket = m_socket;
+    for (const auto& [key, peer] : peers)
+    {
+      ENET_SOCKETSET_ADD(read_set, peer.socket);
+      max_socket = std::max(max_socket, peer.socket);
+    }
+    if (enet_socketset_select(max_socket, &read_set, nullptr, u32(timeout.count())) <= 0)
+      continue;
+
+    // Peers towards the target
+    if (ENET_SOCKETSET_CHECK(read_set, m_socket))
+    {
+      ENetAddress source;
+      while (const size_t size = receive(m_socket, &source))
+      {
+        auto it = peers.find(GetAddressKey(source));
+        if (it == peers.end())
+        {
+          ENetAddress any;
+          any.host = ENET_HOST_ANY;
+          any.port = ENET_PORT_ANY;
+          const ENetSocket socket = CreateSocket(any);
+          if (socket == ENET_SOCKET_NULL)
+          {
+            ERROR_LOG_FMT(NETPLAY, "Could not create a simulated link socket for a new peer.");
+            continue;
+          }
+          it = peers.emplace(GetAddressKey(source), Peer{source, socket}).first;
+        }
+
+        enqueue(it->second.socket, m_target, size, &m_upstream_stats);
+      }
+    }
+
+    // Target towards the peers
+    for (const auto& [key, peer] : peers)
+    {
+      if (!ENET_SOCKETSET_CHECK(read_set, peer.socket))
+        continue;
+
+      ENetAddress source;
+      while (const size_t size = receive(peer.socket, &source))
+      {
+        if (GetAddressKey(source) == GetAddressKey(m_target))
+          enqueue(m_socket, peer.address, size, &m_downstream_stats);
+      }
+    }
+  }
+
+  for (const auto& [key, peer] : peers)
+    enet_socket_destroy(peer.socket);
+}
+}  // namespace NetPlay
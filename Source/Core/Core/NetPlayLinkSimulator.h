@@ -0,0 +1,72 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include <enet/enet.h>
+
+#include "Common/CommonTypes.h"
+
+namespace NetPlay
+{
+struct LinkConditions
+{
+  // Round trip time added to the link, split evenly between both directions.
+  u32 rtt_ms = 0;
+  // Upper bound of a random delay added to each datagram on top of the round trip time.
+  u32 jitter_ms = 0;
+  // Probability of each datagram being dropped, in either direction.
+  double loss = 0.0;
+
+  bool IsIdeal() const { return rtt_ms == 0 && jitter_ms == 0 && loss <= 0.0; }
+};
+
+struct LinkStats
+{
+  u64 datagrams_forwarded = 0;
+  u64 bytes_forwarded = 0;
+  u64 datagrams_dropped = 0;
+};
+
+// A UDP relay that listens on a loopback port and forwards every datagram to a target address and
+// the replies back, delaying and dropping them according to the given conditions. ENet peers that
+// connect to the relay instead of the target see a link with that latency and loss, which allows
+// reproducing NetPlay behaviour on a single machine. Any number of peers can share one relay; each
+// gets its own socket towards the target, so the target sees them as separate peers.
+class LinkSimulator
+{
+public:
+  LinkSimulator(const ENetAddress& target, const LinkConditions& conditions, u32 seed);
+  ~LinkSimulator();
+
+  LinkSimulator(const LinkSimulator&) = delete;
+  LinkSimulator& operator=(const LinkSimulator&) = delete;
+
+  bool IsValid() const { return m_socket != ENET_SOCKET_NULL; }
+  // The loopback port to connect to instead of the target.
+  u16 GetPort() const { return m_port; }
+
+  // Datagrams sent towards the target and towards the connected peers.
+  LinkStats GetUpstreamStats() const;
+  LinkStats GetDownstreamStats() const;
+
+private:
+  void ThreadFunc(u32 seed);
+
+  ENetAddress m_target;
+  LinkConditions m_conditions;
+  ENetSocket m_socket = ENET_SOCKET_NULL;
+  u16 m_port = 0;
+
+  mutable std::mutex m_stats_lock;
+  LinkStats m_upstream_stats;
+  LinkStats m_downstream_stats;
+
+  std::atomic<bool> m_running{false};
+  std::thread m_thread;
+};
+}  // namespace NetPlay
@@ -0,0 +1,152 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/NetPlayMemoryHash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <fmt/format.h>
+#include <xxhash.h>
+
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+
+namespace NetPlay
+{
+MemoryHasher::MemoryHasher(Core::System& system, u32 frames_per_cycle,
+                           std::function<void(Slice)> on_hashed)
+    : m_system(system), m_frames_per_cycle(std::max<u32>(frames_per_cycle, 1)),
+      m_on_hashed(std::move(on_hashed))
+{
+  m_worker.Reset("NetPlay Memory Hash", [this](HashWork work) { HashPages(std::move(work)); });
+}
+
+MemoryHasher::~MemoryHasher()
+{
+  m_worker.Shutdown();
+}
+
+std::vector<MemoryHasher::Region> MemoryHasher::GetRegions() const
+{
+  auto& memory = m_system.GetMemory();
+
+  std::vector<Region> regions;
+  regions.push_back({"MEM1", 0x80000000, memory.GetRAM(), memory.GetRamSizeReal()});
+  if (m_system.IsWii())
+    regions.push_back({"MEM2", 0x90000000, memory.GetEXRAM(), memory.GetExRamSizeReal()});
+  regions.push_back({"CPU registers", 0, m_cpu_state.data(), static_cast<u32>(m_cpu_state.size())});
+  return regions;
+}
+
+void MemoryHasher::CaptureCPUState()
+{
+  const auto& ppc_state = m_system.GetPPCState();
+
+  m_cpu_state.clear();
+  const auto append = [this](const auto& value) {
+    const auto* bytes = reinterpret_cast<const u8*>(&value);
+    m_cpu_state.insert(m_cpu_state.end(), bytes, bytes + sizeof(value));
+  };
+
+  append(ppc_state.pc);
+  for (u32 gpr : ppc_state.gpr)
+    append(gpr);
+  for (const PowerPC::PairedSingle& ps : ppc_state.ps)
+  {
+    append(ps.PS0AsU64());
+    append(ps.PS1AsU64());
+  }
+  append(ppc_state.cr.Get());
+  append(ppc_state.msr.Hex);
+  append(ppc_state.fpscr.Hex);
+  append(ppc_state.xer_ca);
+  append(ppc_state.xer_so_ov);
+}
+
+void MemoryHasher::OnFrame(u32 frame)
+{
+  CaptureCPUState();
+
+  const std::vector<Region> regions = GetRegions();
+  u32 total_pages = 0;
+  for (const Region& region : regions)
+    total_pages += (region.size + PAGE_SIZE - 1) / PAGE_SIZE;
+
+  const u32 pages_per_frame = (total_pages + m_frames_per_cycle - 1) / m_frames_per_cycle;
+  const u32 first_page = (frame % m_frames_per_cycle) * pages_per_frame;
+  if (first_page >= total_pages)
+    return;
+  const u32 end_page = std::min(first_page + pages_per_frame, total_pages);
+
+  HashWork work{frame, first_page, {}, {}};
+  {
+    std::lock_guard lk(m_free_buffers_lock);
+    if (!m_free_buffers.empty())
+    {
+      work.data = std::move(m_free_buffers.back());
+      m_free_buffers.pop_back();
+    }
+  }
+  work.data.clear();
+  work.data.reserve(size_t(pages_per_frame) * PAGE_SIZE);
+
+  u32 region_first_page = 0;
+  for (const Region& region : regions)
+  {
+    const u32 region_pages = (region.size + PAGE_SIZE - 1) / PAGE_SIZE;
+    const u32 begin = std::max(first_page, region_first_page);
+    const u32 end = std::min(end_page, region_first_page + region_pages);
+    for (u32 page = begin; page < end; ++page)
+    {
+      const u32 offset = (page - region_first_page) * PAGE_SIZE;
+      const u32 size = std::min(PAGE_SIZE, region.size - offset);
+      work.data.insert(work.data.end(), region.data + offset, region.data + offset + size);
+      work.page_sizes.push_back(size);
+    }
+    region_first_page += region_pages;
+  }
+
+  m_worker.Push(std::move(work));
+}
+
+void MemoryHasher::HashPages(HashWork work)
+{
+  Slice slice{work.frame, work.first_page, {}};
+  slice.hashes.reserve(work.page_sizes.size());
+
+  size_t offset = 0;
+  for (u32 size : work.page_sizes)
+  {
+    slice.hashes.push_back(XXH3_64bits(work.data.data() + offset, size));
+    offset += size;
+  }
+
+  {
+    std::lock_guard lk(m_free_buffers_lock);
+    m_free_buffers.push_back(std::move(work.data));
+  }
+
+  m_on_hashed(std::move(slice));
+}
+
+std::string MemoryHasher::DescribePage(u32 page) const
+{
+  for (const Region& region : GetRegions())
+  {
+    const u32 region_pages = (region.size + PAGE_SIZE - 1) / PAGE_SIZE;
+    if (page < region_pages)
+    {
+      if (region.address == 0)
+        return region.name;
+      const u32 address = region.address + page * PAGE_SIZE;
+      return fmt::format("{} {:08x}-{:08x}", region.name, address,
+                         address + std::min(PAGE_SIZE, region.size - page * PAGE_SIZE) - 1);
+    }
+    page -= region_pages;
+  }
+  return fmt::format("unknown page {}", page);
+}
+}  // namespace NetPlay
@@ -0,0 +1,84 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/WorkQueueThread.h"
+
+namespace Core
+{
+class System;
+}
+
+namespace NetPlay
+{
+// Hashes emulated memory and CPU registers in fixed-size pages, so that players can compare them
+// and pinpoint the first frame and page at which a desync happened. A slice of the pages is copied
+// on the CPU thread every frame and hashed on a worker thread, so that all pages are covered once
+// every frames_per_cycle frames while each frame only pays for a small copy.
+class MemoryHasher
+{
+public:
+  static constexpr u32 PAGE_SIZE = 64 * 1024;
+
+  struct Slice
+  {
+    u32 frame;
+    u32 first_page;
+    std::vector<u64> hashes;
+  };
+
+  // on_hashed is called on the worker thread.
+  MemoryHasher(Core::System& system, u32 frames_per_cycle,
+               std::function<void(Slice)> on_hashed);
+  ~MemoryHasher();
+
+  MemoryHasher(const MemoryHasher&) = delete;
+  MemoryHasher& operator=(const MemoryHasher&) = delete;
+
+  // Called on the CPU thread once per frame, with a frame number that counts up from 0.
+  void OnFrame(u32 frame);
+
+  // Names the region and address of a page, for reporting a desync.
+  std::string DescribePage(u32 page) const;
+
+private:
+  struct Region
+  {
+    const char* name;
+    u32 address;
+    const u8* data;
+    u32 size;
+  };
+
+  struct HashWork
+  {
+    u32 frame;
+    u32 first_page;
+    std::vector<u8> data;
+    std::vector<u32> page_sizes;
+  };
+
+  std::vector<Region> GetRegions() const;
+  void CaptureCPUState();
+  void HashPages(HashWork work);
+
+  Core::System& m_system;
+  u32 m_frames_per_cycle;
+  std::function<void(Slice)> m_on_hashed;
+
+  std::vector<u8> m_cpu_state;
+
+  // Copy buffers handed back by the worker thread, so the CPU thread doesn't allocate every frame
+  std::mutex m_free_buffers_lock;
+  std::vector<std::vector<u8>> m_free_buffers;
+
+  Common::WorkQueueThread<HashWork> m_worker;
+};
+}  // namespace NetPlay
@@ -106,8 +106,17 @@ struct NetSettings
   bool sync_codes = false;
   std::string save_data_region;
   bool golf_mode = false;
+  bool rollback = false;
+  // Host input authority, where clients apply their own inputs right away and re-simulate once the
+  // host's inputs arrive
+  bool host_input_prediction = false;
   bool use_fma = false;
   bool hide_remote_gbas = false;
+  // Number of frames over which all of memory is hashed for desync detection, 0 if disabled
+  u32 memory_hash_frames = 0;
+  // Number of frames between the savestates the host sends for spectators joining mid-game, 0 if
+  // joining mid-game is disabled
+  u32 spectator_keyframe_frames = 0;
 
   Sram sram;
 
@@ -153,6 +162,7 @@ enum class MessageID : u8
   PadBuffer = 0x62,
   PadHostData = 0x63,
   GBAConfig = 0x64,
+  PadBufferStats = 0x65,
 
   WiimoteData = 0x70,
   WiimoteMapping = 0x71,
@@ -171,9 +181,12 @@ enum class MessageID : u8
   ClientCapabilities = 0xA5,
   HostInputAuthority = 0xA6,
   PowerButton = 0xA7,
+  SpectatorKeyframe = 0xA8,
 
   TimeBase = 0xB0,
   DesyncDetected = 0xB1,
+  MemoryHashes = 0xB2,
+  MemoryDesyncDetected = 0xB3,
 
   ComputeGameDigest = 0xC0,
   GameDigestProgress = 0xC1,
@@ -212,7 +225,8 @@ enum class SyncSaveDataID : u8
   RawData = 3,
   GCIData = 4,
   WiiData = 5,
-  GBAData = 6
+  GBAData = 6,
+  CachedBlocks = 7
 };
 
 enum class SyncCodeID : u8
@@ -228,6 +242,7 @@ enum class SyncCodeID : u8
 
 constexpr u32 MAX_NAME_LENGTH = 30;
 constexpr size_t CHUNKED_DATA_UNIT_SIZE = 16384;
+constexpr u32 MAX_CACHED_SAVE_BLOCKS = 65536;
 constexpr u32 MAX_ENET_MTU = 1392;  // see https://github.com/lsalzman/enet/issues/132
 
 enum : u8
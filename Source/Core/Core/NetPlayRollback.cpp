@@ -0,0 +1,224 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/NetPlayRollback.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace NetPlay
+{
+RollbackFrame& SaveStateArray::New(u64 frame)
+{
+  m_head = (m_head + 1) % m_frames.size();
+  RollbackFrame& entry = m_frames[m_head];
+  entry.frame = frame;
+  entry.valid = true;
+  entry.state_size = 0;
+  entry.predicted.fill(false);
+  return entry;
+}
+
+RollbackFrame* SaveStateArray::Find(u64 frame)
+{
+  for (RollbackFrame& entry : m_frames)
+  {
+    if (entry.valid && entry.frame == frame)
+      return &entry;
+  }
+  return nullptr;
+}
+
+RollbackFrame* SaveStateArray::OldestPredicted()
+{
+  RollbackFrame* oldest = nullptr;
+  for (RollbackFrame& entry : m_frames)
+  {
+    if (!entry.valid || std::ranges::none_of(entry.predicted, std::identity{}))
+      continue;
+    if (!oldest || entry.frame < oldest->frame)
+      oldest = &entry;
+  }
+  return oldest;
+}
+
+void SaveStateArray::reset()
+{
+  // Keep the state buffers around, only forget what they contain.
+  for (RollbackFrame& entry : m_frames)
+    entry.valid = false;
+  m_head = 0;
+}
+
+void RollbackTimeline::Reset()
+{
+  m_frames.reset();
+  m_pads.fill(RollbackPad::Unused);
+  m_last_confirmed.fill(GCPadStatus{});
+  for (auto& inputs : m_local_inputs)
+    inputs.clear();
+  m_local_input_delay.fill(0);
+  m_confirmed_frames.fill(0);
+  for (auto& inputs : m_early_inputs)
+    inputs.clear();
+  m_mispredicted_frame.reset();
+  m_frame = 0;
+  m_new_frame = 0;
+}
+
+void RollbackTimeline::SetPad(size_t pad, RollbackPad mode)
+{
+  m_pads[pad] = mode;
+}
+
+void RollbackTimeline::AddLocalInput(size_t pad, u32 number, const GCPadStatus& input)
+{
+  auto& inputs = m_local_inputs[pad];
+  inputs.push_back({number, m_frame, input});
+  if (inputs.size() > rollback_local_inputs_kept)
+    inputs.pop_front();
+}
+
+void RollbackTimeline::AddInput(size_t pad, const GCPadStatus& input, u32 number)
+{
+  const u64 frame = m_confirmed_frames[pad]++;
+  m_last_confirmed[pad] = input;
+
+  if (m_pads[pad] == RollbackPad::SpeculativeLocal)
+  {
+    // The host applies the last input it got from us, which is a few frames old by then.
+    const auto& inputs = m_local_inputs[pad];
+    const auto it = std::ranges::find(inputs, number, &LocalInput::number);
+    if (it != inputs.end())
+      m_local_input_delay[pad] = frame > it->frame ? frame - it->frame : 0;
+  }
+
+  if (frame >= m_new_frame)
+  {
+    m_early_inputs[pad].push_back(input);
+    return;
+  }
+
+  // BeginFrame never lets a frame with a predicted input fall out of the ring.
+  RollbackFrame* entry = m_frames.Find(frame);
+  if (!entry || !entry->predicted[pad])
+    return;
+
+  entry->predicted[pad] = false;
+  if (entry->inputs[pad] == input)
+    return;
+
+  entry->inputs[pad] = input;
+
+  // Frames we haven't (re-)simulated yet will simply pick up the corrected input.
+  if (frame < m_frame && (!m_mispredicted_frame || frame < *m_mispredicted_frame))
+    m_mispredicted_frame = frame;
+}
+
+bool RollbackTimeline::CanRollBackTo(u64 frame) const
+{
+  // Rolling back needs the state of the frame before, which has to stay in the ring once the
+  // next frame has begun.
+  return frame > 0 && m_frame - (frame - 1) < rollback_frames_supported;
+}
+
+GCPadStatus RollbackTimeline::Predict(size_t pad, u64 frame) const
+{
+  if (m_pads[pad] != RollbackPad::SpeculativeLocal || frame < m_local_input_delay[pad])
+    return m_last_confirmed[pad];
+
+  // Expect the host to keep applying our inputs as late as it did last time.
+  const u64 polled_frame = frame - m_local_input_delay[pad];
+  const auto& inputs = m_local_inputs[pad];
+  const auto it = std::find_if(inputs.rbegin(), inputs.rend(), [&](const LocalInput& local) {
+    return local.frame <= polled_frame;
+  });
+  return it != inputs.rend() ? it->input : m_last_confirmed[pad];
+}
+
+RollbackFrame* RollbackTimeline::BeginFrame()
+{
+  if (IsResimulating())
+  {
+    RollbackFrame* entry = m_frames.Find(m_frame);
+    if (entry)
+    {
+      // Remaining predictions are refreshed with what is known by now.
+      for (size_t pad = 0; pad < entry->inputs.size(); ++pad)
+      {
+        if (entry->predicted[pad])
+          entry->inputs[pad] = Predict(pad, m_frame);
+      }
+
+      ++m_frame;
+      return entry;
+    }
+
+    // Can't happen unless the ring was reset under us; give up on the replay.
+    m_frame = m_new_frame;
+  }
+
+  bool needs_prediction = false;
+  for (size_t pad = 0; pad < m_pads.size(); ++pad)
+    needs_prediction |= m_pads[pad] != RollbackPad::Unused && m_early_inputs[pad].empty();
+
+  // Never predict further ahead than we are able to roll back. The caller stalls like fixed delay
+  // mode does until the inputs of the oldest unconfirmed frame arrive.
+  const RollbackFrame* oldest = m_frames.OldestPredicted();
+  if ((oldest || needs_prediction) && !CanRollBackTo(oldest ? oldest->frame : m_frame))
+    return nullptr;
+
+  RollbackFrame& entry = m_frames.New(m_frame);
+  for (size_t pad = 0; pad < entry.inputs.size(); ++pad)
+  {
+    if (m_pads[pad] == RollbackPad::Unused)
+    {
+      entry.inputs[pad] = GCPadStatus{};
+    }
+    else if (!m_early_inputs[pad].empty())
+    {
+      entry.inputs[pad] = m_early_inputs[pad].front();
+      m_early_inputs[pad].pop_front();
+    }
+    else
+    {
+      entry.inputs[pad] = Predict(pad, m_frame);
+      entry.predicted[pad] = true;
+    }
+  }
+
+  m_new_frame = ++m_frame;
+  return &entry;
+}
+
+bool RollbackTimeline::IsRollbackPending() const
+{
+  return m_mispredicted_frame.has_value();
+}
+
+RollbackFrame* RollbackTimeline::TakeRollback()
+{
+  if (!m_mispredicted_frame)
+    return nullptr;
+
+  const u64 frame = *m_mispredicted_frame;
+  m_mispredicted_frame.reset();
+
+  RollbackFrame* before = m_frames.Find(frame - 1);
+  if (!before || before->state_size == 0)
+    return nullptr;
+
+  m_frame = frame;
+  return before;
+}
+
+bool RollbackTimeline::IsResimulating() const
+{
+  return m_frame < m_new_frame;
+}
+
+u64 RollbackTimeline::GetFrame() const
+{
+  return m_frame;
+}
+}  // namespace NetPlay
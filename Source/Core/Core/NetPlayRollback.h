@@ -0,0 +1,128 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <optional>
+
+#include "Common/Buffer.h"
+#include "Common/CommonTypes.h"
+#include "InputCommon/GCPadStatus.h"
+
+namespace NetPlay
+{
+constexpr int rollback_frames_supported = 10;
+// How many of our own inputs are kept to predict what the host applies. It has to cover the round
+// trip to the host, in frames.
+constexpr size_t rollback_local_inputs_kept = 120;
+using SaveState = Common::UniqueBuffer<u8>;
+
+// One emulated frame worth of rollback data: the GC pad inputs that were fed to the game for the
+// frame's batched pad poll, and the state right after that poll. Rolling back to a frame means
+// loading the state of the frame before it and polling again.
+struct RollbackFrame
+{
+  u64 frame = 0;
+  bool valid = false;
+  SaveState state;
+  // The state buffer can be bigger than the state itself. 0 until a state has been saved.
+  size_t state_size = 0;
+  std::array<GCPadStatus, 4> inputs{};
+  // Pads whose input for this frame was predicted and has not yet been confirmed by the remote.
+  std::array<bool, 4> predicted{};
+};
+
+// Fixed ring of rollback frames. The savestate buffers are allocated once and reused, so taking a
+// snapshot every frame does not allocate once the ring has warmed up.
+class SaveStateArray
+{
+public:
+  RollbackFrame& New(u64 frame);
+  RollbackFrame* Find(u64 frame);
+  // Returns the oldest frame that still has a predicted input, or nullptr if all are confirmed.
+  RollbackFrame* OldestPredicted();
+  void reset();
+
+private:
+  std::array<RollbackFrame, rollback_frames_supported> m_frames;
+  size_t m_head = 0;
+};
+
+enum class RollbackPad
+{
+  // Not mapped to anyone, always reads as its default state
+  Unused,
+  // Takes the inputs received for it in order, one per frame. Until they arrive, it's predicted
+  // to keep the last input that was received.
+  Remote,
+  // Our own pad when the host has authority over the inputs. Like Remote, but predicted with what
+  // we pressed, as added with AddLocalInput, rather than with the last input that was received.
+  SpeculativeLocal,
+};
+
+// Decides which inputs every frame is simulated with, and when the game has to be rolled back
+// because a prediction turned out wrong. It never touches the emulated state itself: whoever owns
+// it saves the state into every frame returned by BeginFrame once the frame's poll is done, and
+// loads the state that TakeRollback returns before the next poll.
+class RollbackTimeline
+{
+public:
+  void Reset();
+
+  void SetPad(size_t pad, RollbackPad mode);
+  // Records an input we polled for a pad of ours, and the number it was sent to the host with. It
+  // belongs to the frame that the next BeginFrame starts.
+  void AddLocalInput(size_t pad, u32 number, const GCPadStatus& input);
+
+  // Hands over the next input received for a pad. Inputs arrive in the order they were sent, one
+  // per frame, so this pairs it with the oldest frame of the pad that hasn't had one yet. number is
+  // what its owner numbered it with.
+  void AddInput(size_t pad, const GCPadStatus& input, u32 number = 0);
+
+  // Starts the next frame and picks its inputs. Returns nullptr if an input is missing, but
+  // predicting it would go further ahead than we are able to roll back. In that case, wait for
+  // more inputs to arrive and try again.
+  RollbackFrame* BeginFrame();
+
+  // Whether a prediction has been found to be wrong, so TakeRollback has a frame to load.
+  bool IsRollbackPending() const;
+  // Rewinds the timeline to the oldest mispredicted frame, which the next BeginFrame re-simulates,
+  // and returns the frame before it, whose state has to be loaded for that. Returns nullptr if
+  // there's nothing to roll back.
+  RollbackFrame* TakeRollback();
+
+  // Whether the next BeginFrame re-simulates a frame after a rollback
+  bool IsResimulating() const;
+  // The frame the next BeginFrame starts
+  u64 GetFrame() const;
+
+private:
+  struct LocalInput
+  {
+    u32 number;
+    u64 frame;
+    GCPadStatus input;
+  };
+
+  bool CanRollBackTo(u64 frame) const;
+  GCPadStatus Predict(size_t pad, u64 frame) const;
+
+  SaveStateArray m_frames;
+  std::array<RollbackPad, 4> m_pads{};
+  std::array<GCPadStatus, 4> m_last_confirmed{};
+  std::array<std::deque<LocalInput>, 4> m_local_inputs;
+  // How many frames later the host applies our inputs than we polled them, as last seen from the
+  // inputs it sent back
+  std::array<u64, 4> m_local_input_delay{};
+  // How many inputs each pad has had, which is the frame that the next one belongs to
+  std::array<u64, 4> m_confirmed_frames{};
+  // Inputs that arrived for frames that haven't begun yet
+  std::array<std::deque<GCPadStatus>, 4> m_early_inputs;
+  std::optional<u64> m_mispredicted_frame;
+  u64 m_frame = 0;
+  // The first frame that hasn't begun yet. The frames from m_frame up to it are re-simulated.
+  u64 m_new_frame = 0;
+};
+}  // namespace NetPlay
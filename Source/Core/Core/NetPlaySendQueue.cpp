@@ -0,0 +1,32 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/NetPlaySendQueue.h"
+
+#include <SFML/Network/Packet.hpp>
+
+#include "Core/NetPlayProto.h"
+
+namespace NetPlay
+{
+SendPriority GetSendPriority(const sf::Packet& packet, const u8 channel_id)
+{
+  if (channel_id == CHUNKED_DATA_CHANNEL)
+    return SendPriority::Bulk;
+
+  if (packet.getDataSize() == 0)
+    return SendPriority::Default;
+
+  switch (static_cast<MessageID>(static_cast<const u8*>(packet.getData())[0]))
+  {
+  case MessageID::PadData:
+  case MessageID::PadHostData:
+  case MessageID::WiimoteData:
+  // Starting a game resets the delta encoding of the inputs, so it must not be overtaken by them
+  case MessageID::StartGame:
+    return SendPriority::Input;
+  default:
+    return SendPriority::Default;
+  }
+}
+}  // namespace NetPlay
@@ -0,0 +1,100 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "Common/CommonTypes.h"
+#include "Common/MPSCQueue.h"
+
+namespace sf
+{
+class Packet;
+}
+
+namespace NetPlay
+{
+// Order in which queued packets are handed to ENet, highest first
+enum class SendPriority
+{
+  // Pad and Wii Remote inputs, which somebody may be waiting on right now
+  Input,
+  Default,
+  // Chunked data such as save transfers
+  Bulk,
+  Count,
+};
+
+SendPriority GetSendPriority(const sf::Packet& packet, u8 channel_id);
+
+// Bulk packets are held back while this much reliable data still waits to be acknowledged by a
+// peer. Anything ENet has queued is sent in order, so this bounds how long an input can be stuck
+// behind bulk data.
+constexpr u32 MAX_BULK_DATA_IN_TRANSIT = 32 * 1024;
+// How long the network thread waits for events while bulk packets are held back
+constexpr u32 BULK_DATA_POLL_INTERVAL_MS = 5;
+
+// Packets queued from any thread, to be sent from the network thread
+template <typename Entry>
+class SendQueue final
+{
+public:
+  void Push(SendPriority priority, Entry&& entry)
+  {
+    m_queues[static_cast<size_t>(priority)].Push(std::move(entry));
+  }
+
+  // The following are only safe from the network thread:
+  bool HasBulk() const { return !GetQueue(SendPriority::Bulk).Empty(); }
+
+  // Sends queued entries, highest priority first. Inputs and other packets queued in the meantime
+  // go out before the next bulk packet. can_send_bulk is asked before each bulk packet, and once
+  // it returns false the remaining bulk packets wait for a later call.
+  template <typename SendFunction, typename CanSendBulkFunction>
+  void Drain(SendFunction send, CanSendBulkFunction can_send_bulk)
+  {
+    auto& bulk = GetQueue(SendPriority::Bulk);
+    while (true)
+    {
+      SendAll(GetQueue(SendPriority::Input), send);
+      SendAll(GetQueue(SendPriority::Default), send);
+
+      if (bulk.Empty() || !can_send_bulk(bulk.Front()))
+        return;
+
+      send(bulk.Front());
+      bulk.Pop();
+    }
+  }
+
+  void Clear()
+  {
+    for (auto& queue : m_queues)
+      queue.Clear();
+  }
+
+private:
+  using Queue = Common::MPSCQueue<Entry>;
+
+  Queue& GetQueue(SendPriority priority) { return m_queues[static_cast<size_t>(priority)]; }
+  const Queue& GetQueue(SendPriority priority) const
+  {
+    return m_queues[static_cast<size_t>(priority)];
+  }
+
+  template <typename SendFunction>
+  static void SendAll(Queue& queue, SendFunction& send)
+  {
+    while (!queue.Empty())
+    {
+      send(queue.Front());
+      queue.Pop();
+    }
+  }
+
+  std::array<Queue, static_cast<size_t>(SendPriority::Count)> m_queues;
+};
+}  // namespace NetPlay
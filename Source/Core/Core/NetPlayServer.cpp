@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <cstdio>
 #include <memory>
@@ -273,6 +274,8 @@ void NetPlayServer::ThreadFunc()
       m_index.SetGame(m_selected_game_name);
       m_index.SetInGame(m_is_running);
 
+      UpdateAutoPadBufferSize();
+
       m_update_pings = false;
     }
 
@@ -280,27 +283,23 @@ void NetPlayServer::ThreadFunc()
     int net;
     if (m_traversal_client)
       m_traversal_client->HandleResends();
-    net = enet_host_service(m_server, &netEvent, 1000);
-    while (!m_async_queue.Empty())
-    {
-      INFO_LOG_FMT(NETPLAY, "Processing async queue event.");
-      {
-        std::lock_guard lkp(m_crit.players);
-        INFO_LOG_FMT(NETPLAY, "Locked player mutex.");
-        auto& e = m_async_queue.Front();
-        if (e.target_mode == TargetMode::Only)
-        {
-          if (m_players.contains(e.target_pid))
-            Send(m_players.at(e.target_pid).socket, e.packet, e.channel_id);
-        }
-        else
-        {
-          SendToClients(e.packet, e.target_pid, e.channel_id);
-        }
-      }
-      INFO_LOG_FMT(NETPLAY, "Processing async queue event done.");
-      m_async_queue.Pop();
-    }
+    // Check back soon if bulk data is waiting for a connection to drain
+    net = enet_host_service(m_server, &netEvent,
+                            m_async_queue.HasBulk() ? BULK_DATA_POLL_INTERVAL_MS : 1000);
+    m_async_queue.Drain(
+        [this](const AsyncQueueEntry& e) {
+          std::lock_guard lkp(m_crit.players);
+          if (e.target_mode == TargetMode::Only)
+          {
+            if (m_players.contains(e.target_pid))
+              Send(m_players.at(e.target_pid).socket, e.packet, e.channel_id);
+          }
+          else
+          {
+            SendToClients(e.packet, e.target_pid, e.channel_id);
+          }
+        },
+        [this](const AsyncQueueEntry& e) { return CanSendBulkData(e); });
     if (net > 0)
     {
       switch (netEvent.type)
@@ -445,7 +444,7 @@ ConnectionError NetPlayServer::OnConnect(ENetPeer* incoming_connection, sf::Pack
   //if (netplay_version != Common::GetScmRevGitStr())
   //  return ConnectionError::VersionMismatch;
 
-  if (m_is_running || m_start_pending)
+  if (m_start_pending || (m_is_running && !CanJoinMidGame()))
     return ConnectionError::GameRunning;
 
   if (m_players.size() >= 255)
@@ -454,6 +453,7 @@ ConnectionError NetPlayServer::OnConnect(ENetPeer* incoming_connection, sf::Pack
   Client new_player{};
   new_player.pid = GiveFirstAvailableIDTo(incoming_connection);
   new_player.socket = incoming_connection;
+  new_player.joined_mid_game = m_is_running;
 
   received_packet >> new_player.revision;
   received_packet >> new_player.name;
@@ -468,7 +468,9 @@ ConnectionError NetPlayServer::OnConnect(ENetPeer* incoming_connection, sf::Pack
   // force a ping on first netplay loop
   m_update_pings = true;
 
-  AssignNewUserAPad(new_player);
+  // pads can't change hands in the middle of a game, so players who join then only spectate
+  if (!new_player.joined_mid_game)
+    AssignNewUserAPad(new_player);
 
   // tell other players a new player joined
   SendResponseToAllPlayers(MessageID::PlayerJoin, new_player.pid, new_player.name,
@@ -504,6 +506,7 @@ ConnectionError NetPlayServer::OnConnect(ENetPeer* incoming_connection, sf::Pack
   if (Config::Get(Config::NETPLAY_ENABLE_QOS))
     new_player.qos_session = Common::QoSSession(new_player.socket);
 
+  const PlayerId pid = new_player.pid;
   {
     std::lock_guard lkp(m_crit.players);
     // add new player to list of players
@@ -514,6 +517,9 @@ ConnectionError NetPlayServer::OnConnect(ENetPeer* incoming_connection, sf::Pack
     UpdateWiimoteMapping();
   }
 
+  if (m_is_running)
+    SendMidGameJoin(m_players.at(pid));
+
   return ConnectionError::NoError;
 }
 
@@ -691,6 +697,195 @@ void NetPlayServer::AdjustPadBufferSize(unsigned int size)
   }
 }
 
+// called from ---NETPLAY--- thread
+// Each client gets its own packet, as the pads are encoded against what it was last sent
+void NetPlayServer::SendPadData(MessageID message, std::span<const PadInput> pads, Client& client)
+{
+  InputDeltaState& stream = message == MessageID::PadHostData ?
+                                client.input_to_client.pad_host_data :
+                                client.input_to_client.pad_data;
+
+  sf::Packet spac;
+  spac << message;
+  for (const auto& [map, number, pad] : pads)
+  {
+    spac << map;
+    stream.WritePad(map, number, pad, spac);
+  }
+  Send(client.socket, spac);
+}
+
+// called from ---NETPLAY--- thread
+void NetPlayServer::LogSpectatorPads(std::span<const PadInput> pads)
+{
+  // Pads are polled about once per frame. If the host stops sending keyframes, keep enough input
+  // for a few of them and give up on mid-game joins until the next one.
+  const size_t max_entries = size_t(m_settings.spectator_keyframe_frames) * 4;
+  if (max_entries == 0)
+    return;
+
+  for (const PadInput& pad : pads)
+  {
+    SpectatorPadLog& log = m_spectator_pad_log[pad.map];
+    if (log.first_index + log.entries.size() < m_spectator_keyframe_pads[pad.map])
+    {
+      // already part of the keyframe
+      ++log.first_index;
+      continue;
+    }
+
+    log.entries.push_back(pad);
+    if (log.entries.size() > max_entries)
+    {
+      log.entries.pop_front();
+      ++log.first_index;
+      m_spectator_keyframe.clear();
+    }
+  }
+}
+
+bool NetPlayServer::CanJoinMidGame() const
+{
+  if (m_spectator_keyframe.getDataSize() == 0)
+    return false;
+
+  // Inputs the host used before taking the keyframe may still be on their way to us, in which case
+  // they would reach the new spectator after the keyframe. Joining works again a moment later.
+  for (size_t i = 0; i < m_spectator_pad_log.size(); ++i)
+  {
+    if (m_spectator_pad_log[i].first_index < m_spectator_keyframe_pads[i])
+      return false;
+  }
+
+  return true;
+}
+
+// called from ---NETPLAY--- thread
+void NetPlayServer::SendMidGameJoin(Client& client)
+{
+  INFO_LOG_FMT(NETPLAY, "Player {} joined mid-game, sending keyframe.", client.pid);
+
+  // The keyframe has to arrive before the start of the game, so that the client can hold on to the
+  // pad data that follows instead of clearing it while booting.
+  Send(client.socket, m_spectator_keyframe);
+  Send(client.socket, m_start_game_packet);
+
+  client.input_to_client.Reset();
+
+  // Everything that was relayed since the keyframe, after which the regular relay takes over
+  constexpr size_t PADS_PER_PACKET = 1024;
+  std::vector<PadInput> pads;
+  for (const SpectatorPadLog& log : m_spectator_pad_log)
+  {
+    for (const PadInput& pad : log.entries)
+    {
+      pads.push_back(pad);
+      if (pads.size() == PADS_PER_PACKET)
+      {
+        SendPadData(MessageID::PadData, pads, client);
+        pads.clear();
+      }
+    }
+  }
+  if (!pads.empty())
+    SendPadData(MessageID::PadData, pads, client);
+}
+
+size_t NetPlayServer::GetSyncedPlayerCount() const
+{
+  return std::ranges::count_if(m_players,
+                               [](const auto& entry) { return !entry.second.joined_mid_game; });
+}
+
+// called from ---GUI--- thread
+void NetPlayServer::SetAutoPadBufferSize(const bool enable)
+{
+  std::lock_guard lkg(m_crit.game);
+
+  m_auto_buffer_size = enable;
+  m_auto_buffer_size_min = Config::Get(Config::NETPLAY_AUTO_BUFFER_SIZE_MIN);
+  m_auto_buffer_size_max =
+      std::max(m_auto_buffer_size_min, Config::Get(Config::NETPLAY_AUTO_BUFFER_SIZE_MAX));
+  m_auto_buffer_margin = 0;
+  m_auto_buffer_stable_updates = 0;
+  m_auto_buffer_lower_updates = 0;
+}
+
+// called from ---NETPLAY--- thread, roughly once a second
+void NetPlayServer::UpdateAutoPadBufferSize()
+{
+  // Pads are polled about once per frame, so this turns latency into a number of pad buffer slots.
+  // PAL games poll a little slower, which only makes the estimate err on the safe side.
+  constexpr double POLLS_PER_MS = 60.0 / 1000.0;
+  // Updates in a row without underruns before the margin is lowered again
+  constexpr u32 MARGIN_DECAY_UPDATES = 30;
+  constexpr u32 MAX_MARGIN = 4;
+  // Updates in a row that must call for a smaller buffer before it is lowered, so that a single
+  // quiet second doesn't undo what a lag spike just taught us
+  constexpr u32 LOWER_DELAY_UPDATES = 5;
+
+  std::lock_guard lkg(m_crit.game);
+
+  if (!m_auto_buffer_size || !m_is_running || m_host_input_authority)
+    return;
+
+  // Pad data from one player reaches another through the host, so the slowest path is the sum of
+  // the two slowest one-way trips. ENet's variance stands in for jitter.
+  std::vector<double> one_way_ms;
+  u32 underruns = 0;
+  {
+    std::lock_guard lkp(m_crit.players);
+    for (auto& [pid, client] : m_players)
+    {
+      const double rtt = client.socket->roundTripTime + 2.0 * client.socket->roundTripTimeVariance;
+      one_way_ms.push_back(rtt / 2);
+      underruns += std::exchange(client.pad_buffer_underruns, 0);
+    }
+  }
+  std::ranges::sort(one_way_ms, std::ranges::greater());
+  double latency_ms = 0;
+  for (size_t i = 0; i < std::min<size_t>(2, one_way_ms.size()); ++i)
+    latency_ms += one_way_ms[i];
+
+  if (underruns != 0)
+  {
+    m_auto_buffer_margin = std::min(m_auto_buffer_margin + 1, MAX_MARGIN);
+    m_auto_buffer_stable_updates = 0;
+  }
+  else if (++m_auto_buffer_stable_updates >= MARGIN_DECAY_UPDATES)
+  {
+    if (m_auto_buffer_margin != 0)
+      --m_auto_buffer_margin;
+    m_auto_buffer_stable_updates = 0;
+  }
+
+  const u32 wanted = static_cast<u32>(std::ceil(latency_ms * POLLS_PER_MS)) + m_auto_buffer_margin;
+  const u32 target = std::clamp(wanted, m_auto_buffer_size_min, m_auto_buffer_size_max);
+
+  if (target > m_target_buffer_size)
+  {
+    m_auto_buffer_lower_updates = 0;
+    INFO_LOG_FMT(NETPLAY, "Automatic pad buffer: raising to {} ({:.1f} ms, {} underruns)", target,
+                 latency_ms, underruns);
+    AdjustPadBufferSize(target);
+  }
+  else if (target < m_target_buffer_size)
+  {
+    // Step down one slot at a time, so the game doesn't suddenly stall while the clients' buffers
+    // drain.
+    if (++m_auto_buffer_lower_updates >= LOWER_DELAY_UPDATES)
+    {
+      INFO_LOG_FMT(NETPLAY, "Automatic pad buffer: lowering to {} ({:.1f} ms)",
+                   m_target_buffer_size - 1, latency_ms);
+      AdjustPadBufferSize(m_target_buffer_size - 1);
+    }
+  }
+  else
+  {
+    m_auto_buffer_lower_updates = 0;
+  }
+}
+
 void NetPlayServer::SetHostInputAuthority(const bool enable)
 {
   std::lock_guard lkg(m_crit.game);
@@ -711,24 +906,33 @@ void NetPlayServer::SetHostInputAuthority(const bool enable)
 
 void NetPlayServer::SendAsync(sf::Packet&& packet, const PlayerId pid, const u8 channel_id)
 {
-  {
-    std::lock_guard lkq(m_crit.async_queue_write);
-    m_async_queue.Push(AsyncQueueEntry{std::move(packet), pid, TargetMode::Only, channel_id});
-  }
+  const SendPriority priority = GetSendPriority(packet, channel_id);
+  m_async_queue.Push(priority,
+                     AsyncQueueEntry{std::move(packet), pid, TargetMode::Only, channel_id});
   Common::ENet::WakeupThread(m_server);
 }
 
 void NetPlayServer::SendAsyncToClients(sf::Packet&& packet, const PlayerId skip_pid,
                                        const u8 channel_id)
 {
-  {
-    std::lock_guard lkq(m_crit.async_queue_write);
-    m_async_queue.Push(
-        AsyncQueueEntry{std::move(packet), skip_pid, TargetMode::AllExcept, channel_id});
-  }
+  const SendPriority priority = GetSendPriority(packet, channel_id);
+  m_async_queue.Push(priority, AsyncQueueEntry{std::move(packet), skip_pid, TargetMode::AllExcept,
+                                               channel_id});
   Common::ENet::WakeupThread(m_server);
 }
 
+// called from ---NETPLAY--- thread
+bool NetPlayServer::CanSendBulkData(const AsyncQueueEntry& entry)
+{
+  std::lock_guard lkp(m_crit.players);
+  return std::ranges::none_of(m_players, [&entry](const auto& player) {
+    const auto& [pid, client] = player;
+    const bool is_target = entry.target_mode == TargetMode::Only ? pid == entry.target_pid :
+                                                                   pid != entry.target_pid;
+    return is_target && client.socket->reliableDataInTransit >= MAX_BULK_DATA_IN_TRANSIT;
+  });
+}
+
 void NetPlayServer::SendChunked(sf::Packet&& packet, const PlayerId pid, const std::string& title)
 {
   {
@@ -808,9 +1012,7 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
     if (player.current_game != m_current_game)
       break;
 
-    sf::Packet spac;
-    spac << (m_host_input_authority ? MessageID::PadHostData : MessageID::PadData);
-
+    std::vector<PadInput> pads;
     while (!packet.endOfPacket())
     {
       PadIndex map;
@@ -823,28 +1025,27 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
         return 1;
       }
 
+      u32 number;
       GCPadStatus pad;
-      packet >> pad.button;
-      spac << map << pad.button;
-      if (!m_gba_config.at(map).enabled)
-      {
-        packet >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >> pad.substickX >>
-            pad.substickY >> pad.triggerLeft >> pad.triggerRight >> pad.isConnected;
-
-        spac << pad.analogA << pad.analogB << pad.stickX << pad.stickY << pad.substickX
-             << pad.substickY << pad.triggerLeft << pad.triggerRight << pad.isConnected;
-      }
+      if (!player.input_from_client.pad_data.ReadPad(map, packet, &number, &pad))
+        return 1;
+      pads.push_back({map, number, pad});
     }
 
     if (m_host_input_authority)
     {
       // Prevent crash before game stop if the golfer disconnects
       if (m_current_golfer != 0 && m_players.contains(m_current_golfer))
-        Send(m_players.at(m_current_golfer).socket, spac);
+        SendPadData(MessageID::PadHostData, pads, m_players.at(m_current_golfer));
     }
     else
     {
-      SendToClients(spac, player.pid);
+      for (auto& [pid, client] : m_players)
+      {
+        if (pid != 0 && pid != player.pid)
+          SendPadData(MessageID::PadData, pads, client);
+      }
+      LogSpectatorPads(pads);
     }
   }
   break;
@@ -855,28 +1056,25 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
     if (m_current_golfer != 0 && player.pid != m_current_golfer)
       return 1;
 
-    sf::Packet spac;
-    spac << MessageID::PadData;
-
+    std::vector<PadInput> pads;
     while (!packet.endOfPacket())
     {
       PadIndex map;
       packet >> map;
 
+      // The number of the client's input that the host applied
+      u32 number;
       GCPadStatus pad;
-      packet >> pad.button;
-      spac << map << pad.button;
-      if (!m_gba_config.at(map).enabled)
-      {
-        packet >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >> pad.substickX >>
-            pad.substickY >> pad.triggerLeft >> pad.triggerRight >> pad.isConnected;
-
-        spac << pad.analogA << pad.analogB << pad.stickX << pad.stickY << pad.substickX
-             << pad.substickY << pad.triggerLeft << pad.triggerRight << pad.isConnected;
-      }
+      if (!player.input_from_client.pad_host_data.ReadPad(map, packet, &number, &pad))
+        return 1;
+      pads.push_back({map, number, pad});
     }
 
-    SendToClients(spac, player.pid);
+    for (auto& [pid, client] : m_players)
+    {
+      if (pid != 0 && pid != player.pid)
+        SendPadData(MessageID::PadData, pads, client);
+    }
   }
   break;
 
@@ -886,9 +1084,7 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
     if (player.current_game != m_current_game)
       break;
 
-    sf::Packet spac;
-    spac << MessageID::WiimoteData;
-
+    std::vector<std::pair<PadIndex, WiimoteEmu::SerializedWiimoteState>> wiimotes;
     while (!packet.endOfPacket())
     {
       PadIndex map;
@@ -902,19 +1098,26 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
       }
 
       WiimoteEmu::SerializedWiimoteState pad;
-      packet >> pad.length;
-      if (pad.length > pad.data.size())
+      if (!player.input_from_client.wiimote_data.ReadWiimote(map, packet, &pad))
         return 1;
-      for (size_t i = 0; i < pad.length; ++i)
-        packet >> pad.data[i];
-
-      spac << map;
-      spac << pad.length;
-      for (size_t i = 0; i < pad.length; ++i)
-        spac << pad.data[i];
+      wiimotes.emplace_back(map, pad);
     }
 
-    SendToClients(spac, player.pid);
+    // Each client gets its own packet, as the states are encoded against what it was last sent
+    for (auto& [pid, client] : m_players)
+    {
+      if (pid == 0 || pid == player.pid)
+        continue;
+
+      sf::Packet spac;
+      spac << MessageID::WiimoteData;
+      for (const auto& [map, pad] : wiimotes)
+      {
+        spac << map;
+        client.input_to_client.wiimote_data.WriteWiimote(map, pad, spac);
+      }
+      Send(client.socket, spac);
+    }
   }
   break;
 
@@ -975,6 +1178,19 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
   }
   break;
 
+  case MessageID::PadBufferStats:
+  {
+    u32 underruns;
+    packet >> underruns;
+    if (!packet)
+      break;
+
+    if (underruns != 0)
+      INFO_LOG_FMT(NETPLAY, "Player {} ran out of pad data {} times.", player.pid, underruns);
+    player.pad_buffer_underruns += underruns;
+  }
+  break;
+
   case MessageID::Pong:
   {
     // truncation (> ~49 days elapsed) should never happen here
@@ -999,6 +1215,7 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
   case MessageID::StartGame:
   {
     packet >> player.current_game;
+    player.input_from_client.Reset();
   }
   break;
 
@@ -1056,12 +1273,12 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
     u32 frame;
     packet >> frame;
 
-    if (m_desync_detected)
+    if (m_desync_detected || player.joined_mid_game)
       break;
 
     std::vector<std::pair<PlayerId, u64>>& timebases = m_timebase_by_frame[frame];
     timebases.emplace_back(player.pid, timebase);
-    if (timebases.size() >= m_players.size())
+    if (timebases.size() >= GetSyncedPlayerCount())
     {
       // we have all records for this frame
 
@@ -1095,6 +1312,109 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
   }
   break;
 
+  case MessageID::MemoryHashes:
+  {
+    u32 frame;
+    u32 first_page;
+    u32 count;
+    packet >> frame >> first_page >> count;
+    if (count > packet.getDataSize() / sizeof(u64))
+      break;
+
+    std::vector<u64> hashes(count);
+    for (u64& hash : hashes)
+      hash = Common::PacketReadU64(packet);
+
+    if (m_memory_desync_detected || player.joined_mid_game)
+      break;
+
+    MemoryHashes& frame_hashes = m_memory_hashes_by_frame[frame];
+    frame_hashes.first_page = first_page;
+    frame_hashes.hashes.emplace_back(player.pid, std::move(hashes));
+    if (frame_hashes.hashes.size() < GetSyncedPlayerCount())
+      break;
+
+    // we have all records for this frame; every player hashes the same pages for a given frame
+    const auto& records = frame_hashes.hashes;
+    size_t page_count = records[0].second.size();
+    for (const auto& record : records)
+      page_count = std::min(page_count, record.second.size());
+
+    for (size_t i = 0; i < page_count; ++i)
+    {
+      if (std::ranges::all_of(records, [&](const auto& record) {
+            return record.second[i] == records[0].second[i];
+          }))
+      {
+        continue;
+      }
+
+      int pid_to_blame = 0;
+      for (const auto& record : records)
+      {
+        if (std::ranges::all_of(records, [&](const auto& other) {
+              return other.first == record.first || other.second[i] != record.second[i];
+            }))
+        {
+          // we are the only outlier
+          pid_to_blame = record.first;
+          break;
+        }
+      }
+
+      sf::Packet spac;
+      spac << MessageID::MemoryDesyncDetected;
+      spac << pid_to_blame;
+      spac << frame;
+      spac << static_cast<u32>(frame_hashes.first_page + i);
+      SendToClients(spac);
+
+      m_memory_desync_detected = true;
+      break;
+    }
+    m_memory_hashes_by_frame.erase(frame);
+  }
+  break;
+
+  case MessageID::SpectatorKeyframe:
+  {
+    if (!player.IsHost() || player.current_game != m_current_game ||
+        m_settings.spectator_keyframe_frames == 0)
+    {
+      break;
+    }
+
+    u32 frame;
+    packet >> frame;
+    std::array<u64, 4> pads;
+    for (u64& count : pads)
+      count = Common::PacketReadU64(packet);
+
+    // The keyframe is only usable if every pad input the host used after it can still be replayed
+    for (size_t i = 0; i < pads.size(); ++i)
+    {
+      if (pads[i] < m_spectator_pad_log[i].first_index)
+      {
+        WARN_LOG_FMT(NETPLAY, "Dropping spectator keyframe for frame {}, pad {} was trimmed", frame,
+                     i);
+        return 0;
+      }
+    }
+
+    m_spectator_keyframe = packet;
+    m_spectator_keyframe_pads = pads;
+    for (size_t i = 0; i < pads.size(); ++i)
+    {
+      SpectatorPadLog& log = m_spectator_pad_log[i];
+      while (!log.entries.empty() && log.first_index < pads[i])
+      {
+        log.entries.pop_front();
+        ++log.first_index;
+      }
+    }
+  }
+  break;
+
   case MessageID::GameDigestProgress:
   {
     int progress;
@@ -1184,6 +1504,32 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
     }
     break;
 
+    case SyncSaveDataID::CachedBlocks:
+    {
+      u32 count;
+      packet >> count;
+      if (!packet || count > MAX_CACHED_SAVE_BLOCKS)
+        return 1;
+
+      std::set<SaveBlockHash> cached_blocks;
+      for (u32 i = 0; i < count; ++i)
+      {
+        SaveBlockHash hash;
+        for (u8& byte : hash)
+          packet >> byte;
+        if (!packet)
+          return 1;
+        cached_blocks.insert(hash);
+      }
+
+      // SyncSaveData reads the sets on the GUI thread
+      std::lock_guard lkp(m_crit.players);
+      player.cached_save_blocks = std::move(cached_blocks);
+
+      INFO_LOG_FMT(NETPLAY, "Player {} has {} cached save blocks.", player.pid, count);
+    }
+    break;
+
     default:
       PanicAlertFmtT(
           "Unknown SYNC_SAVE_DATA message with id:{0} received from player:{1} Kicking player!",
@@ -1460,8 +1806,30 @@ bool NetPlayServer::SetupNetSettings()
   settings.strict_settings_sync = Config::Get(Config::NETPLAY_STRICT_SETTINGS_SYNC);
   settings.sync_codes = Config::Get(Config::NETPLAY_SYNC_CODES);
   settings.golf_mode = Config::Get(Config::NETPLAY_NETWORK_MODE) == "golf";
+  settings.rollback = Config::Get(Config::NETPLAY_NETWORK_MODE) == "rollback";
+  settings.host_input_prediction =
+      Config::Get(Config::NETPLAY_NETWORK_MODE) == "hostinputprediction";
   settings.use_fma = DoAllPlayersHaveHardwareFMA();
   settings.hide_remote_gbas = Config::Get(Config::NETPLAY_HIDE_REMOTE_GBAS);
+  // Modes that run ahead on predicted inputs briefly diverge between players by design, so only
+  // the timebase is compared with those.
+  settings.memory_hash_frames = 0;
+  if (Config::Get(Config::NETPLAY_MEMORY_HASH) && !settings.rollback &&
+      !settings.host_input_prediction)
+  {
+    settings.memory_hash_frames = std::max<u32>(Config::Get(Config::NETPLAY_MEMORY_HASH_FRAMES), 1);
+  }
+
+  // Spectators joining mid-game replay the GC pad inputs the host consumed after one of its
+  // keyframes. That only lines up in fixed delay mode, and Wii Remotes aren't supported.
+  settings.spectator_keyframe_frames = 0;
+  if (Config::Get(Config::NETPLAY_SPECTATOR_RELAY) && !settings.rollback &&
+      !m_host_input_authority &&
+      std::ranges::none_of(m_wiimote_map, [](PlayerId pid) { return pid > 0; }))
+  {
+    settings.spectator_keyframe_frames =
+        std::max<u32>(Config::Get(Config::NETPLAY_SPECTATOR_KEYFRAME_FRAMES), 1);
+  }
 
   // Unload GameINI to restore things to normal
   Config::RemoveLayer(Config::LayerType::GlobalGame);
@@ -1566,10 +1934,25 @@ bool NetPlayServer::StartGame()
 
   m_timebase_by_frame.clear();
   m_desync_detected = false;
+  m_memory_hashes_by_frame.clear();
+  m_memory_desync_detected = false;
   std::lock_guard lkg(m_crit.game);
+
+  m_spectator_keyframe.clear();
+  m_spectator_keyframe_pads.fill(0);
+  m_spectator_pad_log.fill({});
   // only used as an identifier, not time value, so truncation is fine
   m_current_game = static_cast<u32>(Common::Timer::NowMs());
 
+  {
+    std::lock_guard lkp(m_crit.players);
+    for (auto& [pid, client] : m_players)
+    {
+      client.input_to_client.Reset();
+      client.joined_mid_game = false;
+    }
+  }
+
   // no change, just update with clients
   if (!m_host_input_authority)
     AdjustPadBufferSize(m_target_buffer_size);
@@ -1668,12 +2051,17 @@ bool NetPlayServer::StartGame()
   spac << m_settings.sync_codes;
 
   spac << m_settings.golf_mode;
+  spac << m_settings.rollback;
+  spac << m_settings.host_input_prediction;
   spac << m_settings.use_fma;
   spac << m_settings.hide_remote_gbas;
+  spac << m_settings.memory_hash_frames;
+  spac << m_settings.spectator_keyframe_frames;
 
   for (size_t i = 0; i < sizeof(m_settings.sram); ++i)
     spac << m_settings.sram[i];
 
+  m_start_game_packet = spac;
   SendAsyncToClients(std::move(spac));
 
   m_start_pending = false;
@@ -1826,6 +2214,32 @@ bool NetPlayServer::SyncSaveData(const SaveSyncInfo& sync_info)
   const auto gamecube_region = Config::ToGameCubeRegion(game_region);
   const std::string region = Config::GetDirectoryForRegion(gamecube_region);
 
+  // Every client gets the same packets, so only blocks all of them have cached can be left out.
+  std::set<SaveBlockHash> cached_blocks;
+  {
+    // The network thread replaces the sets when a client reports its cache
+    std::lock_guard lkp(m_crit.players);
+    bool first_client = true;
+    for (const auto& [pid, client] : m_players)
+    {
+      if (client.IsHost())
+        continue;
+
+      if (first_client)
+      {
+        cached_blocks = client.cached_save_blocks;
+        first_client = false;
+      }
+      else
+      {
+        std::erase_if(cached_blocks, [&client](const SaveBlockHash& hash) {
+          return !client.cached_save_blocks.contains(hash);
+        });
+      }
+    }
+  }
+  INFO_LOG_FMT(NETPLAY, "{} save blocks are cached by all clients.", cached_blocks.size());
+
   for (ExpansionInterface::Slot slot : ExpansionInterface::MEMCARD_SLOTS)
   {
     const bool is_slot_a = slot == ExpansionInterface::Slot::A;
@@ -1848,7 +2262,8 @@ bool NetPlayServer::SyncSaveData(const SaveSyncInfo& sync_info)
       {
         INFO_LOG_FMT(NETPLAY, "Sending data of raw memcard {} in slot {}.", path,
                      is_slot_a ? 'A' : 'B');
-        if (!CompressFileIntoPacket(path, pac))
+        PacketCompressor compressor(pac, &cached_blocks);
+        if (!compressor.AddFile(path) || !compressor.Finish())
           return false;
       }
       else
@@ -1882,14 +2297,17 @@ bool NetPlayServer::SyncSaveData(const SaveSyncInfo& sync_info)
 
         pac << static_cast<u8>(files.size());
 
+        PacketCompressor compressor(pac, &cached_blocks);
         for (const std::string& file : files)
         {
           const std::string filename = file.substr(file.find_last_of('/') + 1);
           INFO_LOG_FMT(NETPLAY, "Sending GCI {}.", filename);
-          pac << filename;
-          if (!CompressFileIntoPacket(file, pac))
+          compressor.Framing() << filename;
+          if (!compressor.AddFile(file))
             return false;
         }
+        if (!compressor.Finish())
+          return false;
       }
       else
       {
@@ -1910,27 +2328,32 @@ bool NetPlayServer::SyncSaveData(const SaveSyncInfo& sync_info)
     pac << MessageID::SyncSaveData;
     pac << SyncSaveDataID::WiiData;
 
+    // Everything else goes through the compressor, so that all the files in the packet are
+    // compressed in parallel.
+    PacketCompressor compressor(pac, &cached_blocks);
+    sf::Packet& framing = compressor.Framing();
+
     // Shove the Mii data into the start the packet
     if (sync_info.mii_data)
     {
       INFO_LOG_FMT(NETPLAY, "Sending Mii data.");
-      pac << true;
-      if (!CompressBufferIntoPacket(*sync_info.mii_data, pac))
+      framing << true;
+      if (!compressor.AddBuffer(*sync_info.mii_data))
         return false;
     }
     else
     {
       INFO_LOG_FMT(NETPLAY, "Not sending Mii data.");
-      pac << false;  // no mii data
+      framing << false;  // no mii data
     }
 
     // Carry on with the save files
     INFO_LOG_FMT(NETPLAY, "Sending {} Wii saves.", sync_info.wii_saves.size());
-    pac << static_cast<u32>(sync_info.wii_saves.size());
+    framing << static_cast<u32>(sync_info.wii_saves.size());
 
     for (const auto& [title_id, storage] : sync_info.wii_saves)
     {
-      pac << u64{title_id};
+      framing << u64{title_id};
 
       if (storage->SaveExists())
       {
@@ -1944,26 +2367,26 @@ bool NetPlayServer::SyncSaveData(const SaveSyncInfo& sync_info)
         }
 
         INFO_LOG_FMT(NETPLAY, "Sending Wii save of title {:016x}.", title_id);
-        pac << true;  // save exists
+        framing << true;  // save exists
 
         // Header
-        pac << u64{header->tid};
-        pac << header->banner_size << header->permissions << header->unk1;
+        framing << u64{header->tid};
+        framing << header->banner_size << header->permissions << header->unk1;
         for (u8 byte : header->md5)
-          pac << byte;
-        pac << header->unk2;
+          framing << byte;
+        framing << header->unk2;
         for (size_t i = 0; i < header->banner_size; i++)
-          pac << header->banner[i];
+          framing << header->banner[i];
 
         // BkHeader
-        pac << bk_header->size << bk_header->magic << bk_header->ngid << bk_header->number_of_files
-            << bk_header->size_of_files << bk_header->unk1 << bk_header->unk2
-            << bk_header->total_size;
+        framing << bk_header->size << bk_header->magic << bk_header->ngid
+                << bk_header->number_of_files << bk_header->size_of_files << bk_header->unk1
+                << bk_header->unk2 << bk_header->total_size;
         for (u8 byte : bk_header->unk3)
-          pac << byte;
-        pac << u64{bk_header->tid};
+          framing << byte;
+        framing << u64{bk_header->tid};
         for (u8 byte : bk_header->mac_address)
-          pac << byte;
+          framing << byte;
 
         // Files
         for (const WiiSave::Storage::SaveFile& file : *files)
@@ -1971,12 +2394,12 @@ bool NetPlayServer::SyncSaveData(const SaveSyncInfo& sync_info)
           INFO_LOG_FMT(NETPLAY, "Sending Wii save data of type {} at {}",
                        static_cast<u8>(file.type), file.path);
 
-          pac << file.mode << file.attributes << file.type << file.path;
+          framing << file.mode << file.attributes << file.type << file.path;
 
           if (file.type == WiiSave::Storage::SaveFile::Type::File)
           {
             const std::optional<std::vector<u8>>& data = *file.data;
-            if (!data || !CompressBufferIntoPacket(*data, pac))
+            if (!data || !compressor.AddBuffer(*data))
               return false;
           }
         }
@@ -1984,7 +2407,7 @@ bool NetPlayServer::SyncSaveData(const SaveSyncInfo& sync_info)
       else
       {
         INFO_LOG_FMT(NETPLAY, "No data for Wii save of title {:016x}.", title_id);
-        pac << false;  // save does not exist
+        framing << false;  // save does not exist
       }
     }
 
@@ -1992,16 +2415,19 @@ bool NetPlayServer::SyncSaveData(const SaveSyncInfo& sync_info)
     {
       INFO_LOG_FMT(NETPLAY, "Sending redirected save at {}.",
                    sync_info.redirected_save->m_target_path);
-      pac << true;
-      if (!CompressFolderIntoPacket(sync_info.redirected_save->m_target_path, pac))
+      framing << true;
+      if (!compressor.AddFolder(sync_info.redirected_save->m_target_path))
         return false;
     }
     else
     {
       INFO_LOG_FMT(NETPLAY, "Not sending redirected save.");
-      pac << false;  // no redirected save
+      framing << false;  // no redirected save
     }
 
+    if (!compressor.Finish())
+      return false;
+
     SendChunkedToClients(std::move(pac), 1, "Wii Save Synchronization");
   }
 
@@ -2022,7 +2448,8 @@ bool NetPlayServer::SyncSaveData(const SaveSyncInfo& sync_info)
       if (File::Exists(path))
       {
         INFO_LOG_FMT(NETPLAY, "Sending data of GBA save at {} for slot {}.", path, i);
-        if (!CompressFileIntoPacket(path, pac))
+        PacketCompressor compressor(pac, &cached_blocks);
+        if (!compressor.AddFile(path) || !compressor.Finish())
           return false;
       }
       else
@@ -5,11 +5,15 @@
 
 #include <SFML/Network/Packet.hpp>
 
+#include <array>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <set>
+#include <span>
 #include <sstream>
 #include <thread>
 #include <unordered_map>
@@ -21,7 +25,10 @@
 #include "Common/SPSCQueue.h"
 #include "Common/Timer.h"
 #include "Common/TraversalClient.h"
+#include "Core/NetPlayCommon.h"
+#include "Core/NetPlayInputDelta.h"
 #include "Core/NetPlayProto.h"
+#include "Core/NetPlaySendQueue.h"
 #include "Core/SyncIdentifier.h"
 #include "InputCommon/GCPadStatus.h"
 #include "UICommon/NetPlayIndex.h"
@@ -67,6 +74,7 @@ public:
   void SetWiimoteMapping(const PadMappingArray& mappings);
 
   void AdjustPadBufferSize(unsigned int size);
+  void SetAutoPadBufferSize(bool enable);
   void SetHostInputAuthority(bool enable);
 
   void KickPlayer(PlayerId player);
@@ -92,6 +100,19 @@ private:
     ENetPeer* socket = nullptr;
     u32 ping = 0;
     u32 current_game = 0;
+    // Times the client had to wait for pad data, since the last automatic buffer update
+    u32 pad_buffer_underruns = 0;
+
+    // Delta encoding state of the pads and Wiimotes received from and sent to this client
+    InputDeltaStreams input_from_client;
+    InputDeltaStreams input_to_client;
+
+    // Save sync blocks the client has in its SaveBlockCache, as of its last report
+    std::set<SaveBlockHash> cached_save_blocks;
+
+    // Spectators that joined a game in progress start from a keyframe, so their timebase and
+    // memory hashes don't line up with everyone else's
+    bool joined_mid_game = false;
 
     Common::QoSSession qos_session;
 
@@ -121,6 +142,20 @@ private:
     std::string title;
   };
 
+  // A pad input, with the number that the client which polled it gave it
+  struct PadInput
+  {
+    PadIndex map;
+    u32 number;
+    GCPadStatus pad;
+  };
+
+  void SendPadData(MessageID message, std::span<const PadInput> pads, Client& client);
+  void UpdateAutoPadBufferSize();
+  void LogSpectatorPads(std::span<const PadInput> pads);
+  bool CanJoinMidGame() const;
+  void SendMidGameJoin(Client& client);
+  size_t GetSyncedPlayerCount() const;
   bool SetupNetSettings();
   std::optional<SaveSyncInfo> CollectSaveSyncInfo();
   bool SyncSaveData(const SaveSyncInfo& sync_info);
@@ -151,6 +186,7 @@ private:
   std::vector<std::pair<std::string, std::string>> GetInterfaceListInternal() const;
   void ChunkedDataThreadFunc();
   void ChunkedDataSend(sf::Packet&& packet, PlayerId pid, const TargetMode target_mode);
+  bool CanSendBulkData(const AsyncQueueEntry& entry);
   void ChunkedDataAbort();
 
   void SetupIndex();
@@ -171,6 +207,13 @@ private:
   bool m_update_pings = false;
   u32 m_current_game = 0;
   unsigned int m_target_buffer_size = 0;
+  bool m_auto_buffer_size = false;
+  u32 m_auto_buffer_size_min = 0;
+  u32 m_auto_buffer_size_max = 0;
+  // Extra frames on top of what the latency calls for, raised whenever a client runs dry
+  u32 m_auto_buffer_margin = 0;
+  u32 m_auto_buffer_stable_updates = 0;
+  u32 m_auto_buffer_lower_updates = 0;
   PadMappingArray m_pad_map;
   GBAConfigArray m_gba_config;
   PadMappingArray m_wiimote_map;
@@ -187,17 +230,36 @@ private:
 
   std::unordered_map<u32, std::vector<std::pair<PlayerId, u64>>> m_timebase_by_frame;
   bool m_desync_detected = false;
+  struct MemoryHashes
+  {
+    u32 first_page = 0;
+    std::vector<std::pair<PlayerId, std::vector<u64>>> hashes;
+  };
+  std::unordered_map<u32, MemoryHashes> m_memory_hashes_by_frame;
+  bool m_memory_desync_detected = false;
+
+  // The newest keyframe from the host and the pad data relayed since, which is what a spectator
+  // joining mid-game needs to catch up
+  struct SpectatorPadLog
+  {
+    std::deque<PadInput> entries;
+    // Number of entries of the pad that were relayed before the first one in entries
+    u64 first_index = 0;
+  };
+  sf::Packet m_start_game_packet;
+  sf::Packet m_spectator_keyframe;
+  std::array<u64, 4> m_spectator_keyframe_pads{};
+  std::array<SpectatorPadLog, 4> m_spectator_pad_log;
 
   struct
   {
     std::recursive_mutex game;
     // lock order
     std::recursive_mutex players;
-    std::recursive_mutex async_queue_write;
     std::recursive_mutex chunked_data_queue_write;
   } m_crit;
 
-  Common::SPSCQueue<AsyncQueueEntry> m_async_queue;
+  SendQueue<AsyncQueueEntry> m_async_queue;
   Common::SPSCQueue<ChunkedDataQueueEntry> m_chunked_data_queue;
 
   SyncIdentifier m_selected_game_identifier;
@@ -4,28 +4,35 @@
 #include "Core/State.h"
 
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <cstring>
 #include <filesystem>
 #include <locale>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include <fmt/chrono.h>
 #include <fmt/format.h>
 
-#include <lz4.h>
 #include <lzo/lzo1x.h>
 
+#include "Common/Assert.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Contains.h"
 #include "Common/Event.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
+#include "Common/MappedFile.h"
 #include "Common/MsgHandler.h"
 #include "Common/Thread.h"
 #include "Common/TimeUtil.h"
@@ -33,6 +40,7 @@
 #include "Common/WorkQueueThread.h"
 
 #include "Core/AchievementManager.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -44,26 +52,20 @@
 #include "Core/Movie.h"
 #include "Core/NetPlayProto.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/StateCodec.h"
+#include "Core/StateRewind.h"
+#include "Core/StateSlotIndex.h"
+#include "Core/StateThumbnail.h"
 #include "Core/System.h"
 
+#include "VideoCommon/AsyncRequests.h"
 #include "VideoCommon/FrameDumpFFMpeg.h"
 #include "VideoCommon/OnScreenDisplay.h"
+#include "VideoCommon/Present.h"
 #include "VideoCommon/VideoBackendBase.h"
 
 namespace State
 {
-#if defined(__LZO_STRICT_16BIT)
-static const u32 IN_LEN = 8 * 1024u;
-#elif defined(LZO_ARCH_I086) && !defined(LZO_HAVE_MM_HUGE_ARRAY)
-static const u32 IN_LEN = 60 * 1024u;
-#else
-static const u32 IN_LEN = 128 * 1024u;
-#endif
-
-static const u32 OUT_LEN = IN_LEN + (IN_LEN / 16) + 64 + 3;
-
-static unsigned char __LZO_MMODEL out[OUT_LEN];
-
 static AfterLoadCallbackFunc s_on_after_load_callback;
 
 // Temporary undo state buffer
@@ -72,10 +74,67 @@ static std::mutex s_undo_load_buffer_mutex;
 
 static std::mutex s_load_or_save_in_progress_mutex;
 
+// Rewind snapshots are taken on the CPU thread and compressed into the rewind buffer by the rewind
+// worker. Their buffers are handed back afterwards, so that taking a snapshot doesn't allocate.
+constexpr u32 REWIND_SNAPSHOTS_PER_KEYFRAME = 10;
+constexpr size_t MAX_REWIND_SNAPSHOTS_IN_FLIGHT = 2;
+static std::unique_ptr<RewindBuffer> s_rewind_buffer;
+static std::mutex s_rewind_buffer_mutex;
+struct RewindSnapshot
+{
+  Common::UniqueBuffer<u8> buffer;
+  size_t state_size = 0;
+  // MAIN_REWIND_MEMORY_MB as of taking the snapshot, so that changing it applies right away
+  size_t memory_budget = 0;
+};
+static Common::WorkQueueThread<RewindSnapshot> s_rewind_thread;
+static std::vector<Common::UniqueBuffer<u8>> s_rewind_free_buffers;
+static std::mutex s_rewind_free_buffers_mutex;
+static std::atomic<size_t> s_rewind_snapshots_in_flight;
+// Only touched on the CPU thread
+static u32 s_frames_until_rewind_snapshot;
+
+// The snapshots lead up to the state that was current before loading another one, so rewinding
+// after the load must not go back to them. Only call from the CPU thread.
+static void ClearRewindHistory()
+{
+  // Snapshots that are still being compressed are from before the load as well
+  s_rewind_thread.WaitForCompletion();
+
+  std::lock_guard lk(s_rewind_buffer_mutex);
+  if (s_rewind_buffer)
+    s_rewind_buffer->Clear();
+  s_frames_until_rewind_snapshot = 0;
+}
+
+// Size for buffers that states are written into, taken from the last full state that was written.
+// Only touched on the CPU thread.
+static size_t s_state_size_hint;
+
+// The headroom is a fraction of the state size, so that a state which keeps growing a little
+// doesn't have to be written twice every time.
+constexpr size_t STATE_SIZE_HEADROOM_DIVISOR = 64;
+
+// Recreated whenever the slots of a different game are asked for
+static std::shared_ptr<SlotIndex> s_slot_index;
+static std::mutex s_slot_index_mutex;
+
+// Buffer handed back by the save worker once it's done with it, so that saving a state to a file
+// doesn't allocate every time.
+static Common::UniqueBuffer<u8> s_spare_save_buffer;
+static std::mutex s_spare_save_buffer_mutex;
+
 struct CompressAndDumpState_args
 {
   Common::UniqueBuffer<u8> buffer;
+  size_t state_size;
+  std::vector<size_t> section_offsets;
+  // Scaled down and encoded on the save thread
+  VideoCommon::FrameThumbnail thumbnail_frame;
   std::string filename;
+  const StateCodec* codec;
+  int compression_level;
+  std::string saved_message;
   std::shared_ptr<Common::Event> state_write_done_event;
 };
 
@@ -95,13 +154,18 @@ static size_t s_state_writes_in_queue;
 static std::condition_variable s_state_write_queue_is_empty;
 
 // Don't forget to increase this after doing changes on the savestate system
-constexpr u32 STATE_VERSION = 174;  // Last changed in PR 13342
+constexpr u32 STATE_VERSION = 175;  // Last changed by adding the section index
 
-// Increase this if the StateExtendedHeader definition changes
-constexpr u32 EXTENDED_HEADER_VERSION = 1;  // Last changed in PR 12217
+// Increase this if the StateExtendedHeader definition changes. Builds only look at it after the
+// state version, so increase that as well, or older builds take the new header for a corrupted one
+// rather than telling that the state is from a different version.
+constexpr u32 EXTENDED_HEADER_VERSION = 2;  // Last changed by adding the section index
+// The thumbnail didn't need a new version, as its size took the place of a reserved field that was
+// always written as 0. States written before it simply have no thumbnail.
 
-// Change this if we ever need to store more data in the extended header
-constexpr u32 COMPRESSED_DATA_OFFSET = 0;
+// States from before the section index have the same payload, so they can still be loaded.
+constexpr u32 STATE_VERSION_WITHOUT_SECTION_INDEX = 174;
+constexpr u32 EXTENDED_HEADER_VERSION_WITHOUT_SECTION_INDEX = 1;
 
 constexpr u32 COOKIE_BASE = 0xBAADBABE;
 
@@ -135,7 +199,75 @@ void EnableCompression(bool compression)
   s_use_compression = compression;
 }
 
-static void DoState(Core::System& system, PointerWrap& p)
+namespace
+{
+struct StateSection
+{
+  // Also names the section in the section index, so it has to fit into its name field
+  const char* name;
+  void (*do_state)(Core::System& system, PointerWrap& p);
+  bool in_rollback_state = true;
+  bool has_marker = true;
+};
+
+// Names the part of the section index that holds the prelude
+constexpr std::string_view PRELUDE_SECTION_NAME = "Prelude";
+
+// The sections that make up a savestate, in the order they are serialized. Each one is followed by
+// a marker unless it says otherwise, so a mismatch points at the section that read too much or too
+// little.
+constexpr StateSection s_full_state_sections[] = {
+    // Movie must be done before the video backend, because the window is redrawn in the video
+    // backend state load, and the frame number must be up-to-date.
+    // Rollback leaves it out, so the movie sees every frame once even if it's re-simulated.
+    {"Movie", [](Core::System& system, PointerWrap& p) { system.GetMovie().DoState(p); }, false},
+
+    // Begin with video backend, so that it gets a chance to clear its caches and writeback
+    // modified things to RAM
+    // Rollback leaves it out, as it can only be saved by waiting for the GPU thread. Games redraw
+    // the whole picture every frame, so the GPU catches up on its own.
+    {"video_backend", [](Core::System&, PointerWrap& p) { g_video_backend->DoState(p); }, false},
+
+    // CoreTiming needs to be restored before restoring Hardware because
+    // the controller code might need to schedule an event if the controller has changed.
+    {"CoreTiming",
+     [](Core::System& system, PointerWrap& p) { system.GetCoreTiming().DoState(p); }},
+
+    // HW needs to be restored before PowerPC because the data cache might need to be flushed.
+    {"HW", [](Core::System& system, PointerWrap& p) { HW::DoState(system, p); }},
+
+    {"PowerPC", [](Core::System& system, PointerWrap& p) { system.GetPowerPC().DoState(p); }},
+
+    {"Wiimote",
+     [](Core::System& system, PointerWrap& p) {
+       if (system.IsWii())
+         Wiimote::DoState(p);
+     }},
+
+    {"Gecko", [](Core::System&, PointerWrap& p) { Gecko::DoState(p); }},
+
+#ifdef USE_RETRO_ACHIEVEMENTS
+    // Never had a marker, and adding one would change the state layout.
+    {"Achievements",
+     [](Core::System&, PointerWrap& p) { AchievementManager::GetInstance().DoState(p); }, true,
+     false},
+#endif  // USE_RETRO_ACHIEVEMENTS
+};
+static_assert(std::ranges::all_of(s_full_state_sections, [](const StateSection& section) {
+  return std::string_view(section.name).size() <= std::size(StateSectionIndexEntry{}.name);
+}));
+
+enum class StateKind
+{
+  Full,
+  // Only the sections with in_rollback_state set, for NetPlay rollback
+  Rollback,
+};
+}  // namespace
+
+// Checks that the state was made with the same console type and memory sizes. This comes before
+// the first section.
+static bool DoStatePrelude(Core::System& system, PointerWrap& p)
 {
   bool is_wii = system.IsWii() || system.IsMIOS();
   const bool is_wii_currently = is_wii;
@@ -146,7 +278,7 @@ static void DoState(Core::System& system, PointerWrap& p)
                                 is_wii ? "Wii" : "GC", is_wii_currently ? "Wii" : "GC"),
                     OSD::Duration::NORMAL, OSD::Color::RED);
     p.SetMeasureMode();
-    return;
+    return false;
   }
 
   // Check to make sure the emulated memory sizes are the same as the savestate
@@ -165,40 +297,29 @@ static void DoState(Core::System& system, PointerWrap& p)
                                 state_mem1_size, state_mem1_size / 0x100000U, state_mem2_size,
                                 state_mem2_size / 0x100000U));
     p.SetMeasureMode();
-    return;
+    return false;
   }
 
-  // Movie must be done before the video backend, because the window is redrawn in the video backend
-  // state load, and the frame number must be up-to-date.
-  system.GetMovie().DoState(p);
-  p.DoMarker("Movie");
-
-  // Begin with video backend, so that it gets a chance to clear its caches and writeback modified
-  // things to RAM
-  g_video_backend->DoState(p);
-  p.DoMarker("video_backend");
-
-  // CoreTiming needs to be restored before restoring Hardware because
-  // the controller code might need to schedule an event if the controller has changed.
-  system.GetCoreTiming().DoState(p);
-  p.DoMarker("CoreTiming");
-
-  // HW needs to be restored before PowerPC because the data cache might need to be flushed.
-  HW::DoState(system, p);
-  p.DoMarker("HW");
+  return true;
+}
 
-  system.GetPowerPC().DoState(p);
-  p.DoMarker("PowerPC");
+static void DoStateSection(Core::System& system, PointerWrap& p, const StateSection& section)
+{
+  section.do_state(system, p);
+  if (section.has_marker)
+    p.DoMarker(section.name);
+}
 
-  if (system.IsWii())
-    Wiimote::DoState(p);
-  p.DoMarker("Wiimote");
-  Gecko::DoState(p);
-  p.DoMarker("Gecko");
+static void DoState(Core::System& system, PointerWrap& p, StateKind kind = StateKind::Full)
+{
+  if (!DoStatePrelude(system, p))
+    return;
 
-#ifdef USE_RETRO_ACHIEVEMENTS
-  AchievementManager::GetInstance().DoState(p);
-#endif  // USE_RETRO_ACHIEVEMENTS
+  for (const StateSection& section : s_full_state_sections)
+  {
+    if (kind == StateKind::Full || section.in_rollback_state)
+      DoStateSection(system, p, section);
+  }
 }
 
 void LoadFromBuffer(Core::System& system, Common::UniqueBuffer<u8>& buffer)
@@ -221,28 +342,107 @@ void LoadFromBuffer(Core::System& system, Common::UniqueBuffer<u8>& buffer)
         u8* ptr = buffer.data();
         PointerWrap p(&ptr, buffer.size(), PointerWrap::Mode::Read);
         DoState(system, p);
+        ClearRewindHistory();
       },
       true);
 }
 
-void SaveToBuffer(Core::System& system, Common::UniqueBuffer<u8>& buffer)
+static bool LoadFromBufferNow(Core::System& system, Common::UniqueBuffer<u8>& buffer,
+                              StateKind kind)
+{
+  ASSERT(Core::IsCPUThread());
+
+  u8* ptr = buffer.data();
+  PointerWrap p(&ptr, buffer.size(), PointerWrap::Mode::Read);
+  DoState(system, p, kind);
+  return p.IsReadMode();
+}
+
+bool LoadFromKeyframeBuffer(Core::System& system, Common::UniqueBuffer<u8>& buffer)
 {
+  return LoadFromBufferNow(system, buffer, StateKind::Full);
+}
+
+bool LoadFromRollbackBuffer(Core::System& system, Common::UniqueBuffer<u8>& buffer)
+{
+  return LoadFromBufferNow(system, buffer, StateKind::Rollback);
+}
+
+// Writes the state with a single DoState pass as long as it fits into the buffer, which it does
+// unless the state has grown since the last save. A pass that runs out of space carries on in
+// measure mode, so in that case the buffer is grown to the measured size and written again.
+// The buffer is never shrunk. Returns the size of the state, or nothing if it couldn't be written.
+// If section_offsets is given, it's filled with where each of the full state sections starts.
+// Rollback states are much smaller than full ones, so they don't affect the size hint.
+static std::optional<size_t> WriteStateToBuffer(Core::System& system,
+                                                Common::UniqueBuffer<u8>& buffer,
+                                                std::vector<size_t>* section_offsets = nullptr,
+                                                StateKind kind = StateKind::Full)
+{
+  const auto write_pass = [&] {
+    u8* ptr = buffer.data();
+    PointerWrap p(&ptr, buffer.size(), PointerWrap::Mode::Write);
+    if (!section_offsets)
+    {
+      DoState(system, p, kind);
+    }
+    else
+    {
+      section_offsets->clear();
+      if (DoStatePrelude(system, p))
+      {
+        for (const StateSection& section : s_full_state_sections)
+        {
+          section_offsets->push_back(ptr - buffer.data());
+          DoStateSection(system, p, section);
+        }
+      }
+    }
+    return std::pair(p.IsWriteMode(), static_cast<size_t>(ptr - buffer.data()));
+  };
+
+  const bool full = kind == StateKind::Full;
+  if (full && buffer.size() < s_state_size_hint)
+    buffer.reset(s_state_size_hint);
+
+  auto [written, state_size] = write_pass();
+  if (!written)
+  {
+    buffer.reset(state_size + state_size / STATE_SIZE_HEADROOM_DIVISOR);
+
+    std::tie(written, state_size) = write_pass();
+    if (!written)
+      return std::nullopt;
+  }
+
+  if (full)
+    s_state_size_hint = state_size + state_size / STATE_SIZE_HEADROOM_DIVISOR;
+  return state_size;
+}
+
+size_t SaveToBuffer(Core::System& system, Common::UniqueBuffer<u8>& buffer)
+{
+  size_t state_size = 0;
   Core::RunOnCPUThread(
-      system,
-      [&] {
-        u8* ptr = nullptr;
-        PointerWrap p_measure(&ptr, 0, PointerWrap::Mode::Measure);
-        DoState(system, p_measure);
+      system, [&] { state_size = WriteStateToBuffer(system, buffer).value_or(0); }, true);
 
-        const size_t new_buffer_size = ptr - (u8*)(nullptr);
-        if (new_buffer_size > buffer.size())
-          buffer.reset(new_buffer_size);
+  // Don't leave a partially written state around for anything to load
+  if (state_size == 0)
+    buffer.reset();
 
-        ptr = buffer.data();
-        PointerWrap p(&ptr, buffer.size(), PointerWrap::Mode::Write);
-        DoState(system, p);
-      },
-      true);
+  return state_size;
+}
+
+size_t SaveToRollbackBuffer(Core::System& system, Common::UniqueBuffer<u8>& buffer)
+{
+  ASSERT(Core::IsCPUThread());
+
+  const size_t state_size =
+      WriteStateToBuffer(system, buffer, nullptr, StateKind::Rollback).value_or(0);
+  if (state_size == 0)
+    buffer.reset();
+
+  return state_size;
 }
 
 namespace
@@ -290,94 +490,91 @@ static std::string SystemTimeAsDoubleToString(double time)
 }
 
 static std::string MakeStateFilename(int number);
+static std::optional<SlotHeader> ReadSlotHeader(const std::string& filename);
 
-static std::vector<SlotWithTimestamp> GetUsedSlotsWithTimestamp()
+static std::shared_ptr<SlotIndex> GetSlotIndex()
 {
-  std::vector<SlotWithTimestamp> result;
-  StateHeader header;
-  for (int i = 1; i <= (int)NUM_STATES; i++)
+  const std::string& game_id = SConfig::GetInstance().GetGameID();
+
+  std::lock_guard lk(s_slot_index_mutex);
+  if (!s_slot_index || s_slot_index->GetGameID() != game_id)
   {
-    std::string filename = MakeStateFilename(i);
-    if (File::Exists(filename))
-    {
-      if (ReadHeader(filename, header))
-      {
-        result.emplace_back(SlotWithTimestamp{.slot = i, .timestamp = header.legacy_header.time});
-      }
-    }
+    s_slot_index = std::make_shared<SlotIndex>(
+        File::GetUserPath(D_STATESAVES_IDX), game_id, NUM_STATES, ReadSlotHeader);
   }
-  return result;
+  return s_slot_index;
 }
 
-static void CompressBufferToFile(const u8* raw_buffer, u64 size, File::IOFile& f)
+static std::vector<SlotWithTimestamp> GetUsedSlotsWithTimestamp()
 {
-  u64 total_bytes_compressed = 0;
-
-  while (true)
-  {
-    const u64 bytes_left_to_compress = size - total_bytes_compressed;
-
-    const int bytes_to_compress =
-        static_cast<int>(std::min(static_cast<u64>(LZ4_MAX_INPUT_SIZE), bytes_left_to_compress));
-    Common::UniqueBuffer<char> compressed_buffer(LZ4_compressBound(bytes_to_compress));
-    const int compressed_len = LZ4_compress_default(
-        reinterpret_cast<const char*>(raw_buffer) + total_bytes_compressed, compressed_buffer.get(),
-        bytes_to_compress, int(compressed_buffer.size()));
-
-    if (compressed_len == 0)
-    {
-      PanicAlertFmtT("Internal LZ4 Error - compression failed");
-      break;
-    }
-
-    // The size of the data to write is 'compressed_len'
-    f.WriteArray(&compressed_len, 1);
-    f.WriteBytes(compressed_buffer.get(), compressed_len);
+  std::vector<SlotWithTimestamp> result;
+  for (const auto& [slot, info] : GetSlotIndex()->GetUsedSlots())
+    result.emplace_back(SlotWithTimestamp{.slot = slot, .timestamp = *info.time});
+  return result;
+}
 
-    total_bytes_compressed += bytes_to_compress;
-    if (total_bytes_compressed == size)
-      break;
-  }
+// The size of everything in the extended header after the base header
+static u32 GetPayloadOffset(const StateExtendedHeader& extended_header)
+{
+  return static_cast<u32>(sizeof(u32) * 2 +
+                          extended_header.section_index.size() * sizeof(StateSectionIndexEntry) +
+                          extended_header.thumbnail.size());
 }
 
-static void CreateExtendedHeader(StateExtendedHeader& extended_header, size_t uncompressed_size)
+static void CreateExtendedHeader(StateExtendedHeader& extended_header, size_t uncompressed_size,
+                                 CompressionType compression_type,
+                                 std::vector<StateSectionIndexEntry> section_index,
+                                 std::vector<u8> thumbnail)
 {
+  extended_header.section_index = std::move(section_index);
+  extended_header.thumbnail = std::move(thumbnail);
+
   StateExtendedBaseHeader& base_header = extended_header.base_header;
   base_header.header_version = EXTENDED_HEADER_VERSION;
-  base_header.compression_type =
-      s_use_compression ? CompressionType::LZ4 : CompressionType::Uncompressed;
-  base_header.payload_offset = COMPRESSED_DATA_OFFSET;
+  base_header.compression_type = compression_type;
+  base_header.payload_offset = GetPayloadOffset(extended_header);
   base_header.uncompressed_size = uncompressed_size;
 
   // If more fields are added to StateExtendedHeader, set them here.
 }
 
-static void WriteHeadersToFile(size_t uncompressed_size, File::IOFile& f)
+static void WriteHeadersToFile(double time, size_t uncompressed_size,
+                               CompressionType compression_type,
+                               std::vector<StateSectionIndexEntry> section_index,
+                               std::vector<u8> thumbnail, File::IOFile& f)
 {
   StateHeader header{};
   SConfig::GetInstance().GetGameID().copy(header.legacy_header.game_id,
                                           std::size(header.legacy_header.game_id));
-  header.legacy_header.time = GetSystemTimeAsDouble();
+  header.legacy_header.time = time;
 
   header.version_header.version_cookie = COOKIE_BASE + STATE_VERSION;
   header.version_string = Common::GetScmRevStr();
   header.version_header.version_string_length = static_cast<u32>(header.version_string.length());
 
   StateExtendedHeader extended_header{};
-  CreateExtendedHeader(extended_header, uncompressed_size);
+  CreateExtendedHeader(extended_header, uncompressed_size, compression_type,
+                       std::move(section_index), std::move(thumbnail));
 
   f.WriteArray(&header.legacy_header, 1);
   f.WriteArray(&header.version_header, 1);
   f.WriteString(header.version_string);
 
   f.WriteArray(&extended_header.base_header, 1);
-  // If StateExtendedHeader is amended to include more than the base, add WriteBytes() calls here.
+
+  const u32 section_count = static_cast<u32>(extended_header.section_index.size());
+  const u32 thumbnail_size = static_cast<u32>(extended_header.thumbnail.size());
+  f.WriteArray(&section_count, 1);
+  f.WriteArray(&thumbnail_size, 1);
+  f.WriteArray(extended_header.section_index.data(), extended_header.section_index.size());
+  f.WriteBytes(extended_header.thumbnail.data(), extended_header.thumbnail.size());
+  // If StateExtendedHeader is amended to include more, add WriteBytes() calls here.
 }
 
 static void CompressAndDumpState(Core::System& system, CompressAndDumpState_args& save_args)
 {
   const u8* const buffer_data = save_args.buffer.data();
-  const size_t buffer_size = save_args.buffer.size();
+  const size_t buffer_size = save_args.state_size;
   const std::string& filename = save_args.filename;
 
   // Find free temporary filename.
@@ -398,12 +595,43 @@ static void CompressAndDumpState(Core::System& system, CompressAndDumpState_args
     return;
   }
 
-  WriteHeadersToFile(buffer_size, f);
+  // One part for the prelude, then one for each section
+  std::vector<StateSectionIndexEntry> section_index;
+  size_t part_start = 0;
+  for (size_t i = 0; i <= save_args.section_offsets.size(); ++i)
+  {
+    const size_t part_end =
+        i < save_args.section_offsets.size() ? save_args.section_offsets[i] : buffer_size;
+    StateSectionIndexEntry& entry = section_index.emplace_back();
+    entry.uncompressed_offset = part_start;
+    entry.uncompressed_size = part_end - part_start;
+    const std::string_view name =
+        i == 0 ? PRELUDE_SECTION_NAME : std::string_view(s_full_state_sections[i - 1].name);
+    name.copy(entry.name, std::size(entry.name));
+    part_start = part_end;
+  }
 
-  if (s_use_compression)
-    CompressBufferToFile(buffer_data, buffer_size, f);
-  else
-    f.WriteBytes(buffer_data, buffer_size);
+  const VideoCommon::FrameThumbnail& frame = save_args.thumbnail_frame;
+  SlotHeader slot_header{GetSystemTimeAsDouble(),
+                         EncodeThumbnail(frame.pixels, frame.width, frame.height)};
+  WriteHeadersToFile(slot_header.time, buffer_size, save_args.codec->type, section_index,
+                     slot_header.thumbnail, f);
+
+  const u64 payload_start = f.Tell();
+  for (StateSectionIndexEntry& entry : section_index)
+  {
+    entry.payload_offset = f.Tell() - payload_start;
+    const std::span part(buffer_data + entry.uncompressed_offset, entry.uncompressed_size);
+    if (!save_args.codec->compress(part, save_args.compression_level, f))
+      break;
+    entry.payload_size = f.Tell() - payload_start - entry.payload_offset;
+  }
+
+  // The index was written with placeholder payload ranges, which are only known now
+  f.Seek(static_cast<s64>(payload_start - slot_header.thumbnail.size() -
+                          section_index.size() * sizeof(StateSectionIndexEntry)),
+         File::SeekOrigin::Begin);
+  f.WriteArray(section_index.data(), section_index.size());
 
   if (!f.IsGood())
     Core::DisplayMessage("Failed to write state file", 2000);
@@ -412,6 +640,7 @@ static void CompressAndDumpState(Core::System& system, CompressAndDumpState_args
   const std::string last_state_dtmname = last_state_filename + ".dtm";
   const std::string dtmname = filename + ".dtm";
 
+  bool written = false;
   {
     std::lock_guard lk(s_save_thread_mutex);
 
@@ -453,14 +682,34 @@ static void CompressAndDumpState(Core::System& system, CompressAndDumpState_args
     else
     {
       const std::filesystem::path temp_path(filename);
-      Core::DisplayMessage(fmt::format("Saved State to {}", temp_path.filename().string()), 2000);
+      Core::DisplayMessage(
+          fmt::format(fmt::runtime(save_args.saved_message), temp_path.filename().string()), 2000);
+      written = true;
     }
   }
 
+  // Not done under s_save_thread_mutex, which the index takes when it reads a state's header
+  if (written)
+    GetSlotIndex()->OnStateWritten(filename, std::move(slot_header));
+
   Host_UpdateMainFrame();
 }
 
+static const StateCodec* GetSaveCodec()
+{
+  if (!s_use_compression)
+    return GetStateCodec(CompressionType::Uncompressed);
+
+  const StateCodec* codec = GetStateCodec(Config::Get(Config::MAIN_SAVESTATE_COMPRESSION));
+  return codec ? codec : GetStateCodec(CompressionType::LZ4);
+}
+
 void SaveAs(Core::System& system, const std::string& filename, bool wait)
+{
+  SaveAs(system, filename, SaveOptions{.wait = wait});
+}
+
+void SaveAs(Core::System& system, const std::string& filename, const SaveOptions& options)
 {
   std::unique_lock lk(s_load_or_save_in_progress_mutex, std::try_to_lock);
   if (!lk)
@@ -474,19 +723,16 @@ void SaveAs(Core::System& system, const std::string& filename, bool wait)
           ++s_state_writes_in_queue;
         }
 
-        // Measure the size of the buffer.
-        u8* ptr = nullptr;
-        PointerWrap p_measure(&ptr, 0, PointerWrap::Mode::Measure);
-        DoState(system, p_measure);
-        const size_t buffer_size = ptr - (u8*)(nullptr);
-
-        // Then actually do the write.
-        Common::UniqueBuffer<u8> current_buffer(buffer_size);
-        ptr = current_buffer.data();
-        PointerWrap p(&ptr, buffer_size, PointerWrap::Mode::Write);
-        DoState(system, p);
+        Common::UniqueBuffer<u8> current_buffer;
+        {
+          std::lock_guard lk_(s_spare_save_buffer_mutex);
+          current_buffer = std::move(s_spare_save_buffer);
+        }
 
-        if (p.IsWriteMode())
+        std::vector<size_t> section_offsets;
+        const std::optional<size_t> state_size =
+            WriteStateToBuffer(system, current_buffer, &section_offsets);
+        if (state_size)
         {
           Core::DisplayMessage("Saving State...", 1000);
 
@@ -494,8 +740,18 @@ void SaveAs(Core::System& system, const std::string& filename, bool wait)
 
           CompressAndDumpState_args save_args;
           save_args.buffer = std::move(current_buffer);
+          save_args.state_size = *state_size;
+          save_args.section_offsets = std::move(section_offsets);
+          if (Config::Get(Config::MAIN_SAVESTATE_THUMBNAILS) && g_presenter)
+          {
+            save_args.thumbnail_frame = AsyncRequests::GetInstance()->PushBlockingEvent(
+                [] { return g_presenter->CaptureThumbnail(); });
+          }
           save_args.filename = filename;
-          if (wait)
+          save_args.codec = GetSaveCodec();
+          save_args.compression_level = Config::Get(Config::MAIN_SAVESTATE_COMPRESSION_LEVEL);
+          save_args.saved_message = options.saved_message;
+          if (options.wait)
           {
             sync_event = std::make_shared<Common::Event>();
             save_args.state_write_done_event = sync_event;
@@ -525,13 +781,19 @@ static bool GetVersionFromLZO(StateHeader& header, File::IOFile& f)
 {
   // Just read the first block, since it will contain the full revision string
   lzo_uint32 cur_len = 0;  // size of compressed bytes
-  lzo_uint new_len = 0;    // size of uncompressed bytes
+  lzo_uint new_len = 0;    // size of uncompressed bytes, and the room for them going in
   Common::UniqueBuffer<u8> buffer(header.legacy_header.lzo_size);
 
-  if (!f.ReadArray(&cur_len, 1) || !f.ReadBytes(out, cur_len))
+  if (!f.ReadArray(&cur_len, 1))
     return false;
 
-  const int res = lzo1x_decompress(out, cur_len, buffer.data(), &new_len, nullptr);
+  Common::UniqueBuffer<u8> compressed_block(cur_len);
+  if (!f.ReadBytes(compressed_block.data(), cur_len))
+    return false;
+
+  new_len = buffer.size();
+  const int res =
+      lzo1x_decompress_safe(compressed_block.data(), cur_len, buffer.data(), &new_len, nullptr);
   if (res != LZO_E_OK)
   {
     // This doesn't seem to happen anymore.
@@ -628,84 +890,65 @@ bool ReadHeader(const std::string& filename, StateHeader& header)
   return ReadStateHeaderFromFile(header, f, get_version_header);
 }
 
+// Unlike loading a state, this doesn't show any messages for states that can't be read.
+static std::optional<SlotHeader> ReadSlotHeader(const std::string& filename)
+{
+  // ensure that the savestate write thread isn't moving around states while we do this
+  std::lock_guard lk(s_save_thread_mutex);
+
+  File::IOFile f(filename, "rb");
+  StateHeader header;
+  if (!f.ReadArray(&header.legacy_header, 1))
+    return std::nullopt;
+
+  SlotHeader slot_header{header.legacy_header.time, {}};
+
+  // Only states with a section index can have a thumbnail
+  StateExtendedBaseHeader base_header;
+  u32 section_count;
+  u32 thumbnail_size;
+  if (header.legacy_header.lzo_size != 0 || !f.ReadArray(&header.version_header, 1) ||
+      !f.Seek(header.version_header.version_string_length, File::SeekOrigin::Current) ||
+      !f.ReadArray(&base_header, 1) || base_header.header_version != EXTENDED_HEADER_VERSION ||
+      !f.ReadArray(&section_count, 1) || !f.ReadArray(&thumbnail_size, 1) ||
+      thumbnail_size == 0 ||
+      !f.Seek(s64{section_count} * sizeof(StateSectionIndexEntry), File::SeekOrigin::Current) ||
+      f.Tell() + thumbnail_size > f.GetSize())
+  {
+    return slot_header;
+  }
+
+  slot_header.thumbnail.resize(thumbnail_size);
+  if (!f.ReadBytes(slot_header.thumbnail.data(), slot_header.thumbnail.size()))
+    slot_header.thumbnail.clear();
+  return slot_header;
+}
+
 std::string GetInfoStringOfSlot(int slot, bool translate)
 {
-  std::string filename = MakeStateFilename(slot);
-  if (!File::Exists(filename))
+  const std::optional<SlotInfo> info = GetSlotIndex()->GetSlotInfo(slot);
+  if (!info)
     return translate ? Common::GetStringT("Empty") : "Empty";
 
-  State::StateHeader header;
-  if (!ReadHeader(filename, header))
+  if (!info->time)
     return translate ? Common::GetStringT("Unknown") : "Unknown";
 
-  return SystemTimeAsDoubleToString(header.legacy_header.time);
+  return SystemTimeAsDoubleToString(*info->time);
 }
 
-u64 GetUnixTimeOfSlot(int slot)
+std::vector<u8> GetThumbnailOfSlot(int slot)
 {
-  State::StateHeader header;
-  if (!ReadHeader(MakeStateFilename(slot), header))
-    return 0;
-
-  constexpr u64 MS_PER_SEC = 1000;
-  return static_cast<u64>(header.legacy_header.time * MS_PER_SEC) +
-         (DOUBLE_TIME_OFFSET * MS_PER_SEC);
+  return GetSlotIndex()->GetThumbnail(slot);
 }
 
-static bool DecompressLZ4(Common::UniqueBuffer<u8>& raw_buffer, u64 size, File::IOFile& f)
+u64 GetUnixTimeOfSlot(int slot)
 {
-  raw_buffer.reset(size);
-
-  u64 total_bytes_read = 0;
-  while (true)
-  {
-    s32 compressed_data_len;
-    if (!f.ReadArray(&compressed_data_len, 1))
-    {
-      PanicAlertFmt("Could not read state data length");
-      return false;
-    }
-
-    if (compressed_data_len <= 0)
-    {
-      PanicAlertFmtT("Internal LZ4 Error - Tried decompressing {0} bytes", compressed_data_len);
-      return false;
-    }
-
-    Common::UniqueBuffer<char> compressed_data(compressed_data_len);
-    if (!f.ReadBytes(compressed_data.get(), compressed_data_len))
-    {
-      PanicAlertFmt("Could not read state data");
-      return false;
-    }
-
-    u32 max_decompress_size =
-        static_cast<u32>(std::min((u64)LZ4_MAX_INPUT_SIZE, size - total_bytes_read));
-
-    int bytes_read = LZ4_decompress_safe(
-        compressed_data.get(), reinterpret_cast<char*>(raw_buffer.data()) + total_bytes_read,
-        compressed_data_len, max_decompress_size);
-
-    if (bytes_read < 0)
-    {
-      PanicAlertFmtT("Internal LZ4 Error - decompression failed ({0}, {1}, {2})", bytes_read,
-                     compressed_data_len, max_decompress_size);
-      return false;
-    }
-
-    total_bytes_read += static_cast<u64>(bytes_read);
+  const std::optional<SlotInfo> info = GetSlotIndex()->GetSlotInfo(slot);
+  if (!info || !info->time)
+    return 0;
 
-    if (total_bytes_read == size)
-    {
-      return true;
-    }
-    else if (total_bytes_read > size)
-    {
-      PanicAlertFmtT("Internal LZ4 Error - payload size mismatch ({0} / {1}))", total_bytes_read,
-                     size);
-      return false;
-    }
-  }
+  constexpr u64 MS_PER_SEC = 1000;
+  return static_cast<u64>(*info->time * MS_PER_SEC) + (DOUBLE_TIME_OFFSET * MS_PER_SEC);
 }
 
 static bool ValidateHeaders(const StateHeader& header)
@@ -738,7 +981,8 @@ static bool ValidateHeaders(const StateHeader& header)
 
     loaded_str = "Dolphin " + oldest_version + " - " + newest_version;
   }
-  else if (loaded_version != STATE_VERSION)
+  else if (loaded_version != STATE_VERSION &&
+           loaded_version != STATE_VERSION_WITHOUT_SECTION_INDEX)
   {
     success = false;
   }
@@ -755,7 +999,20 @@ static bool ValidateHeaders(const StateHeader& header)
   return success;
 }
 
-static void LoadFileStateData(const std::string& filename, Common::UniqueBuffer<u8>& ret_data)
+namespace
+{
+// A state file opened for loading. The file is mapped rather than read, so the payload is only
+// paged in as it gets decoded.
+struct StateFile
+{
+  File::MappedFile file;
+  StateExtendedHeader extended_header;
+  const StateCodec* codec = nullptr;
+  std::span<const u8> payload;
+};
+}  // namespace
+
+static bool OpenStateFile(const std::string& filename, StateFile& state_file)
 {
   File::IOFile f;
 
@@ -769,7 +1026,7 @@ static void LoadFileStateData(const std::string& filename, Common::UniqueBuffer<
       {
         Core::DisplayMessage(
             "A previous state saving operation is still in progress, cancelling load.", 2000);
-        return;
+        return false;
       }
     }
     f.Open(filename, "rb");
@@ -777,64 +1034,185 @@ static void LoadFileStateData(const std::string& filename, Common::UniqueBuffer<
 
   StateHeader header;
   if (!ReadStateHeaderFromFile(header, f) || !ValidateHeaders(header))
-    return;
+    return false;
 
-  StateExtendedHeader extended_header;
+  StateExtendedHeader& extended_header = state_file.extended_header;
   if (!f.ReadArray(&extended_header.base_header, 1))
   {
     PanicAlertFmt("Unable to read state header");
-    return;
+    return false;
   }
-  // If StateExtendedHeader is amended to include more than the base, add ReadBytes() calls here.
 
-  if (extended_header.base_header.header_version != EXTENDED_HEADER_VERSION)
+  const u32 loaded_version = header.version_header.version_cookie - COOKIE_BASE;
+  const u16 header_version = extended_header.base_header.header_version;
+  if (header_version != (loaded_version == STATE_VERSION_WITHOUT_SECTION_INDEX ?
+                             EXTENDED_HEADER_VERSION_WITHOUT_SECTION_INDEX :
+                             EXTENDED_HEADER_VERSION))
   {
     PanicAlertFmt("State header corrupted");
-    return;
+    return false;
   }
 
-  Common::UniqueBuffer<u8> buffer;
-
-  switch (extended_header.base_header.compression_type)
+  if (header_version != EXTENDED_HEADER_VERSION_WITHOUT_SECTION_INDEX)
   {
-  case CompressionType::LZ4:
+    // The thumbnail isn't needed for loading, and is skipped over by the payload offset
+    u32 section_count;
+    u32 thumbnail_size;
+    if (!f.ReadArray(&section_count, 1) || !f.ReadArray(&thumbnail_size, 1))
+    {
+      PanicAlertFmt("Unable to read state header");
+      return false;
+    }
+
+    // Which sections are there is checked by name when loading
+    if (section_count > f.GetSize() / sizeof(StateSectionIndexEntry))
+    {
+      PanicAlertFmt("State section index corrupted");
+      return false;
+    }
+
+    extended_header.section_index.resize(section_count);
+    if (!f.ReadArray(extended_header.section_index.data(), section_count))
+    {
+      PanicAlertFmt("Unable to read state header");
+      return false;
+    }
+  }
+  // If StateExtendedHeader is amended to include more, add ReadBytes() calls here.
+
+  const auto compression_type =
+      static_cast<CompressionType>(extended_header.base_header.compression_type);
+  state_file.codec = GetStateCodec(compression_type);
+  if (!state_file.codec)
   {
-    Core::DisplayMessage("Decompressing State...", OSD::Duration::SHORT);
-    if (!DecompressLZ4(buffer, extended_header.base_header.uncompressed_size, f))
-      return;
+    PanicAlertFmt("Unknown compression type {0}", extended_header.base_header.compression_type);
+    return false;
+  }
+
+  u64 header_len = sizeof(StateHeaderLegacy) + sizeof(StateHeaderVersion) +
+                   header.version_header.version_string_length + sizeof(StateExtendedBaseHeader) +
+                   extended_header.base_header.payload_offset;
 
-    break;
+  f.Close();
+  if (!state_file.file.Open(filename))
+  {
+    Core::DisplayMessage("State not found", 2000);
+    return false;
   }
-  case CompressionType::Uncompressed:
+
+  const std::span<const u8> file_data = state_file.file.GetData();
+  if (file_data.size() < header_len)
   {
-    u64 header_len = sizeof(StateHeaderLegacy) + sizeof(StateHeaderVersion) +
-                     header.version_header.version_string_length + sizeof(StateExtendedBaseHeader) +
-                     extended_header.base_header.payload_offset;
+    PanicAlertFmt("State header length corrupted");
+    return false;
+  }
+  state_file.payload = file_data.subspan(header_len);
 
-    u64 file_size = f.GetSize();
-    if (file_size < header_len)
+  const u64 uncompressed_size = extended_header.base_header.uncompressed_size;
+  const u64 payload_size = state_file.payload.size();
+  for (const StateSectionIndexEntry& entry : extended_header.section_index)
+  {
+    if (entry.payload_offset > payload_size ||
+        entry.payload_size > payload_size - entry.payload_offset ||
+        entry.uncompressed_offset > uncompressed_size ||
+        entry.uncompressed_size > uncompressed_size - entry.uncompressed_offset)
     {
-      PanicAlertFmt("State header length corrupted");
-      return;
+      PanicAlertFmt("State section index corrupted");
+      return false;
     }
+  }
 
-    const auto size = static_cast<size_t>(file_size - header_len);
-    buffer.reset(size);
+  if (compression_type != CompressionType::Uncompressed)
+    Core::DisplayMessage("Decompressing State...", OSD::Duration::SHORT);
+
+  return true;
+}
 
-    if (!f.ReadBytes(buffer.data(), size))
+// Gets the uncompressed bytes of an encoded part of the payload. Uncompressed parts are used
+// straight from the mapped file, anything else is decoded into buffer, which is only ever grown.
+static bool DecodeStatePart(const StateCodec& codec, std::span<const u8> encoded, size_t size,
+                            Common::UniqueBuffer<u8>& buffer, std::span<const u8>* decoded)
+{
+  if (codec.type == CompressionType::Uncompressed)
+  {
+    if (encoded.size() < size)
     {
       PanicAlertFmt("Error reading bytes: {0}", size);
-      return;
+      return false;
     }
-    break;
+    *decoded = encoded.first(size);
+    return true;
   }
-  default:
-    PanicAlertFmt("Unknown compression type {0}", extended_header.base_header.compression_type);
-    return;
+
+  if (buffer.size() < size)
+    buffer.reset(size);
+
+  const std::span data(buffer.data(), size);
+  if (!codec.decompress(encoded, data))
+    return false;
+
+  *decoded = data;
+  return true;
+}
+
+// Returns whether the whole state was read. With a section index, the payload is decoded and
+// loaded one section at a time, so no more than the largest section is ever held decompressed.
+static bool LoadStateFile(Core::System& system, const StateFile& state_file)
+{
+  const StateExtendedHeader& extended_header = state_file.extended_header;
+  Common::UniqueBuffer<u8> buffer;
+  std::span<const u8> data;
+
+  const auto read = [&](const auto& do_state) {
+    // PointerWrap doesn't write to the data in read mode, which the mapped file relies on
+    u8* ptr = const_cast<u8*>(data.data());
+    PointerWrap p(&ptr, data.size(), PointerWrap::Mode::Read);
+    do_state(p);
+    return p.IsReadMode();
+  };
+
+  if (extended_header.section_index.empty())
+  {
+    const size_t size = static_cast<size_t>(extended_header.base_header.uncompressed_size);
+    return DecodeStatePart(*state_file.codec, state_file.payload, size, buffer, &data) &&
+           read([&](PointerWrap& p) { DoState(system, p); });
+  }
+
+  // The parts are in the order they have to be loaded in, so each one is only looked for after the
+  // one before. Parts this build doesn't know about are skipped, like the data at the end of a
+  // state without an index would be.
+  const std::vector<StateSectionIndexEntry>& index = extended_header.section_index;
+  auto next_entry = index.begin();
+  const auto load_part = [&](std::string_view name, const auto& do_state) {
+    const auto entry = std::find_if(next_entry, index.end(), [name](const auto& candidate) {
+      return std::string_view(candidate.name, strnlen(candidate.name, std::size(candidate.name))) ==
+             name;
+    });
+    if (entry == index.end())
+    {
+      Core::DisplayMessage(fmt::format("This savestate has no {} section", name),
+                           OSD::Duration::NORMAL);
+      return false;
+    }
+    next_entry = entry + 1;
+
+    const std::span encoded = state_file.payload.subspan(static_cast<size_t>(entry->payload_offset),
+                                                         static_cast<size_t>(entry->payload_size));
+    return DecodeStatePart(*state_file.codec, encoded,
+                           static_cast<size_t>(entry->uncompressed_size), buffer, &data) &&
+           read(do_state);
+  };
+
+  if (!load_part(PRELUDE_SECTION_NAME, [&](PointerWrap& p) { DoStatePrelude(system, p); }))
+    return false;
+
+  for (const StateSection& section : s_full_state_sections)
+  {
+    if (!load_part(section.name, [&](PointerWrap& p) { DoStateSection(system, p, section); }))
+      return false;
   }
 
-  // all good
-  ret_data.swap(buffer);
+  return true;
 }
 
 void LoadAs(Core::System& system, const std::string& filename)
@@ -877,23 +1255,20 @@ void LoadAs(Core::System& system, const std::string& filename)
         bool loaded = false;
         bool loadedSuccessfully = false;
 
-        // brackets here are so buffer gets freed ASAP
+        // brackets here are so the file gets unmapped ASAP
         {
-          Common::UniqueBuffer<u8> buffer;
-          LoadFileStateData(filename, buffer);
-
-          if (!buffer.empty())
+          StateFile state_file;
+          if (OpenStateFile(filename, state_file))
           {
-            u8* ptr = buffer.data();
-            PointerWrap p(&ptr, buffer.size(), PointerWrap::Mode::Read);
-            DoState(system, p);
             loaded = true;
-            loadedSuccessfully = p.IsReadMode();
+            loadedSuccessfully = LoadStateFile(system, state_file);
           }
         }
 
         if (loaded)
         {
+          ClearRewindHistory();
+
           if (loadedSuccessfully)
           {
             std::filesystem::path tempfilename(filename);
@@ -925,11 +1300,43 @@ void SetOnAfterLoadCallback(AfterLoadCallbackFunc callback)
   s_on_after_load_callback = std::move(callback);
 }
 
+static void AddRewindSnapshot(RewindSnapshot snapshot)
+{
+  {
+    std::lock_guard lk(s_rewind_buffer_mutex);
+    if (!s_rewind_buffer)
+    {
+      s_rewind_buffer =
+          std::make_unique<RewindBuffer>(snapshot.memory_budget, REWIND_SNAPSHOTS_PER_KEYFRAME);
+    }
+    else
+    {
+      s_rewind_buffer->SetMemoryBudget(snapshot.memory_budget);
+    }
+    s_rewind_buffer->Push(std::span(snapshot.buffer.data(), snapshot.state_size));
+  }
+
+  {
+    std::lock_guard lk(s_rewind_free_buffers_mutex);
+    s_rewind_free_buffers.push_back(std::move(snapshot.buffer));
+  }
+  --s_rewind_snapshots_in_flight;
+}
+
 void Init(Core::System& system)
 {
+  s_state_size_hint = 0;
+  s_frames_until_rewind_snapshot = 0;
+  s_rewind_thread.Reset("Rewind Worker", AddRewindSnapshot);
+
   s_save_thread.Reset("Savestate Worker", [&system](CompressAndDumpState_args args) {
     CompressAndDumpState(system, args);
 
+    {
+      std::lock_guard lk(s_spare_save_buffer_mutex);
+      s_spare_save_buffer = std::move(args.buffer);
+    }
+
     {
       std::lock_guard lk(s_state_writes_in_queue_mutex);
       if (--s_state_writes_in_queue == 0)
@@ -944,6 +1351,24 @@ void Init(Core::System& system)
 void Shutdown()
 {
   s_save_thread.Shutdown();
+  {
+    std::lock_guard lk(s_slot_index_mutex);
+    s_slot_index.reset();
+  }
+  {
+    std::lock_guard lk(s_spare_save_buffer_mutex);
+    s_spare_save_buffer.reset();
+  }
+
+  s_rewind_thread.Shutdown();
+  {
+    std::lock_guard lk(s_rewind_buffer_mutex);
+    s_rewind_buffer.reset();
+  }
+  {
+    std::lock_guard lk(s_rewind_free_buffers_mutex);
+    s_rewind_free_buffers.clear();
+  }
 
   std::lock_guard lk(s_undo_load_buffer_mutex);
   s_undo_load_buffer.reset();
@@ -951,8 +1376,8 @@ void Shutdown()
 
 static std::string MakeStateFilename(int number)
 {
-  return fmt::format("{}{}.s{:02d}", File::GetUserPath(D_STATESAVES_IDX),
-                     SConfig::GetInstance().GetGameID(), number);
+  return File::GetUserPath(D_STATESAVES_IDX) +
+         MakeSlotFilename(SConfig::GetInstance().GetGameID(), number);
 }
 
 void Save(Core::System& system, int slot, bool wait)
@@ -960,6 +1385,11 @@ void Save(Core::System& system, int slot, bool wait)
   SaveAs(system, MakeStateFilename(slot), wait);
 }
 
+void Save(Core::System& system, int slot, const SaveOptions& options)
+{
+  SaveAs(system, MakeStateFilename(slot), options);
+}
+
 void Load(Core::System& system, int slot)
 {
   LoadAs(system, MakeStateFilename(slot));
@@ -1037,4 +1467,103 @@ void UndoSaveState(Core::System& system)
   LoadAs(system, File::GetUserPath(D_STATESAVES_IDX) + "lastState.sav");
 }
 
+void OnFrameForRewind(Core::System& system)
+{
+  // Rewinding would desync NetPlay and movies, the same as loading any other state.
+  if (!Config::Get(Config::MAIN_REWIND_ENABLED) || NetPlay::IsNetPlayRunning() ||
+      system.GetMovie().IsMovieActive() ||
+      AchievementManager::GetInstance().IsHardcoreModeActive())
+  {
+    return;
+  }
+
+  if (s_frames_until_rewind_snapshot > 0)
+  {
+    --s_frames_until_rewind_snapshot;
+    return;
+  }
+
+  // Rather than piling up snapshots if the worker can't keep up, try again next frame
+  if (s_rewind_snapshots_in_flight >= MAX_REWIND_SNAPSHOTS_IN_FLIGHT)
+    return;
+
+  s_frames_until_rewind_snapshot = std::max<u32>(Config::Get(Config::MAIN_REWIND_FRAMES), 1) - 1;
+
+  RewindSnapshot snapshot;
+  snapshot.memory_budget = size_t(Config::Get(Config::MAIN_REWIND_MEMORY_MB)) * 1024 * 1024;
+  {
+    std::lock_guard lk(s_rewind_free_buffers_mutex);
+    if (!s_rewind_free_buffers.empty())
+    {
+      snapshot.buffer = std::move(s_rewind_free_buffers.back());
+      s_rewind_free_buffers.pop_back();
+    }
+  }
+
+  snapshot.state_size = SaveToBuffer(system, snapshot.buffer);
+  if (snapshot.state_size == 0)
+  {
+    std::lock_guard lk(s_rewind_free_buffers_mutex);
+    s_rewind_free_buffers.push_back(std::move(snapshot.buffer));
+    return;
+  }
+
+  ++s_rewind_snapshots_in_flight;
+  s_rewind_thread.Push(std::move(snapshot));
+}
+
+void Rewind(Core::System& system)
+{
+  if (!Core::IsRunningOrStarting(system))
+    return;
+
+  if (NetPlay::IsNetPlayRunning())
+  {
+    OSD::AddMessage("Rewinding is disabled in Netplay to prevent desyncs");
+    return;
+  }
+
+  if (AchievementManager::GetInstance().IsHardcoreModeActive())
+  {
+    OSD::AddMessage("Rewinding is disabled in RetroAchievements hardcore mode");
+    return;
+  }
+
+  std::unique_lock lk(s_load_or_save_in_progress_mutex, std::try_to_lock);
+  if (!lk)
+    return;
+
+  Core::RunOnCPUThread(
+      system,
+      [&] {
+        // Snapshots that are still being compressed are the newest ones
+        s_rewind_thread.WaitForCompletion();
+
+        Common::UniqueBuffer<u8> state;
+        bool popped;
+        {
+          std::lock_guard lk2(s_rewind_buffer_mutex);
+          popped = s_rewind_buffer && s_rewind_buffer->PopNewest(state);
+        }
+        if (!popped)
+        {
+          Core::DisplayMessage("There is nothing to rewind to", 2000);
+          return;
+        }
+
+        u8* ptr = state.data();
+        PointerWrap p(&ptr, state.size(), PointerWrap::Mode::Read);
+        DoState(system, p);
+        if (!p.IsReadMode())
+          Core::DisplayMessage("The rewind snapshot could not be loaded", OSD::Duration::NORMAL);
+
+        // Give the next step back some distance from the state we just went back to
+        s_frames_until_rewind_snapshot = std::max<u32>(Config::Get(Config::MAIN_REWIND_FRAMES), 1);
+
+        if (s_on_after_load_callback)
+          s_on_after_load_callback();
+      },
+      true);
+}
+
 }  // namespace State
@@ -9,6 +9,7 @@
 #include <functional>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "Common/Buffer.h"
 #include "Common/CommonTypes.h"
@@ -55,6 +56,11 @@ enum CompressionType : u16
 {
   Uncompressed = 0,
   LZ4 = 1,
+  // The chunked types split the payload into independently compressed chunks, so that saving and
+  // loading can use every core. See StateCodec.cpp for the layout.
+  ChunkedLZ4 = 2,
+  ChunkedZstd = 3,
+  ChunkedLZO = 4,
   // Add new compression types after this, as the compression type
   // is numerically stored in the state file.
 };
@@ -72,14 +78,45 @@ static_assert(offsetof(StateExtendedBaseHeader, payload_offset) == 4);
 static_assert(offsetof(StateExtendedBaseHeader, uncompressed_size) == 8);
 static_assert(std::is_trivially_copyable_v<StateExtendedBaseHeader>);
 
+// Written after the base header as a u32 count, the u32 size of the thumbnail and then the entries,
+// followed by the thumbnail.
+struct StateSectionIndexEntry
+{
+  u64 uncompressed_offset;
+  u64 uncompressed_size;
+  // Relative to the start of the payload
+  u64 payload_offset;
+  u64 payload_size;
+  // Which section this is, padded with zeros. Loading looks the sections up by it, as which ones
+  // there are depends on the build.
+  char name[16];
+};
+static_assert(sizeof(StateSectionIndexEntry) == 48);
+static_assert(std::is_trivially_copyable_v<StateSectionIndexEntry>);
+
 struct StateExtendedHeader
 {
   StateExtendedBaseHeader base_header;
-  // Feel free to add new fields here, adjusting COMPRESSED_DATA_OFFSET accordingly, as well as
-  // CreateExtendedHeader(). Add the appropriate IOFile read/write calls within LoadFileStateData()
+  // The payload is made of separately encoded parts: the checks at the start of the state, then one
+  // part for each section. This lets a load decode one section at a time. Empty in states with
+  // extended header version 1, where the payload is encoded as a whole.
+  std::vector<StateSectionIndexEntry> section_index;
+  // PNG file of the last frame before the state was saved, empty if there is none. Kept out of the
+  // payload, so that it can be shown without decoding anything.
+  std::vector<u8> thumbnail;
+  // Feel free to add new fields here, adjusting GetPayloadOffset() accordingly, as well as
+  // CreateExtendedHeader(). Add the appropriate IOFile read/write calls within OpenStateFile()
   // and WriteHeadersToFile()
 };
 
+struct SaveOptions
+{
+  bool wait = false;
+
+  // Shown once the state is on disk. {} is replaced with the name of the state file.
+  std::string saved_message = "Saved State to {}";
+};
+
 void Init(Core::System& system);
 
 void Shutdown();
@@ -95,25 +132,52 @@ std::string GetInfoStringOfSlot(int slot, bool translate = true);
 // Returns when the savestate in the given slot was created, or 0 if the slot is empty.
 u64 GetUnixTimeOfSlot(int slot);
 
+// Returns the thumbnail of the savestate in the given slot as a PNG file, or nothing if the slot is
+// empty or the state has no thumbnail.
+std::vector<u8> GetThumbnailOfSlot(int slot);
+
 // These don't happen instantly - they get scheduled as events.
 // ...But only if we're not in the main CPU thread.
 //    If we're in the main CPU thread then they run immediately instead
 //    because some things (like Lua) need them to run immediately.
 // Slots from 0-99.
 void Save(Core::System& system, int slot, bool wait = false);
+void Save(Core::System& system, int slot, const SaveOptions& options);
 void Load(Core::System& system, int slot);
 
 void SaveAs(Core::System& system, const std::string& filename, bool wait = false);
+void SaveAs(Core::System& system, const std::string& filename, const SaveOptions& options);
 void LoadAs(Core::System& system, const std::string& filename);
 
-void SaveToBuffer(Core::System& system, Common::UniqueBuffer<u8>& buffer);
+// Writes the state to the start of the buffer and returns its size. The buffer can be bigger than
+// the state, as it's only grown and never shrunk so that it can be reused without reallocating.
+// Loading a buffer ignores anything after the state. If the state couldn't be written, the buffer
+// is emptied and 0 is returned.
+size_t SaveToBuffer(Core::System& system, Common::UniqueBuffer<u8>& buffer);
 void LoadFromBuffer(Core::System& system, const Common::UniqueBuffer<u8>& buffer);
 
+// Restores a buffer written by SaveToBuffer immediately, even while NetPlay is running.
+// Only meant for NetPlay spectators joining a game in progress. Must be called from the CPU thread,
+// outside of CoreTiming::Advance.
+bool LoadFromKeyframeBuffer(Core::System& system, Common::UniqueBuffer<u8>& buffer);
+
+// Like SaveToBuffer and LoadFromKeyframeBuffer, but leaves out the video backend and the movie so
+// that saving doesn't have to wait for the GPU thread. Only meant for NetPlay rollback, which takes
+// one of these every frame. Must be called from the CPU thread, outside of CoreTiming::Advance.
+size_t SaveToRollbackBuffer(Core::System& system, Common::UniqueBuffer<u8>& buffer);
+bool LoadFromRollbackBuffer(Core::System& system, Common::UniqueBuffer<u8>& buffer);
+
 void LoadLastSaved(Core::System& system, int i = 1);
 void SaveFirstSaved(Core::System& system);
 void UndoSaveState(Core::System& system);
 void UndoLoadState(Core::System& system);
 
+// Takes a rewind snapshot every MAIN_REWIND_FRAMES frames while rewinding is enabled. Must be
+// called from the CPU thread at the end of each frame.
+void OnFrameForRewind(Core::System& system);
+// Loads the newest rewind snapshot and forgets it, so that repeated calls keep stepping back.
+void Rewind(Core::System& system);
+
 // for calling back into UI code without introducing a dependency on it in core
 using AfterLoadCallbackFunc = std::function<void()>;
 void SetOnAfterLoadCallback(AfterLoadCallbackFunc callback);
@@ -0,0 +1,426 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/StateCodec.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <lz4.h>
+#include <lzo/lzo1x.h>
+#include <zstd.h>
+
+#include "Common/Buffer.h"
+#include "Common/IOFile.h"
+#include "Common/MsgHandler.h"
+#include "Common/WorkQueueThread.h"
+
+namespace State
+{
+static bool CompressUncompressed(std::span<const u8> data, int, File::IOFile& f)
+{
+  return f.WriteBytes(data.data(), data.size());
+}
+
+static bool DecompressUncompressed(std::span<const u8> payload, std::span<u8> data)
+{
+  if (payload.size() < data.size())
+  {
+    PanicAlertFmt("Error reading bytes: {0}", data.size());
+    return false;
+  }
+
+  std::ranges::copy(payload.first(data.size()), data.begin());
+  return true;
+}
+
+static bool CompressLZ4(std::span<const u8> data, int, File::IOFile& f)
+{
+  const u64 size = data.size();
+  u64 total_bytes_compressed = 0;
+
+  while (true)
+  {
+    const u64 bytes_left_to_compress = size - total_bytes_compressed;
+
+    const int bytes_to_compress =
+        static_cast<int>(std::min(static_cast<u64>(LZ4_MAX_INPUT_SIZE), bytes_left_to_compress));
+    Common::UniqueBuffer<char> compressed_buffer(LZ4_compressBound(bytes_to_compress));
+    const int compressed_len = LZ4_compress_default(
+        reinterpret_cast<const char*>(data.data()) + total_bytes_compressed,
+        compressed_buffer.get(), bytes_to_compress, int(compressed_buffer.size()));
+
+    if (compressed_len == 0)
+    {
+      PanicAlertFmtT("Internal LZ4 Error - compression failed");
+      return false;
+    }
+
+    // The size of the data to write is 'compressed_len'
+    f.WriteArray(&compressed_len, 1);
+    f.WriteBytes(compressed_buffer.get(), compressed_len);
+
+    total_bytes_compressed += bytes_to_compress;
+    if (total_bytes_compressed == size)
+      return true;
+  }
+}
+
+static bool DecompressLZ4(std::span<const u8> payload, std::span<u8> data)
+{
+  const u64 size = data.size();
+  u64 total_bytes_read = 0;
+  size_t in_offset = 0;
+  while (true)
+  {
+    s32 compressed_data_len;
+    if (payload.size() - in_offset < sizeof(compressed_data_len))
+    {
+      PanicAlertFmt("Could not read state data length");
+      return false;
+    }
+    std::memcpy(&compressed_data_len, payload.data() + in_offset, sizeof(compressed_data_len));
+    in_offset += sizeof(compressed_data_len);
+
+    if (compressed_data_len <= 0)
+    {
+      PanicAlertFmtT("Internal LZ4 Error - Tried decompressing {0} bytes", compressed_data_len);
+      return false;
+    }
+
+    if (payload.size() - in_offset < static_cast<size_t>(compressed_data_len))
+    {
+      PanicAlertFmt("Could not read state data");
+      return false;
+    }
+    const u8* const compressed_data = payload.data() + in_offset;
+    in_offset += compressed_data_len;
+
+    u32 max_decompress_size =
+        static_cast<u32>(std::min((u64)LZ4_MAX_INPUT_SIZE, size - total_bytes_read));
+
+    int bytes_read = LZ4_decompress_safe(
+        reinterpret_cast<const char*>(compressed_data),
+        reinterpret_cast<char*>(data.data()) + total_bytes_read, compressed_data_len,
+        max_decompress_size);
+
+    if (bytes_read < 0)
+    {
+      PanicAlertFmtT("Internal LZ4 Error - decompression failed ({0}, {1}, {2})", bytes_read,
+                     compressed_data_len, max_decompress_size);
+      return false;
+    }
+
+    total_bytes_read += static_cast<u64>(bytes_read);
+
+    if (total_bytes_read == size)
+    {
+      return true;
+    }
+    else if (total_bytes_read > size)
+    {
+      PanicAlertFmtT("Internal LZ4 Error - payload size mismatch ({0} / {1}))", total_bytes_read,
+                     size);
+      return false;
+    }
+  }
+}
+
+// Chunked payload layout:
+//
+//   ChunkedPayloadHeader
+//   for each chunk: u32 compressed size, then the compressed bytes
+//
+// Every chunk but the last holds chunk_size uncompressed bytes, so the place each chunk
+// decompresses to is known up front and all chunks can be handled at the same time.
+namespace
+{
+// Increase this if the chunked layout above changes.
+constexpr u32 CHUNKED_PAYLOAD_VERSION = 1;
+
+constexpr u32 CHUNK_SIZE = 1024 * 1024;
+
+struct ChunkedPayloadHeader
+{
+  u32 version;
+  u32 chunk_size;
+};
+static_assert(std::is_trivially_copyable_v<ChunkedPayloadHeader>);
+
+// Per-thread scratch state, set up lazily by whichever chunk codec needs it.
+struct ChunkThreadState
+{
+  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> zstd_cctx{nullptr, ZSTD_freeCCtx};
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> zstd_dctx{nullptr, ZSTD_freeDCtx};
+  Common::UniqueBuffer<u8> lzo_work_memory;
+};
+
+struct ChunkCodec
+{
+  size_t (*compress_bound)(size_t size);
+
+  // Returns the compressed size, or 0 on failure.
+  size_t (*compress)(ChunkThreadState* state, std::span<const u8> in, std::span<u8> out,
+                     int level);
+
+  // Must fill out exactly.
+  bool (*decompress)(ChunkThreadState* state, std::span<const u8> in, std::span<u8> out);
+};
+
+constexpr ChunkCodec s_lz4_chunk_codec = {
+    [](size_t size) -> size_t { return LZ4_compressBound(static_cast<int>(size)); },
+    [](ChunkThreadState*, std::span<const u8> in, std::span<u8> out, int) -> size_t {
+      const int result = LZ4_compress_default(
+          reinterpret_cast<const char*>(in.data()), reinterpret_cast<char*>(out.data()),
+          static_cast<int>(in.size()), static_cast<int>(out.size()));
+      return std::max(result, 0);
+    },
+    [](ChunkThreadState*, std::span<const u8> in, std::span<u8> out) {
+      const int result = LZ4_decompress_safe(
+          reinterpret_cast<const char*>(in.data()), reinterpret_cast<char*>(out.data()),
+          static_cast<int>(in.size()), static_cast<int>(out.size()));
+      return result >= 0 && static_cast<size_t>(result) == out.size();
+    },
+};
+
+constexpr ChunkCodec s_zstd_chunk_codec = {
+    [](size_t size) { return ZSTD_compressBound(size); },
+    [](ChunkThreadState* state, std::span<const u8> in, std::span<u8> out, int level) -> size_t {
+      if (!state->zstd_cctx)
+        state->zstd_cctx.reset(ZSTD_createCCtx());
+      if (!state->zstd_cctx)
+        return 0;
+
+      const size_t result = ZSTD_compressCCtx(state->zstd_cctx.get(), out.data(), out.size(),
+                                              in.data(), in.size(), level);
+      return ZSTD_isError(result) ? 0 : result;
+    },
+    [](ChunkThreadState* state, std::span<const u8> in, std::span<u8> out) {
+      if (!state->zstd_dctx)
+        state->zstd_dctx.reset(ZSTD_createDCtx());
+      if (!state->zstd_dctx)
+        return false;
+
+      const size_t result = ZSTD_decompressDCtx(state->zstd_dctx.get(), out.data(), out.size(),
+                                                in.data(), in.size());
+      return !ZSTD_isError(result) && result == out.size();
+    },
+};
+
+constexpr ChunkCodec s_lzo_chunk_codec = {
+    [](size_t size) { return size + (size / 16) + 64 + 3; },
+    [](ChunkThreadState* state, std::span<const u8> in, std::span<u8> out, int) -> size_t {
+      if (state->lzo_work_memory.empty())
+        state->lzo_work_memory.reset(LZO1X_1_MEM_COMPRESS);
+
+      lzo_uint out_len = out.size();
+      if (lzo1x_1_compress(in.data(), in.size(), out.data(), &out_len,
+                           state->lzo_work_memory.data()) != LZO_E_OK)
+      {
+        return 0;
+      }
+      return out_len;
+    },
+    [](ChunkThreadState*, std::span<const u8> in, std::span<u8> out) {
+      lzo_uint out_len = out.size();
+      return lzo1x_decompress_safe(in.data(), in.size(), out.data(), &out_len, nullptr) ==
+                 LZO_E_OK &&
+             out_len == out.size();
+    },
+};
+
+struct CompressedChunk
+{
+  Common::UniqueBuffer<u8> data;
+  u32 size = 0;
+};
+
+struct ChunkToDecompress
+{
+  std::span<const u8> in;
+  std::span<u8> out;
+};
+
+// Runs the chunk codecs. The threads are started the first time a chunked payload is handled and
+// kept around after that, rather than starting a set of them for every payload.
+class ChunkWorkers
+{
+public:
+  ChunkWorkers()
+  {
+    const unsigned int count = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < count; ++i)
+      m_workers.push_back(std::make_unique<Worker>());
+  }
+
+  // Calls function for every chunk index below count, spread over the threads, and waits for all
+  // of them. Returns false if any of the calls did.
+  bool ForEachChunk(size_t count, const std::function<bool(ChunkThreadState*, size_t)>& function)
+  {
+    std::atomic<bool> success = true;
+    for (size_t first = 0; first < m_workers.size(); ++first)
+    {
+      Worker& worker = *m_workers[first];
+      worker.thread.Push([&, first] {
+        for (size_t i = first; i < count && success; i += m_workers.size())
+        {
+          if (!function(&worker.state, i))
+            success = false;
+        }
+      });
+    }
+
+    for (const auto& worker : m_workers)
+      worker->thread.WaitForCompletion();
+
+    return success;
+  }
+
+private:
+  struct Worker
+  {
+    // Only touched on the worker's own thread
+    ChunkThreadState state;
+    Common::AsyncWorkThread thread{"Savestate Codec"};
+  };
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+};
+
+ChunkWorkers& GetChunkWorkers()
+{
+  static ChunkWorkers s_workers;
+  return s_workers;
+}
+}  // namespace
+
+static bool CompressChunked(const ChunkCodec& codec, std::span<const u8> data, int level,
+                            File::IOFile& f)
+{
+  const ChunkedPayloadHeader header{CHUNKED_PAYLOAD_VERSION, CHUNK_SIZE};
+  if (!f.WriteArray(&header, 1))
+    return false;
+
+  std::vector<CompressedChunk> chunks((data.size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+  const bool compressed = GetChunkWorkers().ForEachChunk(
+      chunks.size(), [&](ChunkThreadState* state, size_t i) {
+        const size_t offset = i * CHUNK_SIZE;
+        const auto chunk = data.subspan(offset, std::min<size_t>(CHUNK_SIZE, data.size() - offset));
+
+        CompressedChunk& compressed_chunk = chunks[i];
+        compressed_chunk.data.reset(codec.compress_bound(chunk.size()));
+        const size_t size = codec.compress(state, chunk, compressed_chunk.data, level);
+        compressed_chunk.size = static_cast<u32>(size);
+        return size != 0;
+      });
+
+  if (!compressed)
+  {
+    PanicAlertFmtT("Internal compression error - compressing the state failed");
+    return false;
+  }
+
+  for (const CompressedChunk& chunk : chunks)
+  {
+    if (!f.WriteArray(&chunk.size, 1) || !f.WriteBytes(chunk.data.data(), chunk.size))
+      return false;
+  }
+  return true;
+}
+
+static bool DecompressChunked(const ChunkCodec& codec, std::span<const u8> payload,
+                              std::span<u8> data)
+{
+  ChunkedPayloadHeader header;
+  if (payload.size() < sizeof(header))
+  {
+    PanicAlertFmt("State payload header corrupted");
+    return false;
+  }
+  std::memcpy(&header, payload.data(), sizeof(header));
+
+  if (header.version != CHUNKED_PAYLOAD_VERSION || header.chunk_size == 0)
+  {
+    PanicAlertFmt("Unsupported chunked state payload (version {0}, chunk size {1})",
+                  header.version, header.chunk_size);
+    return false;
+  }
+
+  // Find every chunk before starting any work, so a truncated file fails without side effects.
+  std::vector<ChunkToDecompress> chunks;
+  const u64 uncompressed_size = data.size();
+  size_t in_offset = sizeof(header);
+  for (u64 out_offset = 0; out_offset < uncompressed_size; out_offset += header.chunk_size)
+  {
+    u32 compressed_size;
+    if (payload.size() - in_offset < sizeof(compressed_size))
+    {
+      PanicAlertFmt("Could not read state data length");
+      return false;
+    }
+    std::memcpy(&compressed_size, payload.data() + in_offset, sizeof(compressed_size));
+    in_offset += sizeof(compressed_size);
+
+    if (payload.size() - in_offset < compressed_size)
+    {
+      PanicAlertFmt("Could not read state data");
+      return false;
+    }
+
+    const size_t out_size =
+        static_cast<size_t>(std::min<u64>(header.chunk_size, uncompressed_size - out_offset));
+    chunks.push_back({payload.subspan(in_offset, compressed_size),
+                      data.subspan(static_cast<size_t>(out_offset), out_size)});
+    in_offset += compressed_size;
+  }
+
+  const bool decompressed =
+      GetChunkWorkers().ForEachChunk(chunks.size(), [&](ChunkThreadState* state, size_t i) {
+        return codec.decompress(state, chunks[i].in, chunks[i].out);
+      });
+
+  if (!decompressed)
+  {
+    PanicAlertFmtT("Internal decompression error - the state data is corrupted");
+    return false;
+  }
+  return true;
+}
+
+template <const ChunkCodec& codec>
+static bool CompressChunked(std::span<const u8> data, int level, File::IOFile& f)
+{
+  return CompressChunked(codec, data, level, f);
+}
+
+template <const ChunkCodec& codec>
+static bool DecompressChunked(std::span<const u8> payload, std::span<u8> data)
+{
+  return DecompressChunked(codec, payload, data);
+}
+
+static constexpr std::array s_codecs = {
+    StateCodec{CompressionType::Uncompressed, "Uncompressed", CompressUncompressed,
+               DecompressUncompressed},
+    StateCodec{CompressionType::LZ4, "LZ4", CompressLZ4, DecompressLZ4},
+    StateCodec{CompressionType::ChunkedLZ4, "LZ4", CompressChunked<s_lz4_chunk_codec>,
+               DecompressChunked<s_lz4_chunk_codec>},
+    StateCodec{CompressionType::ChunkedZstd, "Zstandard", CompressChunked<s_zstd_chunk_codec>,
+               DecompressChunked<s_zstd_chunk_codec>},
+    StateCodec{CompressionType::ChunkedLZO, "LZO", CompressChunked<s_lzo_chunk_codec>,
+               DecompressChunked<s_lzo_chunk_codec>},
+};
+
+const StateCodec* GetStateCodec(CompressionType type)
+{
+  const auto it = std::ranges::find(s_codecs, type, &StateCodec::type);
+  return it != s_codecs.end() ? &*it : nullptr;
+}
+}  // namespace State
@@ -0,0 +1,36 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Payload codecs for savestate files.
+
+#pragma once
+
+#include <span>
+
+#include "Common/CommonTypes.h"
+#include "Core/State.h"
+
+namespace File
+{
+class IOFile;
+}
+
+namespace State
+{
+struct StateCodec
+{
+  CompressionType type;
+  const char* name;
+
+  // Writes the encoded payload at the current position of the file. level is only meaningful for
+  // codecs that have compression levels and is ignored by the others.
+  bool (*compress)(std::span<const u8> data, int level, File::IOFile& f);
+
+  // Decodes an encoded payload, which may be followed by unrelated bytes, into data. data must
+  // already have the uncompressed size, and is filled out exactly.
+  bool (*decompress)(std::span<const u8> payload, std::span<u8> data);
+};
+
+// Returns nullptr for compression types this build does not know about.
+const StateCodec* GetStateCodec(CompressionType type);
+}  // namespace State
@@ -0,0 +1,156 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/StateDelta.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace State
+{
+// Delta layout:
+//
+//   DeltaHeader
+//   for each run of changed pages: DeltaRun, then the page data
+//
+// The data of a run is page_count * page_size bytes, except for a run that ends with the last page
+// of the state, which is cut short to the end of the state.
+namespace
+{
+// Increase this if the delta layout above changes.
+constexpr u32 DELTA_VERSION = 1;
+
+struct DeltaHeader
+{
+  u32 version;
+  u32 page_size;
+  u64 base_size;
+  u64 state_size;
+  u64 encoded_size;
+  u32 run_count;
+  u32 reserved;
+};
+static_assert(std::is_trivially_copyable_v<DeltaHeader>);
+
+struct DeltaRun
+{
+  u32 first_page;
+  u32 page_count;
+};
+static_assert(std::is_trivially_copyable_v<DeltaRun>);
+
+bool IsPageChanged(std::span<const u8> base, std::span<const u8> state, size_t offset)
+{
+  const size_t length = std::min(DELTA_PAGE_SIZE, state.size() - offset);
+  if (offset >= base.size() || base.size() - offset < length)
+    return true;
+
+  return std::memcmp(base.data() + offset, state.data() + offset, length) != 0;
+}
+
+size_t GetRunDataSize(const DeltaRun& run, u64 state_size)
+{
+  const u64 offset = u64(run.first_page) * DELTA_PAGE_SIZE;
+  const u64 size = std::min<u64>(u64(run.page_count) * DELTA_PAGE_SIZE, state_size - offset);
+  return static_cast<size_t>(size);
+}
+
+bool ReadHeader(std::span<const u8> delta, DeltaHeader* header)
+{
+  if (delta.size() < sizeof(DeltaHeader))
+    return false;
+
+  std::memcpy(header, delta.data(), sizeof(DeltaHeader));
+  return header->version == DELTA_VERSION && header->page_size == DELTA_PAGE_SIZE &&
+         header->encoded_size >= sizeof(DeltaHeader) && header->encoded_size <= delta.size();
+}
+}  // namespace
+
+size_t MakeStateDelta(std::span<const u8> base, std::span<const u8> state,
+                      Common::UniqueBuffer<u8>& delta)
+{
+  // Find the changed pages first, so the delta can be sized exactly.
+  std::vector<DeltaRun> runs;
+  const u32 page_count = static_cast<u32>((state.size() + DELTA_PAGE_SIZE - 1) / DELTA_PAGE_SIZE);
+  for (u32 page = 0; page < page_count; ++page)
+  {
+    if (!IsPageChanged(base, state, size_t(page) * DELTA_PAGE_SIZE))
+      continue;
+
+    if (!runs.empty() && runs.back().first_page + runs.back().page_count == page)
+      ++runs.back().page_count;
+    else
+      runs.push_back({page, 1});
+  }
+  size_t data_size = 0;
+  for (const DeltaRun& run : runs)
+    data_size += GetRunDataSize(run, state.size());
+
+  const size_t encoded_size = sizeof(DeltaHeader) + runs.size() * sizeof(DeltaRun) + data_size;
+  if (delta.size() < encoded_size)
+    delta.reset(encoded_size);
+
+  DeltaHeader header{};
+  header.version = DELTA_VERSION;
+  header.page_size = DELTA_PAGE_SIZE;
+  header.base_size = base.size();
+  header.state_size = state.size();
+  header.encoded_size = encoded_size;
+  header.run_count = static_cast<u32>(runs.size());
+
+  u8* out = delta.data();
+  std::memcpy(out, &header, sizeof(header));
+  out += sizeof(header);
+
+  for (const DeltaRun& run : runs)
+  {
+    std::memcpy(out, &run, sizeof(run));
+    out += sizeof(run);
+
+    const size_t size = GetRunDataSize(run, state.size());
+    std::memcpy(out, state.data() + size_t(run.first_page) * DELTA_PAGE_SIZE, size);
+    out += size;
+  }
+
+  return encoded_size;
+}
+
+bool ApplyStateDelta(std::span<const u8> base, std::span<const u8> delta,
+                     Common::UniqueBuffer<u8>& state)
+{
+  DeltaHeader header;
+  if (!ReadHeader(delta, &header) || header.base_size != base.size())
+    return false;
+
+  const size_t state_size = static_cast<size_t>(header.state_size);
+  if (state.size() != state_size)
+    state.reset(state_size);
+
+  std::memcpy(state.data(), base.data(), std::min(base.size(), state_size));
+
+  size_t in = sizeof(DeltaHeader);
+  for (u32 i = 0; i < header.run_count; ++i)
+  {
+    DeltaRun run;
+    if (header.encoded_size - in < sizeof(run))
+      return false;
+    std::memcpy(&run, delta.data() + in, sizeof(run));
+    in += sizeof(run);
+
+    const u64 offset = u64(run.first_page) * DELTA_PAGE_SIZE;
+    if (run.page_count == 0 || offset >= state_size)
+      return false;
+
+    const size_t size = GetRunDataSize(run, state_size);
+    if (header.encoded_size - in < size)
+      return false;
+
+    std::memcpy(state.data() + offset, delta.data() + in, size);
+    in += size;
+  }
+
+  return in == header.encoded_size;
+}
+}  // namespace State
@@ -0,0 +1,28 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Savestates stored as the pages that changed since a base state.
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "Common/Buffer.h"
+#include "Common/CommonTypes.h"
+
+namespace State
+{
+constexpr size_t DELTA_PAGE_SIZE = 4096;
+
+// Encodes the pages of state that differ from base. Pages past the end of base are always stored,
+// so the two may have different sizes. Reuses the allocation of delta when it is large enough,
+// in which case delta may end up bigger than the encoded data. Returns the encoded size.
+size_t MakeStateDelta(std::span<const u8> base, std::span<const u8> state,
+                      Common::UniqueBuffer<u8>& delta);
+
+// Rebuilds a state from the base it was made against and a delta from MakeStateDelta.
+// Returns false if the delta is malformed or was made against a base of a different size.
+bool ApplyStateDelta(std::span<const u8> base, std::span<const u8> delta,
+                     Common::UniqueBuffer<u8>& state);
+}  // namespace State
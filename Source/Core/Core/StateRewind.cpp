@@ -0,0 +1,173 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/StateRewind.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <lz4.h>
+
+#include "Core/StateDelta.h"
+
+namespace State
+{
+// A compressed snapshot is the u64 size of the uncompressed data followed by a single LZ4 block.
+namespace
+{
+bool Decompress(std::span<const u8> compressed, Common::UniqueBuffer<u8>& data)
+{
+  u64 size;
+  if (compressed.size() < sizeof(size))
+    return false;
+  std::memcpy(&size, compressed.data(), sizeof(size));
+
+  if (data.size() != size)
+    data.reset(size);
+
+  const int decompressed_size = LZ4_decompress_safe(
+      reinterpret_cast<const char*>(compressed.data()) + sizeof(size),
+      reinterpret_cast<char*>(data.data()), static_cast<int>(compressed.size() - sizeof(size)),
+      static_cast<int>(size));
+  return decompressed_size >= 0 && static_cast<u64>(decompressed_size) == size;
+}
+}  // namespace
+
+RewindBuffer::RewindBuffer(size_t memory_budget, u32 snapshots_per_keyframe)
+    : m_memory_budget(memory_budget),
+      m_snapshots_per_keyframe(std::max<u32>(snapshots_per_keyframe, 1))
+{
+}
+
+bool RewindBuffer::Compress(std::span<const u8> data, Common::UniqueBuffer<u8>& out)
+{
+  const u64 size = data.size();
+  if (size > LZ4_MAX_INPUT_SIZE)
+    return false;
+
+  const size_t bound = sizeof(size) + LZ4_compressBound(static_cast<int>(size));
+  if (m_compress_scratch.size() < bound)
+    m_compress_scratch.reset(bound);
+
+  std::memcpy(m_compress_scratch.data(), &size, sizeof(size));
+  const int compressed_size = LZ4_compress_default(
+      reinterpret_cast<const char*>(data.data()),
+      reinterpret_cast<char*>(m_compress_scratch.data()) + sizeof(size), static_cast<int>(size),
+      static_cast<int>(m_compress_scratch.size() - sizeof(size)));
+  if (compressed_size <= 0)
+    return false;
+
+  // Copied out so that every snapshot only takes up as much memory as it is counted for
+  out.reset(sizeof(size) + compressed_size);
+  std::memcpy(out.data(), m_compress_scratch.data(), out.size());
+  return true;
+}
+
+void RewindBuffer::Push(std::span<const u8> state)
+{
+  const bool start_group = m_groups.empty() ||
+                           m_groups.back().deltas.size() + 1 >= m_snapshots_per_keyframe ||
+                           !LoadNewestKeyframe();
+  if (start_group)
+  {
+    Group group;
+    if (!Compress(state, group.keyframe))
+      return;
+    group.memory_usage = group.keyframe.size();
+    m_memory_usage += group.memory_usage;
+    m_groups.push_back(std::move(group));
+
+    m_keyframe_state.reset(state.size());
+    std::ranges::copy(state, m_keyframe_state.begin());
+  }
+  else
+  {
+    const size_t delta_size = MakeStateDelta(m_keyframe_state, state, m_delta_scratch);
+
+    Common::UniqueBuffer<u8> delta;
+    if (!Compress(std::span(m_delta_scratch.data(), delta_size), delta))
+      return;
+
+    Group& group = m_groups.back();
+    group.memory_usage += delta.size();
+    m_memory_usage += delta.size();
+    group.deltas.push_back(std::move(delta));
+  }
+
+  Evict();
+}
+
+bool RewindBuffer::PopNewest(Common::UniqueBuffer<u8>& state)
+{
+  if (m_groups.empty())
+    return false;
+
+  Group& group = m_groups.back();
+  if (!group.deltas.empty())
+  {
+    Common::UniqueBuffer<u8> delta = std::move(group.deltas.back());
+    group.deltas.pop_back();
+    group.memory_usage -= delta.size();
+    m_memory_usage -= delta.size();
+
+    return LoadNewestKeyframe() && Decompress(delta, m_delta_scratch) &&
+           ApplyStateDelta(m_keyframe_state, m_delta_scratch, state);
+  }
+
+  const bool decompressed = Decompress(group.keyframe, state);
+  m_memory_usage -= group.memory_usage;
+  m_groups.pop_back();
+
+  // The group before this one has a different keyframe
+  m_keyframe_state.reset();
+  return decompressed;
+}
+
+void RewindBuffer::Clear()
+{
+  m_groups.clear();
+  m_memory_usage = 0;
+  m_keyframe_state.reset();
+  m_delta_scratch.reset();
+  m_compress_scratch.reset();
+}
+
+void RewindBuffer::SetMemoryBudget(size_t memory_budget)
+{
+  m_memory_budget = memory_budget;
+  Evict();
+}
+
+size_t RewindBuffer::GetSnapshotCount() const
+{
+  size_t count = 0;
+  for (const Group& group : m_groups)
+    count += 1 + group.deltas.size();
+  return count;
+}
+
+bool RewindBuffer::LoadNewestKeyframe()
+{
+  if (!m_keyframe_state.empty())
+    return true;
+
+  if (m_groups.empty() || !Decompress(m_groups.back().keyframe, m_keyframe_state))
+  {
+    m_keyframe_state.reset();
+    return false;
+  }
+
+  return true;
+}
+
+void RewindBuffer::Evict()
+{
+  // The newest group is kept even if it alone is over budget, as it's the one still being added to
+  while (m_groups.size() > 1 && GetMemoryUsage() > m_memory_budget)
+  {
+    m_memory_usage -= m_groups.front().memory_usage;
+    m_groups.pop_front();
+  }
+}
+}  // namespace State
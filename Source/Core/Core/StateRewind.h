@@ -0,0 +1,64 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// In-memory history of states for rewinding, see State::Rewind.
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <span>
+#include <vector>
+
+#include "Common/Buffer.h"
+#include "Common/CommonTypes.h"
+
+namespace State
+{
+// Snapshots are grouped behind a full keyframe, and the rest of a group is stored as the pages
+// that changed since that keyframe. Everything is kept LZ4 compressed. Once the memory budget is
+// exceeded, the oldest groups are dropped as a whole.
+class RewindBuffer
+{
+public:
+  RewindBuffer(size_t memory_budget, u32 snapshots_per_keyframe);
+
+  // Adds a state written by SaveToBuffer as the newest snapshot.
+  void Push(std::span<const u8> state);
+
+  // Restores the newest snapshot into state and removes it, so that the next call returns the one
+  // before it. Returns false if there are no snapshots left or one can't be decoded.
+  bool PopNewest(Common::UniqueBuffer<u8>& state);
+
+  void Clear();
+  // Drops the oldest snapshots right away if they don't fit into the new budget
+  void SetMemoryBudget(size_t memory_budget);
+
+  size_t GetSnapshotCount() const;
+  // Includes the uncompressed copy of the newest keyframe that new snapshots are compared against
+  size_t GetMemoryUsage() const { return m_memory_usage + m_keyframe_state.size(); }
+
+private:
+  struct Group
+  {
+    Common::UniqueBuffer<u8> keyframe;
+    std::vector<Common::UniqueBuffer<u8>> deltas;
+    size_t memory_usage = 0;
+  };
+
+  bool Compress(std::span<const u8> data, Common::UniqueBuffer<u8>& out);
+  bool LoadNewestKeyframe();
+  void Evict();
+
+  size_t m_memory_budget;
+  u32 m_snapshots_per_keyframe;
+
+  std::deque<Group> m_groups;
+  size_t m_memory_usage = 0;
+
+  // Uncompressed keyframe of the newest group, empty if it still has to be decompressed
+  Common::UniqueBuffer<u8> m_keyframe_state;
+  Common::UniqueBuffer<u8> m_delta_scratch;
+  Common::UniqueBuffer<u8> m_compress_scratch;
+};
+}  // namespace State
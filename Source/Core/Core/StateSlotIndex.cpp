@@ -0,0 +1,413 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/StateSlotIndex.h"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <system_error>
+#include <type_traits>
+
+#include <fmt/format.h>
+
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/StringUtil.h"
+
+namespace State
+{
+// Index file layout:
+//
+//   IndexFileHeader
+//   the game ID, game_id_length bytes
+//   IndexFileEntry for every slot
+//   the thumbnail of every slot, thumbnail_size bytes each
+//
+// Only used slots whose time could be read are stored as used. Anything else is checked again when
+// the index is loaded.
+namespace
+{
+// Increase this if the index file layout above changes.
+constexpr u32 INDEX_FILE_VERSION = 2;  // Last changed by adding thumbnails
+
+struct IndexFileHeader
+{
+  u32 version;
+  u32 game_id_length;
+  u32 slot_count;
+  u32 reserved;
+};
+static_assert(std::is_trivially_copyable_v<IndexFileHeader>);
+
+struct IndexFileEntry
+{
+  u8 used;
+  u8 reserved[3];
+  u32 thumbnail_size;
+  double time;
+  u64 file_size;
+  s64 last_write_time;
+};
+static_assert(std::is_trivially_copyable_v<IndexFileEntry>);
+
+struct FileStatus
+{
+  u64 size;
+  s64 last_write_time;
+};
+
+std::optional<FileStatus> GetFileStatus(const std::filesystem::path& path)
+{
+  std::error_code error;
+  const u64 size = std::filesystem::file_size(path, error);
+  if (error)
+    return std::nullopt;
+
+  const auto last_write_time = std::filesystem::last_write_time(path, error);
+  if (error)
+    return std::nullopt;
+
+  return FileStatus{size, last_write_time.time_since_epoch().count()};
+}
+
+std::string_view GetFilename(std::string_view path)
+{
+  const size_t separator = path.find_last_of('/');
+  return separator == std::string_view::npos ? path : path.substr(separator + 1);
+}
+}  // namespace
+
+std::string MakeSlotFilename(std::string_view game_id, int slot)
+{
+  return fmt::format("{}.s{:02d}", game_id, slot);
+}
+
+SlotIndex::SlotIndex(std::string directory, std::string game_id, int slot_count,
+                     ReadHeaderFunction read_header)
+    : m_directory(std::move(directory)), m_game_id(std::move(game_id)),
+      m_read_header(std::move(read_header)), m_entries(std::max(slot_count, 0))
+{
+  Watch(m_directory);
+}
+
+SlotIndex::~SlotIndex()
+{
+  // The watcher must not call into this object anymore once it's being destroyed
+  Unwatch(m_directory);
+}
+
+std::optional<SlotInfo> SlotIndex::GetSlotInfo(int slot)
+{
+  if (slot < 1 || slot > static_cast<int>(m_entries.size()))
+    return std::nullopt;
+
+  std::lock_guard lk(m_mutex);
+  LoadIfNeeded();
+  if (RefreshIfUnknown(slot))
+    WriteIndexFile();
+
+  const Entry& entry = m_entries[slot - 1];
+  if (entry.state == EntryState::Empty)
+    return std::nullopt;
+  return entry.info;
+}
+
+std::vector<std::pair<int, SlotInfo>> SlotIndex::GetUsedSlots()
+{
+  std::lock_guard lk(m_mutex);
+  LoadIfNeeded();
+
+  bool changed = false;
+  std::vector<std::pair<int, SlotInfo>> result;
+  for (int slot = 1; slot <= static_cast<int>(m_entries.size()); ++slot)
+  {
+    changed |= RefreshIfUnknown(slot);
+
+    const Entry& entry = m_entries[slot - 1];
+    if (entry.state == EntryState::Used && entry.info.time)
+      result.emplace_back(slot, entry.info);
+  }
+
+  if (changed)
+    WriteIndexFile();
+  return result;
+}
+
+std::vector<u8> SlotIndex::GetThumbnail(int slot)
+{
+  if (slot < 1 || slot > static_cast<int>(m_entries.size()))
+    return {};
+
+  std::lock_guard lk(m_mutex);
+  LoadIfNeeded();
+  if (RefreshIfUnknown(slot))
+    WriteIndexFile();
+
+  const Entry& entry = m_entries[slot - 1];
+  if (entry.state != EntryState::Used)
+    return {};
+  return entry.thumbnail;
+}
+
+void SlotIndex::OnStateWritten(const std::string& path, SlotHeader header)
+{
+  const std::optional<int> slot = GetSlotFromPath(path);
+  if (!slot || path != GetSlotPath(*slot))
+    return;
+
+  std::lock_guard lk(m_mutex);
+  LoadIfNeeded();
+
+  Entry& entry = m_entries[*slot - 1];
+  const std::optional<FileStatus> status = GetFileStatus(StringToPath(path));
+  if (!status)
+  {
+    entry.state = EntryState::Unknown;
+    return;
+  }
+
+  entry.state = EntryState::Used;
+  entry.info = {header.time, status->size};
+  entry.thumbnail = std::move(header.thumbnail);
+  entry.last_write_time = status->last_write_time;
+  WriteIndexFile();
+}
+
+void SlotIndex::PathAdded(std::string_view path)
+{
+  Invalidate(path);
+}
+
+void SlotIndex::PathModified(std::string_view path)
+{
+  Invalidate(path);
+}
+
+void SlotIndex::PathRenamed(std::string_view old_path, std::string_view new_path)
+{
+  Invalidate(old_path);
+  Invalidate(new_path);
+}
+
+void SlotIndex::PathDeleted(std::string_view path)
+{
+  Invalidate(path);
+}
+
+std::optional<int> SlotIndex::GetSlotFromPath(std::string_view path) const
+{
+  std::string_view filename = GetFilename(path);
+  if (!filename.starts_with(m_game_id))
+    return std::nullopt;
+  filename.remove_prefix(m_game_id.size());
+
+  // The slot number always has two digits, see MakeSlotFilename
+  if (filename.size() != 4 || !filename.starts_with(".s"))
+    return std::nullopt;
+
+  int slot;
+  const char* const end = filename.data() + filename.size();
+  const auto [ptr, error] = std::from_chars(filename.data() + 2, end, slot);
+  if (error != std::errc() || ptr != end || slot < 1 || slot > static_cast<int>(m_entries.size()))
+    return std::nullopt;
+
+  return slot;
+}
+
+std::string SlotIndex::GetSlotPath(int slot) const
+{
+  return m_directory + MakeSlotFilename(m_game_id, slot);
+}
+
+std::string SlotIndex::GetIndexPath() const
+{
+  return m_directory + m_game_id + ".slotindex";
+}
+
+void SlotIndex::Invalidate(std::string_view path)
+{
+  const std::optional<int> slot = GetSlotFromPath(path);
+  if (!slot)
+    return;
+
+  std::lock_guard lk(m_mutex);
+  if (!m_loaded)
+    return;
+
+  // Writing a state triggers events for a file that OnStateWritten has already indexed
+  Entry& entry = m_entries[*slot - 1];
+  if (entry.state == EntryState::Used)
+  {
+    const std::optional<FileStatus> status = GetFileStatus(StringToPath(GetSlotPath(*slot)));
+    if (status && status->size == entry.info.file_size &&
+        status->last_write_time == entry.last_write_time)
+    {
+      return;
+    }
+  }
+
+  entry.state = EntryState::Unknown;
+}
+
+void SlotIndex::LoadIfNeeded()
+{
+  if (m_loaded)
+    return;
+  m_loaded = true;
+
+  std::vector<IndexFileEntry> indexed_entries;
+  std::vector<std::vector<u8>> indexed_thumbnails;
+  {
+    File::IOFile f(GetIndexPath(), "rb");
+    IndexFileHeader header;
+    std::string game_id;
+    if (f.ReadArray(&header, 1) && header.version == INDEX_FILE_VERSION &&
+        header.game_id_length == m_game_id.size() && header.slot_count == m_entries.size())
+    {
+      game_id.resize(header.game_id_length);
+      indexed_entries.resize(header.slot_count);
+      if (!f.ReadBytes(game_id.data(), game_id.size()) || game_id != m_game_id ||
+          !f.ReadArray(indexed_entries.data(), indexed_entries.size()))
+      {
+        indexed_entries.clear();
+      }
+    }
+
+    // Checked up front, so that a broken index can't make this allocate a lot of memory
+    u64 thumbnails_size = 0;
+    for (const IndexFileEntry& indexed : indexed_entries)
+      thumbnails_size += indexed.thumbnail_size;
+    if (!indexed_entries.empty() && thumbnails_size > f.GetSize() - f.Tell())
+      indexed_entries.clear();
+
+    indexed_thumbnails.resize(indexed_entries.size());
+    for (size_t i = 0; i < indexed_entries.size(); ++i)
+    {
+      indexed_thumbnails[i].resize(indexed_entries[i].thumbnail_size);
+      if (!f.ReadBytes(indexed_thumbnails[i].data(), indexed_thumbnails[i].size()))
+      {
+        indexed_entries.clear();
+        break;
+      }
+    }
+  }
+
+  // A single listing of the directory tells which slots exist and which changed since they were
+  // indexed, without opening any of them.
+  for (Entry& entry : m_entries)
+    entry.state = EntryState::Empty;
+
+  std::error_code error;
+  std::filesystem::directory_iterator it(StringToPath(m_directory), error);
+  for (; !error && it != std::filesystem::directory_iterator(); it.increment(error))
+  {
+    const std::optional<int> slot = GetSlotFromPath(PathToString(it->path().filename()));
+    if (!slot)
+      continue;
+
+    Entry& entry = m_entries[*slot - 1];
+    entry.state = EntryState::Unknown;
+
+    std::error_code status_error;
+    const u64 size = it->file_size(status_error);
+    if (status_error)
+      continue;
+    const s64 last_write_time = it->last_write_time(status_error).time_since_epoch().count();
+    if (status_error)
+      continue;
+
+    if (indexed_entries.empty())
+      continue;
+
+    const IndexFileEntry& indexed = indexed_entries[*slot - 1];
+    if (indexed.used && indexed.file_size == size && indexed.last_write_time == last_write_time)
+    {
+      entry.state = EntryState::Used;
+      entry.info = {indexed.time, size};
+      entry.thumbnail = std::move(indexed_thumbnails[*slot - 1]);
+      entry.last_write_time = last_write_time;
+    }
+  }
+
+  // Without a listing, every slot has to be checked on its own
+  if (error)
+  {
+    for (Entry& entry : m_entries)
+      entry.state = EntryState::Unknown;
+  }
+}
+
+bool SlotIndex::RefreshIfUnknown(int slot)
+{
+  Entry& entry = m_entries[slot - 1];
+  if (entry.state != EntryState::Unknown)
+    return false;
+
+  const std::string path = GetSlotPath(slot);
+  const std::optional<FileStatus> status = GetFileStatus(StringToPath(path));
+  if (!status)
+  {
+    entry.state = EntryState::Empty;
+    return true;
+  }
+
+  entry.state = EntryState::Used;
+  entry.info = {std::nullopt, status->size};
+  entry.thumbnail.clear();
+  if (std::optional<SlotHeader> header = m_read_header(path))
+  {
+    entry.info.time = header->time;
+    entry.thumbnail = std::move(header->thumbnail);
+  }
+  entry.last_write_time = status->last_write_time;
+  return true;
+}
+
+void SlotIndex::WriteIndexFile() const
+{
+  // States of titles without an ID don't belong to one game
+  if (m_game_id.empty())
+    return;
+
+  const IndexFileHeader header{INDEX_FILE_VERSION, static_cast<u32>(m_game_id.size()),
+                               static_cast<u32>(m_entries.size()), 0};
+
+  std::vector<IndexFileEntry> indexed_entries(m_entries.size());
+  for (size_t i = 0; i < m_entries.size(); ++i)
+  {
+    const Entry& entry = m_entries[i];
+    if (entry.state != EntryState::Used || !entry.info.time)
+      continue;
+
+    IndexFileEntry& indexed = indexed_entries[i];
+    indexed.used = 1;
+    indexed.thumbnail_size = static_cast<u32>(entry.thumbnail.size());
+    indexed.time = *entry.info.time;
+    indexed.file_size = entry.info.file_size;
+    indexed.last_write_time = entry.last_write_time;
+  }
+
+  // Written next to the index and then moved over it, so that the index is never seen half written
+  const std::string index_path = GetIndexPath();
+  const std::string temp_path = index_path + ".tmp";
+  {
+    File::IOFile f(temp_path, "wb");
+    bool written = f.WriteArray(&header, 1) && f.WriteBytes(m_game_id.data(), m_game_id.size()) &&
+                   f.WriteArray(indexed_entries.data(), indexed_entries.size());
+    for (size_t i = 0; i < m_entries.size() && written; ++i)
+    {
+      if (indexed_entries[i].used)
+        written = f.WriteBytes(m_entries[i].thumbnail.data(), m_entries[i].thumbnail.size());
+    }
+
+    if (!written)
+    {
+      f.Close();
+      File::Delete(temp_path);
+      return;
+    }
+  }
+  File::Rename(temp_path, index_path);
+}
+}  // namespace State
@@ -0,0 +1,114 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Cached metadata of the numbered savestate slots, see State::GetInfoStringOfSlot.
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FilesystemWatcher.h"
+
+namespace State
+{
+struct SlotInfo
+{
+  // The time from the legacy header of the state, or nothing if the header couldn't be read
+  std::optional<double> time;
+  u64 file_size = 0;
+};
+
+// What is read from the headers of a state file
+struct SlotHeader
+{
+  double time;
+  // PNG file, empty if the state has no thumbnail
+  std::vector<u8> thumbnail;
+};
+
+// Returns the file name of a slot without the directory, such as "GALE01.s01".
+std::string MakeSlotFilename(std::string_view game_id, int slot);
+
+// Keeps the info of every slot of one game in memory, and in an index file next to the states, so
+// that building slot menus doesn't have to open every state file. When the index file is loaded,
+// only slots whose file size or modification time changed since are read again. Changes made to
+// the state files while the index is alive are picked up through a filesystem watcher.
+// All functions are thread-safe.
+class SlotIndex final : private Common::FilesystemWatcher
+{
+public:
+  // Returns nothing if the headers of the state file can't be read.
+  using ReadHeaderFunction = std::function<std::optional<SlotHeader>(const std::string& path)>;
+
+  SlotIndex(std::string directory, std::string game_id, int slot_count,
+            ReadHeaderFunction read_header);
+  ~SlotIndex() override;
+
+  SlotIndex(const SlotIndex&) = delete;
+  SlotIndex& operator=(const SlotIndex&) = delete;
+
+  const std::string& GetGameID() const { return m_game_id; }
+
+  // Slots are numbered from 1. Returns nothing for empty slots.
+  std::optional<SlotInfo> GetSlotInfo(int slot);
+  // Only includes the slots whose time could be read
+  std::vector<std::pair<int, SlotInfo>> GetUsedSlots();
+  // Returns the PNG file of the thumbnail of a slot, or nothing if it's empty or has no thumbnail.
+  std::vector<u8> GetThumbnail(int slot);
+
+  // To be called once a state with the given headers has been written to path. Does nothing if
+  // path isn't one of the slots.
+  void OnStateWritten(const std::string& path, SlotHeader header);
+
+private:
+  enum class EntryState
+  {
+    // The file has to be read again before the entry can be used
+    Unknown,
+    Empty,
+    Used,
+  };
+
+  struct Entry
+  {
+    EntryState state = EntryState::Unknown;
+    SlotInfo info;
+    std::vector<u8> thumbnail;
+    // From std::filesystem::file_time_type, for telling if the file changed since it was indexed
+    s64 last_write_time = 0;
+  };
+
+  void PathAdded(std::string_view path) override;
+  void PathModified(std::string_view path) override;
+  void PathRenamed(std::string_view old_path, std::string_view new_path) override;
+  void PathDeleted(std::string_view path) override;
+
+  // Only looks at the file name
+  std::optional<int> GetSlotFromPath(std::string_view path) const;
+  std::string GetSlotPath(int slot) const;
+  std::string GetIndexPath() const;
+
+  void Invalidate(std::string_view path);
+
+  // These expect m_mutex to be held.
+  void LoadIfNeeded();
+  // Returns whether the entry changed
+  bool RefreshIfUnknown(int slot);
+  void WriteIndexFile() const;
+
+  std::string m_directory;
+  std::string m_game_id;
+  ReadHeaderFunction m_read_header;
+
+  std::mutex m_mutex;
+  bool m_loaded = false;
+  std::vector<Entry> m_entries;
+};
+}  // namespace State
@@ -0,0 +1,84 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/StateThumbnail.h"
+
+#include <algorithm>
+
+#include "Common/Image.h"
+
+namespace State
+{
+ThumbnailSize GetThumbnailSize(u32 width, u32 height)
+{
+  if (width <= THUMBNAIL_MAX_WIDTH && height <= THUMBNAIL_MAX_HEIGHT)
+    return {width, height};
+
+  // Whichever side is furthest over its limit decides the scale
+  if (u64(width) * THUMBNAIL_MAX_HEIGHT >= u64(height) * THUMBNAIL_MAX_WIDTH)
+  {
+    const u32 scaled_height = static_cast<u32>(u64(height) * THUMBNAIL_MAX_WIDTH / width);
+    return {THUMBNAIL_MAX_WIDTH, std::max<u32>(scaled_height, 1)};
+  }
+
+  const u32 scaled_width = static_cast<u32>(u64(width) * THUMBNAIL_MAX_HEIGHT / height);
+  return {std::max<u32>(scaled_width, 1), THUMBNAIL_MAX_HEIGHT};
+}
+
+std::vector<u8> ScaleThumbnail(std::span<const u8> rgba, u32 width, u32 height)
+{
+  if (width == 0 || height == 0 || rgba.size() < size_t(width) * height * 4)
+    return {};
+
+  const auto [thumbnail_width, thumbnail_height] = GetThumbnailSize(width, height);
+  std::vector<u8> rgb(size_t(thumbnail_width) * thumbnail_height * 3);
+
+  // As the thumbnail is never bigger than the image, every thumbnail pixel covers at least one
+  // whole pixel of the image.
+  u8* out = rgb.data();
+  for (u32 y = 0; y < thumbnail_height; ++y)
+  {
+    const u32 src_top = y * height / thumbnail_height;
+    const u32 src_bottom = (y + 1) * height / thumbnail_height;
+    for (u32 x = 0; x < thumbnail_width; ++x)
+    {
+      const u32 src_left = x * width / thumbnail_width;
+      const u32 src_right = (x + 1) * width / thumbnail_width;
+
+      u32 sum[3] = {};
+      for (u32 src_y = src_top; src_y < src_bottom; ++src_y)
+      {
+        const u8* src = rgba.data() + (size_t(src_y) * width + src_left) * 4;
+        for (u32 src_x = src_left; src_x < src_right; ++src_x, src += 4)
+        {
+          sum[0] += src[0];
+          sum[1] += src[1];
+          sum[2] += src[2];
+        }
+      }
+
+      const u32 count = (src_bottom - src_top) * (src_right - src_left);
+      for (const u32 channel_sum : sum)
+        *out++ = static_cast<u8>((channel_sum + count / 2) / count);
+    }
+  }
+
+  return rgb;
+}
+
+std::vector<u8> EncodeThumbnail(std::span<const u8> rgba, u32 width, u32 height)
+{
+  const std::vector<u8> rgb = ScaleThumbnail(rgba, width, height);
+  if (rgb.empty())
+    return {};
+
+  const auto [thumbnail_width, thumbnail_height] = GetThumbnailSize(width, height);
+  std::vector<u8> png;
+  if (!Common::EncodePNG(&png, rgb.data(), Common::ImageByteFormat::RGB, thumbnail_width,
+                         thumbnail_height, thumbnail_width * 3))
+  {
+    return {};
+  }
+  return png;
+}
+}  // namespace State
@@ -0,0 +1,35 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Preview images stored in savestates, see State::GetThumbnailOfSlot.
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace State
+{
+// Thumbnails are scaled down to fit in this size, keeping their aspect ratio.
+constexpr u32 THUMBNAIL_MAX_WIDTH = 160;
+constexpr u32 THUMBNAIL_MAX_HEIGHT = 120;
+
+struct ThumbnailSize
+{
+  u32 width;
+  u32 height;
+};
+
+// Returns the size an image is scaled to. Images that already fit are left at their size.
+ThumbnailSize GetThumbnailSize(u32 width, u32 height);
+
+// Scales an RGBA8 image with rows width * 4 bytes apart down to GetThumbnailSize() by averaging
+// the pixels that each thumbnail pixel covers. The result is RGB8, as the alpha of a presented
+// frame means nothing.
+std::vector<u8> ScaleThumbnail(std::span<const u8> rgba, u32 width, u32 height);
+
+// Scales the image down and encodes it as a PNG file. Returns nothing if it can't be encoded.
+std::vector<u8> EncodeThumbnail(std::span<const u8> rgba, u32 width, u32 height);
+}  // namespace State
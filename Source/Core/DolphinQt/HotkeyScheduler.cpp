@@ -666,6 +666,9 @@ void HotkeyScheduler::Run()
 
     if (IsHotkey(HK_SAVE_STATE_FILE))
       emit StateSaveFile();
+
+    if (IsHotkey(HK_REWIND))
+      emit StateRewind();
   }
 }
 
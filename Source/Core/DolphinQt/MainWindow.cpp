@@ -646,6 +646,7 @@ void MainWindow::ConnectHotkeys()
           &MainWindow::StateLoadLastSavedAt);
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateLoadUndo, this, &MainWindow::StateLoadUndo);
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateSaveUndo, this, &MainWindow::StateSaveUndo);
+  connect(m_hotkey_scheduler, &HotkeyScheduler::StateRewind, this, &MainWindow::StateRewind);
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateSaveOldest, this,
           &MainWindow::StateSaveOldest);
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateSaveFile, this, &MainWindow::StateSave);
@@ -1577,6 +1578,11 @@ void MainWindow::StateSaveUndo()
   State::UndoSaveState(m_system);
 }
 
+void MainWindow::StateRewind()
+{
+  State::Rewind(m_system);
+}
+
 void MainWindow::StateSaveOldest()
 {
   State::SaveFirstSaved(m_system);
@@ -1689,7 +1695,8 @@ bool MainWindow::NetPlayJoin()
   const u16 traversal_port = Config::Get(Config::NETPLAY_TRAVERSAL_PORT);
   const std::string nickname = Config::Get(Config::NETPLAY_NICKNAME);
   const std::string network_mode = Config::Get(Config::NETPLAY_NETWORK_MODE);
-  const bool host_input_authority = network_mode == "hostinputauthority" || network_mode == "golf";
+  const bool host_input_authority = network_mode == "hostinputauthority" ||
+                                    network_mode == "hostinputprediction" || network_mode == "golf";
 
   if (server)
   {
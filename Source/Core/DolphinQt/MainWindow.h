@@ -120,6 +120,7 @@ private:
   void StateLoadLastSavedAt(int slot);
   void StateLoadUndo();
   void StateSaveUndo();
+  void StateRewind();
   void StateSaveOldest();
   void SetStateSlot(int slot);
   void IncrementSelectedStateSlot();
@@ -12,8 +12,10 @@
 #include <QDirIterator>
 #include <QFileDialog>
 #include <QFontDialog>
+#include <QIcon>
 #include <QInputDialog>
 #include <QMap>
+#include <QPixmap>
 #include <QSignalBlocker>
 #include <QUrl>
 
@@ -456,6 +458,14 @@ void MenuBar::UpdateStateSlotMenu()
     QString info = QString::fromStdString(State::GetInfoStringOfSlot(slot));
     actions_load.at(i)->setText(tr("Load from Slot %1 - %2").arg(slot).arg(info));
     actions_save.at(i)->setText(tr("Save to Slot %1 - %2").arg(slot).arg(info));
+
+    // A null pixmap clears the icon of slots that are empty or have no thumbnail
+    const std::vector<u8> thumbnail = State::GetThumbnailOfSlot(slot);
+    QPixmap pixmap;
+    if (!thumbnail.empty())
+      pixmap.loadFromData(thumbnail.data(), static_cast<uint>(thumbnail.size()), "PNG");
+    actions_load.at(i)->setIcon(QIcon(pixmap));
+    actions_save.at(i)->setIcon(QIcon(pixmap));
     actions_slot.at(i)->setText(tr("Select Slot %1 - %2").arg(slot).arg(info));
   }
 }
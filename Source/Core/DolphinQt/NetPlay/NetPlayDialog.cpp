@@ -193,20 +193,58 @@ void NetPlayDialog::CreateMainLayout()
          "giving the host zero latency but increasing latency for others.\nSuitable for casual "
          "games with 3+ players, possibly on unstable or high latency connections."));
   m_host_input_authority_action->setCheckable(true);
+  m_host_input_prediction_action =
+      m_network_menu->addAction(tr("Host Input Authority with Prediction"));
+  m_host_input_prediction_action->setToolTip(
+      tr("Identical to Host Input Authority, except other players see their own inputs applied "
+         "immediately, and the game is re-simulated once the host's inputs arrive.\nSuitable for "
+         "games with continuous analog input on high latency connections. GameCube controllers "
+         "only."));
+  m_host_input_prediction_action->setCheckable(true);
   m_golf_mode_action = m_network_menu->addAction(tr("Golf Mode"));
   m_golf_mode_action->setToolTip(
       tr("Identical to Host Input Authority, except the \"Host\" (who has zero latency) can be "
          "switched at any time.\nSuitable for turn-based games with timing-sensitive controls, "
          "such as golf."));
   m_golf_mode_action->setCheckable(true);
+  m_rollback_action = m_network_menu->addAction(tr("Rollback"));
+  m_rollback_action->setToolTip(
+      tr("Each player's inputs are applied immediately on their own machine. Remote inputs that "
+         "have not arrived yet are predicted, and the game is re-simulated if a prediction turns "
+         "out wrong.\nSuitable for high latency connections. GameCube controllers only."));
+  m_rollback_action->setCheckable(true);
 
   m_network_mode_group = new QActionGroup(this);
   m_network_mode_group->setExclusive(true);
   m_network_mode_group->addAction(m_fixed_delay_action);
   m_network_mode_group->addAction(m_host_input_authority_action);
+  m_network_mode_group->addAction(m_host_input_prediction_action);
   m_network_mode_group->addAction(m_golf_mode_action);
+  m_network_mode_group->addAction(m_rollback_action);
   m_fixed_delay_action->setChecked(true);
 
+  m_network_menu->addSeparator();
+
+  m_auto_buffer_action = m_network_menu->addAction(tr("Automatic Buffer Size"));
+  m_auto_buffer_action->setToolTip(
+      tr("The buffer size is continuously adjusted to each player's ping and connection stability, "
+         "and raised whenever a player runs out of inputs.\nHas no effect with Host Input "
+         "Authority or Golf Mode."));
+  m_auto_buffer_action->setCheckable(true);
+  m_memory_hash_action = m_network_menu->addAction(tr("Detailed Desync Detection"));
+  m_memory_hash_action->setToolTip(
+      tr("Emulated memory is hashed in the background and compared between players, so that the "
+         "first frame and memory region that differ are reported when a desync happens.\nHas no "
+         "effect with Rollback."));
+  m_memory_hash_action->setCheckable(true);
+  m_spectator_relay_action = m_network_menu->addAction(tr("Allow Joining Mid-Game"));
+  m_spectator_relay_action->setToolTip(
+      tr("Players can join a game in progress as spectators. The host saves a state every few "
+         "seconds, which new players load before fast-forwarding through the inputs since.\nThey "
+         "can't take over a controller, and save data and cheat codes aren't synchronized with "
+         "them.\nOnly works with Fixed Delay and GameCube Controllers."));
+  m_spectator_relay_action->setCheckable(true);
+
   m_game_digest_menu = m_menu_bar->addMenu(tr("Checksum"));
   m_game_digest_menu->addAction(tr("Current game"), this, [this] {
     Settings::Instance().GetNetPlayServer()->ComputeGameDigest(m_current_game_identifier);
@@ -372,8 +410,16 @@ void NetPlayDialog::ConnectWidgets()
 
   connect(m_host_input_authority_action, &QAction::toggled, this,
           [hia_function] { hia_function(true); });
+  connect(m_host_input_prediction_action, &QAction::toggled, this,
+          [hia_function] { hia_function(true); });
   connect(m_golf_mode_action, &QAction::toggled, this, [hia_function] { hia_function(true); });
   connect(m_fixed_delay_action, &QAction::toggled, this, [hia_function] { hia_function(false); });
+  connect(m_rollback_action, &QAction::toggled, this, [hia_function] { hia_function(false); });
+  connect(m_auto_buffer_action, &QAction::toggled, this, [](bool enable) {
+    const auto server = Settings::Instance().GetNetPlayServer();
+    if (server)
+      server->SetAutoPadBufferSize(enable);
+  });
 
   connect(m_start_button, &QPushButton::clicked, this, &NetPlayDialog::OnStart);
   connect(m_quit_button, &QPushButton::clicked, this, &NetPlayDialog::reject);
@@ -417,10 +463,15 @@ void NetPlayDialog::ConnectWidgets()
   connect(m_sync_codes_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
   connect(m_record_input_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
   connect(m_strict_settings_sync_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
+  connect(m_auto_buffer_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
+  connect(m_memory_hash_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
+  connect(m_spectator_relay_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
   connect(m_host_input_authority_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
+  connect(m_host_input_prediction_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
   connect(m_golf_mode_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
   connect(m_golf_mode_overlay_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
   connect(m_fixed_delay_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
+  connect(m_rollback_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
   connect(m_hide_remote_gbas_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
 }
 
@@ -525,6 +576,9 @@ void NetPlayDialog::show(std::string nickname, bool use_traversal)
     }
   }
 
+  if (is_hosting)
+    Settings::Instance().GetNetPlayServer()->SetAutoPadBufferSize(m_auto_buffer_action->isChecked());
+
   m_data_menu->menuAction()->setVisible(is_hosting);
   m_network_menu->menuAction()->setVisible(is_hosting);
   m_game_digest_menu->menuAction()->setVisible(is_hosting);
@@ -860,8 +914,10 @@ void NetPlayDialog::SetOptionsEnabled(bool enabled)
     m_assign_ports_button->setEnabled(enabled);
     m_strict_settings_sync_action->setEnabled(enabled);
     m_host_input_authority_action->setEnabled(enabled);
+    m_host_input_prediction_action->setEnabled(enabled);
     m_golf_mode_action->setEnabled(enabled);
     m_fixed_delay_action->setEnabled(enabled);
+    m_rollback_action->setEnabled(enabled);
   }
 
   m_record_input_action->setEnabled(enabled);
@@ -1134,6 +1190,9 @@ void NetPlayDialog::LoadSettings()
   const bool strict_settings_sync = Config::Get(Config::NETPLAY_STRICT_SETTINGS_SYNC);
   const bool golf_mode_overlay = Config::Get(Config::NETPLAY_GOLF_MODE_OVERLAY);
   const bool hide_remote_gbas = Config::Get(Config::NETPLAY_HIDE_REMOTE_GBAS);
+  const bool auto_buffer_size = Config::Get(Config::NETPLAY_AUTO_BUFFER_SIZE);
+  const bool memory_hash = Config::Get(Config::NETPLAY_MEMORY_HASH);
+  const bool spectator_relay = Config::Get(Config::NETPLAY_SPECTATOR_RELAY);
 
   m_buffer_size_box->setValue(buffer_size);
 
@@ -1150,6 +1209,9 @@ void NetPlayDialog::LoadSettings()
   m_strict_settings_sync_action->setChecked(strict_settings_sync);
   m_golf_mode_overlay_action->setChecked(golf_mode_overlay);
   m_hide_remote_gbas_action->setChecked(hide_remote_gbas);
+  m_auto_buffer_action->setChecked(auto_buffer_size);
+  m_memory_hash_action->setChecked(memory_hash);
+  m_spectator_relay_action->setChecked(spectator_relay);
 
   const std::string network_mode = Config::Get(Config::NETPLAY_NETWORK_MODE);
 
@@ -1161,10 +1223,18 @@ void NetPlayDialog::LoadSettings()
   {
     m_host_input_authority_action->setChecked(true);
   }
+  else if (network_mode == "hostinputprediction")
+  {
+    m_host_input_prediction_action->setChecked(true);
+  }
   else if (network_mode == "golf")
   {
     m_golf_mode_action->setChecked(true);
   }
+  else if (network_mode == "rollback")
+  {
+    m_rollback_action->setChecked(true);
+  }
   else
   {
     WARN_LOG_FMT(NETPLAY, "Unknown network mode '{}', using 'fixeddelay'", network_mode);
@@ -1193,6 +1263,9 @@ void NetPlayDialog::SaveSettings()
   Config::SetBase(Config::NETPLAY_STRICT_SETTINGS_SYNC, m_strict_settings_sync_action->isChecked());
   Config::SetBase(Config::NETPLAY_GOLF_MODE_OVERLAY, m_golf_mode_overlay_action->isChecked());
   Config::SetBase(Config::NETPLAY_HIDE_REMOTE_GBAS, m_hide_remote_gbas_action->isChecked());
+  Config::SetBase(Config::NETPLAY_AUTO_BUFFER_SIZE, m_auto_buffer_action->isChecked());
+  Config::SetBase(Config::NETPLAY_MEMORY_HASH, m_memory_hash_action->isChecked());
+  Config::SetBase(Config::NETPLAY_SPECTATOR_RELAY, m_spectator_relay_action->isChecked());
 
   std::string network_mode;
   if (m_fixed_delay_action->isChecked())
@@ -1203,10 +1276,18 @@ void NetPlayDialog::SaveSettings()
   {
     network_mode = "hostinputauthority";
   }
+  else if (m_host_input_prediction_action->isChecked())
+  {
+    network_mode = "hostinputprediction";
+  }
   else if (m_golf_mode_action->isChecked())
   {
     network_mode = "golf";
   }
+  else if (m_rollback_action->isChecked())
+  {
+    network_mode = "rollback";
+  }
 
   Config::SetBase(Config::NETPLAY_NETWORK_MODE, network_mode);
 }
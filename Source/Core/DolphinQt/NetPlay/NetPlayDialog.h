@@ -154,9 +154,14 @@ private:
   QAction* m_record_input_action;
   QAction* m_strict_settings_sync_action;
   QAction* m_host_input_authority_action;
+  QAction* m_host_input_prediction_action;
   QAction* m_golf_mode_action;
   QAction* m_golf_mode_overlay_action;
   QAction* m_fixed_delay_action;
+  QAction* m_rollback_action;
+  QAction* m_auto_buffer_action;
+  QAction* m_memory_hash_action;
+  QAction* m_spectator_relay_action;
   QAction* m_hide_remote_gbas_action;
   QPushButton* m_quit_button;
   QSplitter* m_splitter;
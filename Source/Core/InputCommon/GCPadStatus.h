@@ -41,6 +41,8 @@ struct GCPadStatus
   u8 analogB = 0;       // 0 <= analogB      <= 255
   bool isConnected = true;
 
+  bool operator==(const GCPadStatus&) const = default;
+
   static const u8 MAIN_STICK_CENTER_X = 0x80;
   static const u8 MAIN_STICK_CENTER_Y = 0x80;
   static const u8 MAIN_STICK_RADIUS = 0x7f;
@@ -3,6 +3,9 @@
 
 #include "VideoCommon/Present.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "Common/ChunkFile.h"
 #include "Core/Config/GraphicsSettings.h"
 #include "Core/CoreTiming.h"
@@ -289,6 +292,24 @@ void Presenter::ProcessFrameDumping(u64 ticks) const
   }
 }
 
+FrameThumbnail Presenter::CaptureThumbnail()
+{
+  if (!m_xfb_entry)
+    return {};
+
+  // Captured with the display aspect ratio. Scaling it down to the size stored in savestates is
+  // left to the save thread.
+  constexpr float MAX_WIDTH = 320.0f;
+  constexpr float MAX_HEIGHT = 240.0f;
+  const bool allow_stretch = false;
+  const auto [width, height] =
+      ScaleToDisplayAspectRatio(m_xfb_rect.GetWidth(), m_xfb_rect.GetHeight(), allow_stretch);
+  const float scale = std::min({1.0f, MAX_WIDTH / width, MAX_HEIGHT / height});
+  return m_thumbnail_capture.CaptureFrame(m_xfb_entry->texture.get(), m_xfb_rect,
+                                          static_cast<u32>(std::lround(width * scale)),
+                                          static_cast<u32>(std::lround(height * scale)));
+}
+
 void Presenter::SetBackbuffer(int backbuffer_width, int backbuffer_height)
 {
   const bool is_first = m_backbuffer_width == 0 && m_backbuffer_height == 0;
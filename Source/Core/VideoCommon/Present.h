@@ -9,6 +9,7 @@
 #include "VideoCommon/OnScreenUIKeyMap.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/TextureConfig.h"
+#include "VideoCommon/ThumbnailCapture.h"
 #include "VideoCommon/VideoCommon.h"
 
 #include <array>
@@ -94,6 +95,10 @@ public:
 
   int FrameCount() const { return m_frame_count; }
 
+  // Reads back a scaled down copy of the last presented frame, for savestate thumbnails. Called on
+  // the GPU thread. Has no pixels if nothing has been presented yet.
+  FrameThumbnail CaptureThumbnail();
+
   void DoState(PointerWrap& p);
 
   const MathUtil::Rectangle<int>& GetTargetRectangle() const { return m_target_rectangle; }
@@ -154,6 +159,8 @@ private:
   std::unique_ptr<VideoCommon::PostProcessing> m_post_processor;
   std::unique_ptr<VideoCommon::OnScreenUI> m_onscreen_ui;
 
+  ThumbnailCapture m_thumbnail_capture;
+
   u64 m_frame_count = 0;
   u64 m_present_count = 0;
 
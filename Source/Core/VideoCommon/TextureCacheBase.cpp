@@ -470,9 +470,10 @@ void TextureCacheBase::SerializeTexture(AbstractTexture* tex, const TextureConfi
     // needing to allocate/free an extra buffer.
     u8* texture_data = p.DoExternal(total_size);
 
+    // Out of space. The savestate code grows its buffer and writes the state again in that case.
     if (!skip_readback && p.IsMeasureMode())
     {
-      ERROR_LOG_FMT(VIDEO, "Couldn't acquire {} bytes for serializing texture.", total_size);
+      DEBUG_LOG_FMT(VIDEO, "Couldn't acquire {} bytes for serializing texture.", total_size);
       return;
     }
 
@@ -0,0 +1,94 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/ThumbnailCapture.h"
+
+#include <cstring>
+
+#include "Common/Assert.h"
+#include "Common/Logging/Log.h"
+
+#include "VideoCommon/AbstractFramebuffer.h"
+#include "VideoCommon/AbstractGfx.h"
+#include "VideoCommon/AbstractStagingTexture.h"
+#include "VideoCommon/AbstractTexture.h"
+
+namespace VideoCommon
+{
+ThumbnailCapture::ThumbnailCapture() = default;
+
+ThumbnailCapture::~ThumbnailCapture() = default;
+
+FrameThumbnail ThumbnailCapture::CaptureFrame(const AbstractTexture* src_texture,
+                                              const MathUtil::Rectangle<int>& src_rect,
+                                              u32 target_width, u32 target_height)
+{
+  if (target_width == 0 || target_height == 0 || !CheckTextures(target_width, target_height))
+    return {};
+
+  g_gfx->ScaleTexture(m_render_framebuffer.get(), m_render_framebuffer->GetRect(), src_texture,
+                      src_rect);
+  m_readback_texture->CopyFromTexture(m_render_texture.get(), m_render_texture->GetRect(), 0, 0,
+                                      m_readback_texture->GetRect());
+  m_readback_texture->Flush();
+  if (!m_readback_texture->Map())
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to map thumbnail readback texture");
+    return {};
+  }
+
+  FrameThumbnail frame;
+  frame.width = target_width;
+  frame.height = target_height;
+  const size_t row_size = frame.width * 4;
+  frame.pixels.resize(row_size * frame.height);
+
+  const char* src = m_readback_texture->GetMappedPointer();
+  const size_t src_stride = m_readback_texture->GetMappedStride();
+  for (u32 row = 0; row < frame.height; ++row)
+    std::memcpy(frame.pixels.data() + row * row_size, src + row * src_stride, row_size);
+  m_readback_texture->Unmap();
+
+  return frame;
+}
+
+bool ThumbnailCapture::CheckTextures(u32 target_width, u32 target_height)
+{
+  if (m_render_texture && m_render_texture->GetWidth() == target_width &&
+      m_render_texture->GetHeight() == target_height)
+  {
+    return true;
+  }
+
+  // Release before creating so we don't temporarily use twice the memory.
+  m_render_framebuffer.reset();
+  m_render_texture.reset();
+  m_readback_texture.reset();
+
+  m_render_texture = g_gfx->CreateTexture(
+      TextureConfig(target_width, target_height, 1, 1, 1, AbstractTextureFormat::RGBA8,
+                    AbstractTextureFlag_RenderTarget, AbstractTextureType::Texture_2DArray),
+      "Thumbnail render texture");
+  if (!m_render_texture)
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to allocate thumbnail render texture");
+    return false;
+  }
+  m_render_framebuffer = g_gfx->CreateFramebuffer(m_render_texture.get(), nullptr);
+  ASSERT(m_render_framebuffer);
+
+  m_readback_texture = g_gfx->CreateStagingTexture(
+      StagingTextureType::Readback,
+      TextureConfig(target_width, target_height, 1, 1, 1, AbstractTextureFormat::RGBA8, 0,
+                    AbstractTextureType::Texture_2DArray));
+  if (!m_readback_texture)
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to allocate thumbnail readback texture");
+    m_render_framebuffer.reset();
+    m_render_texture.reset();
+    return false;
+  }
+
+  return true;
+}
+}  // namespace VideoCommon
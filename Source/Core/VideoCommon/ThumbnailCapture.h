@@ -0,0 +1,48 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/MathUtil.h"
+
+class AbstractFramebuffer;
+class AbstractStagingTexture;
+class AbstractTexture;
+
+namespace VideoCommon
+{
+// A small copy of a presented frame in main memory.
+struct FrameThumbnail
+{
+  u32 width = 0;
+  u32 height = 0;
+  // RGBA8, with rows width * 4 bytes apart. Empty if the frame couldn't be captured.
+  std::vector<u8> pixels;
+};
+
+// Reads a scaled down copy of a frame back to main memory, for savestate thumbnails. Only done when
+// a save asks for it, as the readback waits for the GPU to finish the copy.
+class ThumbnailCapture
+{
+public:
+  ThumbnailCapture();
+  ~ThumbnailCapture();
+
+  // Scales src_rect of src_texture to the target size and reads it back. Called on the GPU thread.
+  FrameThumbnail CaptureFrame(const AbstractTexture* src_texture,
+                              const MathUtil::Rectangle<int>& src_rect, u32 target_width,
+                              u32 target_height);
+
+private:
+  // Checks that the render and readback textures exist and are the correct size.
+  bool CheckTextures(u32 target_width, u32 target_height);
+
+  std::unique_ptr<AbstractTexture> m_render_texture;
+  std::unique_ptr<AbstractFramebuffer> m_render_framebuffer;
+  std::unique_ptr<AbstractStagingTexture> m_readback_texture;
+};
+}  // namespace VideoCommon
@@ -0,0 +1,96 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/MPSCQueue.h"
+
+TEST(MPSCQueue, Simple)
+{
+  Common::MPSCQueue<u32> q;
+
+  EXPECT_TRUE(q.Empty());
+
+  q.Push(1);
+  EXPECT_FALSE(q.Empty());
+
+  u32 v;
+  EXPECT_TRUE(q.Pop(v));
+  EXPECT_EQ(1u, v);
+  EXPECT_TRUE(q.Empty());
+  EXPECT_FALSE(q.Pop(v));
+
+  // Test the FIFO order.
+  for (u32 i = 0; i < 1000; ++i)
+    q.Push(i);
+  for (u32 i = 0; i < 1000; ++i)
+  {
+    EXPECT_EQ(i, q.Front());
+    q.Pop();
+  }
+  EXPECT_TRUE(q.Empty());
+
+  for (u32 i = 0; i < 1000; ++i)
+    q.Push(i);
+  EXPECT_FALSE(q.Empty());
+  q.Clear();
+  EXPECT_TRUE(q.Empty());
+}
+
+TEST(MPSCQueue, MultiThreaded)
+{
+  struct Foo
+  {
+    std::shared_ptr<int> ptr;
+    u32 producer;
+    u32 i;
+  };
+
+  // A shared_ptr held by every element in the queue.
+  auto sptr = std::make_shared<int>(0);
+
+  auto queue_ptr = std::make_unique<Common::MPSCQueue<Foo>>();
+  auto& q = *queue_ptr;
+
+  constexpr u32 producer_count = 4;
+  constexpr u32 reps = 100000;
+
+  std::vector<std::thread> producers;
+  for (u32 producer = 0; producer != producer_count; ++producer)
+  {
+    producers.emplace_back([&, producer] {
+      for (u32 i = 0; i != reps; ++i)
+        q.Push({sptr, producer, i});
+    });
+  }
+
+  // Items of different producers interleave, but each producer's own items stay in order.
+  std::array<u32, producer_count> next{};
+  for (u32 received = 0; received != producer_count * reps;)
+  {
+    Foo foo;
+    if (!q.Pop(foo))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    EXPECT_EQ(next[foo.producer]++, foo.i);
+    ++received;
+  }
+
+  for (std::thread& thread : producers)
+    thread.join();
+
+  EXPECT_TRUE(q.Empty());
+  q.Push({sptr, 0, 0});
+  EXPECT_EQ(sptr.use_count(), 2);
+
+  queue_ptr.reset();
+  EXPECT_EQ(sptr.use_count(), 1);
+}
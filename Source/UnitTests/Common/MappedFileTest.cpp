@@ -0,0 +1,72 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/MappedFile.h"
+
+class MappedFileTest : public testing::Test
+{
+protected:
+  MappedFileTest()
+      : m_parent_directory(File::CreateTempDir()), m_file_path(m_parent_directory + "/file.bin")
+  {
+  }
+
+  ~MappedFileTest() override
+  {
+    if (!m_parent_directory.empty())
+      File::DeleteDirRecursively(m_parent_directory);
+  }
+
+  void SetUp() override
+  {
+    if (m_parent_directory.empty())
+      FAIL();
+  }
+
+  const std::string m_parent_directory;
+  const std::string m_file_path;
+};
+
+TEST_F(MappedFileTest, MapsContents)
+{
+  std::vector<u8> contents(100000);
+  std::iota(contents.begin(), contents.end(), u8(0));
+  {
+    File::IOFile f(m_file_path, "wb");
+    ASSERT_TRUE(f.WriteBytes(contents.data(), contents.size()));
+  }
+
+  File::MappedFile file(m_file_path);
+  ASSERT_TRUE(file.IsOpen());
+  EXPECT_TRUE(std::ranges::equal(file.GetData(), contents));
+
+  file.Close();
+  EXPECT_FALSE(file.IsOpen());
+  EXPECT_TRUE(file.GetData().empty());
+}
+
+TEST_F(MappedFileTest, EmptyFile)
+{
+  ASSERT_TRUE(File::CreateEmptyFile(m_file_path));
+
+  File::MappedFile file;
+  ASSERT_TRUE(file.Open(m_file_path));
+  EXPECT_TRUE(file.GetData().empty());
+}
+
+TEST_F(MappedFileTest, MissingFile)
+{
+  File::MappedFile file;
+  EXPECT_FALSE(file.Open(m_file_path));
+  EXPECT_FALSE(file.IsOpen());
+}
@@ -0,0 +1,124 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <SFML/Network/Packet.hpp>
+
+#include <gtest/gtest.h>
+
+#include "Core/NetPlayInputDelta.h"
+
+namespace
+{
+GCPadStatus MakePad(u16 button, u8 stick_x)
+{
+  GCPadStatus pad;
+  pad.button = button;
+  pad.stickX = stick_x;
+  pad.stickY = GCPadStatus::MAIN_STICK_CENTER_Y;
+  return pad;
+}
+
+WiimoteEmu::SerializedWiimoteState MakeWiimote(u8 length, u8 seed)
+{
+  WiimoteEmu::SerializedWiimoteState state{};
+  state.length = length;
+  for (u8 i = 0; i < length; ++i)
+    state.data[i] = static_cast<u8>(seed + i);
+  return state;
+}
+}  // namespace
+
+TEST(NetPlayInputDelta, PadRoundTrip)
+{
+  NetPlay::InputDeltaState sender;
+  NetPlay::InputDeltaState receiver;
+
+  u32 number = 0;
+  for (const GCPadStatus& pad : {MakePad(0, 0x80), MakePad(0x100, 0x80), MakePad(0x100, 0xff),
+                                 MakePad(0, 0x10)})
+  {
+    sf::Packet packet;
+    sender.WritePad(2, number, pad, packet);
+
+    u32 received_number;
+    GCPadStatus received;
+    ASSERT_TRUE(receiver.ReadPad(2, packet, &received_number, &received));
+    EXPECT_EQ(received_number, number);
+    EXPECT_EQ(received, pad);
+    EXPECT_TRUE(packet.endOfPacket());
+    ++number;
+  }
+}
+
+TEST(NetPlayInputDelta, UnchangedPadIsOnlyMask)
+{
+  NetPlay::InputDeltaState sender;
+  sf::Packet first;
+  sender.WritePad(0, 0, MakePad(0x10, 0x20), first);
+
+  sf::Packet second;
+  sender.WritePad(0, 1, MakePad(0x10, 0x20), second);
+  EXPECT_EQ(second.getDataSize(), sizeof(u16));
+}
+
+TEST(NetPlayInputDelta, PadNumberCanSkip)
+{
+  NetPlay::InputDeltaState sender;
+  NetPlay::InputDeltaState receiver;
+
+  // A repeated number and a jump both have to be sent.
+  for (const u32 number : {0u, 0u, 5u, 6u})
+  {
+    sf::Packet packet;
+    sender.WritePad(1, number, MakePad(0, 0x80), packet);
+
+    u32 received_number;
+    GCPadStatus received;
+    ASSERT_TRUE(receiver.ReadPad(1, packet, &received_number, &received));
+    EXPECT_EQ(received_number, number);
+    EXPECT_TRUE(packet.endOfPacket());
+  }
+}
+
+TEST(NetPlayInputDelta, WiimoteRoundTrip)
+{
+  NetPlay::InputDeltaState sender;
+  NetPlay::InputDeltaState receiver;
+
+  for (const auto& state : {MakeWiimote(24, 0), MakeWiimote(24, 0), MakeWiimote(30, 7),
+                            MakeWiimote(0, 0), MakeWiimote(18, 3)})
+  {
+    sf::Packet packet;
+    sender.WriteWiimote(1, state, packet);
+
+    WiimoteEmu::SerializedWiimoteState received;
+    ASSERT_TRUE(receiver.ReadWiimote(1, packet, &received));
+    ASSERT_EQ(received.length, state.length);
+    for (size_t i = 0; i < state.length; ++i)
+      EXPECT_EQ(received.data[i], state.data[i]);
+  }
+}
+
+TEST(NetPlayInputDelta, RejectsMalformedData)
+{
+  NetPlay::InputDeltaState receiver;
+  u32 number;
+  GCPadStatus pad;
+
+  sf::Packet bad_mask;
+  bad_mask << u16{0x8000};
+  EXPECT_FALSE(receiver.ReadPad(0, bad_mask, &number, &pad));
+
+  sf::Packet truncated;
+  truncated << u16{1};
+  EXPECT_FALSE(receiver.ReadPad(0, truncated, &number, &pad));
+
+  sf::Packet bad_slot;
+  bad_slot << u16{0};
+  EXPECT_FALSE(receiver.ReadPad(4, bad_slot, &number, &pad));
+
+  WiimoteEmu::SerializedWiimoteState state;
+  sf::Packet too_long;
+  too_long << u8{31};
+  EXPECT_FALSE(receiver.ReadWiimote(0, too_long, &state));
+}
@@ -0,0 +1,171 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <optional>
+#include <string>
+
+#include <enet/enet.h>
+
+#include <gtest/gtest.h>
+
+#include "Core/NetPlayLinkSimulator.h"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+class Socket
+{
+public:
+  Socket()
+  {
+    m_socket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+    ENetAddress address;
+    address.host = 0x0100007f;  // localhost
+    address.port = ENET_PORT_ANY;
+    enet_socket_set_option(m_socket, ENET_SOCKOPT_NONBLOCK, 1);
+    enet_socket_bind(m_socket, &address);
+    enet_socket_get_address(m_socket, &m_address);
+  }
+  ~Socket() { enet_socket_destroy(m_socket); }
+
+  const ENetAddress& GetAddress() const { return m_address; }
+
+  void Send(u16 port, std::string data)
+  {
+    ENetAddress address;
+    address.host = 0x0100007f;
+    address.port = port;
+    Send(address, std::move(data));
+  }
+
+  void Send(const ENetAddress& address, std::string data)
+  {
+    ENetBuffer buffer;
+    buffer.data = data.data();
+    buffer.dataLength = data.size();
+    enet_socket_send(m_socket, &address, &buffer, 1);
+  }
+
+  std::optional<std::string> Receive(std::chrono::milliseconds timeout,
+                                     ENetAddress* source = nullptr)
+  {
+    const Clock::time_point end = Clock::now() + timeout;
+    while (true)
+    {
+      char data[256];
+      ENetBuffer buffer;
+      buffer.data = data;
+      buffer.dataLength = sizeof(data);
+      ENetAddress address;
+      const int size = enet_socket_receive(m_socket, &address, &buffer, 1);
+      if (size > 0)
+      {
+        if (source)
+          *source = address;
+        return std::string(data, size);
+      }
+
+      const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(end - Clock::now());
+      if (remaining.count() <= 0)
+        return std::nullopt;
+
+      ENetSocketSet read_set;
+      ENET_SOCKETSET_EMPTY(read_set);
+      ENET_SOCKETSET_ADD(read_set, m_socket);
+      enet_socketset_select(m_socket, &read_set, nullptr, u32(remaining.count()));
+    }
+  }
+
+private:
+  ENetSocket m_socket;
+  ENetAddress m_address;
+};
+
+constexpr auto TIMEOUT = std::chrono::milliseconds(1000);
+
+class NetPlayLinkSimulatorTest : public testing::Test
+{
+protected:
+  void SetUp() override { ASSERT_EQ(enet_initialize(), 0); }
+  void TearDown() override { enet_deinitialize(); }
+};
+}  // namespace
+
+TEST_F(NetPlayLinkSimulatorTest, RelaysBothWays)
+{
+  Socket target;
+  Socket peer;
+  NetPlay::LinkSimulator link(target.GetAddress(), {}, 0);
+  ASSERT_TRUE(link.IsValid());
+
+  peer.Send(link.GetPort(), "ping");
+  ENetAddress source;
+  EXPECT_EQ(target.Receive(TIMEOUT, &source), "ping");
+
+  target.Send(source, "pong");
+  EXPECT_EQ(peer.Receive(TIMEOUT), "pong");
+
+  EXPECT_EQ(link.GetUpstreamStats().datagrams_forwarded, 1u);
+  EXPECT_EQ(link.GetUpstreamStats().bytes_forwarded, 4u);
+  EXPECT_EQ(link.GetDownstreamStats().datagrams_forwarded, 1u);
+}
+
+TEST_F(NetPlayLinkSimulatorTest, AddsRoundTripTime)
+{
+  Socket target;
+  Socket peer;
+  NetPlay::LinkConditions conditions;
+  conditions.rtt_ms = 100;
+  NetPlay::LinkSimulator link(target.GetAddress(), conditions, 0);
+  ASSERT_TRUE(link.IsValid());
+
+  const Clock::time_point start = Clock::now();
+  peer.Send(link.GetPort(), "ping");
+  ENetAddress source;
+  ASSERT_EQ(target.Receive(TIMEOUT, &source), "ping");
+  target.Send(source, "pong");
+  ASSERT_EQ(peer.Receive(TIMEOUT), "pong");
+
+  EXPECT_GE(Clock::now() - start, std::chrono::milliseconds(conditions.rtt_ms));
+}
+
+TEST_F(NetPlayLinkSimulatorTest, DropsAtFullLoss)
+{
+  Socket target;
+  Socket peer;
+  NetPlay::LinkConditions conditions;
+  conditions.loss = 1.0;
+  NetPlay::LinkSimulator link(target.GetAddress(), conditions, 0);
+  ASSERT_TRUE(link.IsValid());
+
+  for (int i = 0; i < 10; ++i)
+    peer.Send(link.GetPort(), "lost");
+  EXPECT_EQ(target.Receive(std::chrono::milliseconds(100)), std::nullopt);
+
+  EXPECT_EQ(link.GetUpstreamStats().datagrams_forwarded, 0u);
+  EXPECT_EQ(link.GetUpstreamStats().datagrams_dropped, 10u);
+}
+
+TEST_F(NetPlayLinkSimulatorTest, SeparatesPeers)
+{
+  Socket target;
+  Socket peer_a;
+  Socket peer_b;
+  NetPlay::LinkSimulator link(target.GetAddress(), {}, 0);
+  ASSERT_TRUE(link.IsValid());
+
+  ENetAddress source_a;
+  ENetAddress source_b;
+  peer_a.Send(link.GetPort(), "a");
+  ASSERT_EQ(target.Receive(TIMEOUT, &source_a), "a");
+  peer_b.Send(link.GetPort(), "b");
+  ASSERT_EQ(target.Receive(TIMEOUT, &source_b), "b");
+  EXPECT_NE(source_a.port, source_b.port);
+
+  target.Send(source_b, "to b");
+  target.Send(source_a, "to a");
+  EXPECT_EQ(peer_a.Receive(TIMEOUT), "to a");
+  EXPECT_EQ(peer_b.Receive(TIMEOUT), "to b");
+}
@@ -0,0 +1,243 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/NetPlayRollback.h"
+#include "InputCommon/GCPadStatus.h"
+
+using namespace NetPlay;
+
+namespace
+{
+GCPadStatus MakePad(u16 button)
+{
+  GCPadStatus pad;
+  pad.button = button;
+  return pad;
+}
+
+// Begins a frame like the client does, pretending to save its state once the poll is done.
+RollbackFrame* BeginFrame(RollbackTimeline& timeline)
+{
+  RollbackFrame* entry = timeline.BeginFrame();
+  if (entry)
+    entry->state_size = 1;
+  return entry;
+}
+
+RollbackTimeline MakeTimeline()
+{
+  RollbackTimeline timeline;
+  timeline.Reset();
+  timeline.SetPad(0, RollbackPad::Remote);
+  return timeline;
+}
+}  // namespace
+
+TEST(NetPlayRollback, ConfirmedInputIsUsed)
+{
+  RollbackTimeline timeline = MakeTimeline();
+  timeline.AddInput(0, MakePad(PAD_BUTTON_A));
+
+  const RollbackFrame* entry = BeginFrame(timeline);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->frame, 0u);
+  EXPECT_EQ(entry->inputs[0], MakePad(PAD_BUTTON_A));
+  EXPECT_FALSE(entry->predicted[0]);
+}
+
+TEST(NetPlayRollback, EarlyInputsWaitForTheirFrame)
+{
+  RollbackTimeline timeline = MakeTimeline();
+  timeline.AddInput(0, MakePad(PAD_BUTTON_A));
+  timeline.AddInput(0, MakePad(PAD_BUTTON_B));
+
+  EXPECT_EQ(BeginFrame(timeline)->inputs[0], MakePad(PAD_BUTTON_A));
+  EXPECT_EQ(BeginFrame(timeline)->inputs[0], MakePad(PAD_BUTTON_B));
+  EXPECT_TRUE(BeginFrame(timeline)->predicted[0]);
+}
+
+TEST(NetPlayRollback, FirstFrameIsNeverPredicted)
+{
+  // There is no state from before it to roll back to.
+  RollbackTimeline timeline = MakeTimeline();
+  EXPECT_EQ(BeginFrame(timeline), nullptr);
+  EXPECT_EQ(timeline.GetFrame(), 0u);
+}
+
+TEST(NetPlayRollback, UnusedPadsReadAsDefault)
+{
+  RollbackTimeline timeline;
+  timeline.Reset();
+
+  const RollbackFrame* entry = BeginFrame(timeline);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->inputs[0], GCPadStatus{});
+  EXPECT_FALSE(entry->predicted[0]);
+}
+
+TEST(NetPlayRollback, PredictsLastConfirmedInput)
+{
+  RollbackTimeline timeline = MakeTimeline();
+  timeline.AddInput(0, MakePad(PAD_BUTTON_A));
+  BeginFrame(timeline);
+
+  const RollbackFrame* entry = BeginFrame(timeline);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->inputs[0], MakePad(PAD_BUTTON_A));
+  EXPECT_TRUE(entry->predicted[0]);
+}
+
+TEST(NetPlayRollback, PredictsSpeculativeLocalInput)
+{
+  RollbackTimeline timeline = MakeTimeline();
+  timeline.SetPad(1, RollbackPad::SpeculativeLocal);
+  timeline.AddInput(0, MakePad(0));
+  timeline.AddLocalInput(1, 0, MakePad(PAD_BUTTON_A));
+  timeline.AddInput(1, MakePad(PAD_BUTTON_A), 0);
+  BeginFrame(timeline);
+
+  timeline.AddLocalInput(1, 1, MakePad(PAD_BUTTON_X));
+  const RollbackFrame* entry = BeginFrame(timeline);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->inputs[1], MakePad(PAD_BUTTON_X));
+  EXPECT_TRUE(entry->predicted[1]);
+}
+
+TEST(NetPlayRollback, SpeculativeLocalInputFollowsHostDelay)
+{
+  RollbackTimeline timeline;
+  timeline.Reset();
+  timeline.SetPad(0, RollbackPad::SpeculativeLocal);
+
+  // The host only has our first input for its first three frames, after which it applies every
+  // input of ours two frames after we polled it.
+  const u16 buttons[] = {0, PAD_BUTTON_A, PAD_BUTTON_B, PAD_BUTTON_X, PAD_BUTTON_Y};
+  for (u32 frame = 0; frame < 3; ++frame)
+  {
+    timeline.AddLocalInput(0, frame, MakePad(buttons[frame]));
+    timeline.AddInput(0, MakePad(buttons[0]), 0);
+    ASSERT_NE(BeginFrame(timeline), nullptr);
+  }
+
+  for (u32 frame = 3; frame < 5; ++frame)
+  {
+    timeline.AddLocalInput(0, frame, MakePad(buttons[frame]));
+    const RollbackFrame* entry = BeginFrame(timeline);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_TRUE(entry->predicted[0]);
+    EXPECT_EQ(entry->inputs[0], MakePad(buttons[frame - 2]));
+  }
+
+  // Which is what the host goes on to confirm.
+  timeline.AddInput(0, MakePad(buttons[1]), 1);
+  timeline.AddInput(0, MakePad(buttons[2]), 2);
+  EXPECT_FALSE(timeline.IsRollbackPending());
+}
+
+TEST(NetPlayRollback, CorrectPredictionIsConfirmed)
+{
+  RollbackTimeline timeline = MakeTimeline();
+  timeline.AddInput(0, MakePad(PAD_BUTTON_A));
+  BeginFrame(timeline);
+  RollbackFrame* predicted = BeginFrame(timeline);
+
+  timeline.AddInput(0, MakePad(PAD_BUTTON_A));
+  EXPECT_FALSE(predicted->predicted[0]);
+  EXPECT_FALSE(timeline.IsRollbackPending());
+  EXPECT_EQ(timeline.TakeRollback(), nullptr);
+}
+
+TEST(NetPlayRollback, MispredictionRollsBackToOldestWrongFrame)
+{
+  RollbackTimeline timeline = MakeTimeline();
+  timeline.AddInput(0, MakePad(0));
+  BeginFrame(timeline);
+  for (int i = 0; i < 3; ++i)
+    ASSERT_TRUE(BeginFrame(timeline)->predicted[0]);
+
+  // Frame 1 was right, 2 and 3 were wrong.
+  timeline.AddInput(0, MakePad(0));
+  timeline.AddInput(0, MakePad(PAD_BUTTON_A));
+  timeline.AddInput(0, MakePad(PAD_BUTTON_B));
+  ASSERT_TRUE(timeline.IsRollbackPending());
+
+  // The state after frame 1's poll is the one to load.
+  const RollbackFrame* load = timeline.TakeRollback();
+  ASSERT_NE(load, nullptr);
+  EXPECT_EQ(load->frame, 1u);
+  EXPECT_FALSE(timeline.IsRollbackPending());
+  EXPECT_TRUE(timeline.IsResimulating());
+
+  const RollbackFrame* entry = BeginFrame(timeline);
+  EXPECT_EQ(entry->frame, 2u);
+  EXPECT_EQ(entry->inputs[0], MakePad(PAD_BUTTON_A));
+  entry = BeginFrame(timeline);
+  EXPECT_EQ(entry->frame, 3u);
+  EXPECT_EQ(entry->inputs[0], MakePad(PAD_BUTTON_B));
+  EXPECT_FALSE(timeline.IsResimulating());
+
+  entry = BeginFrame(timeline);
+  EXPECT_EQ(entry->frame, 4u);
+  EXPECT_TRUE(entry->predicted[0]);
+  EXPECT_EQ(entry->inputs[0], MakePad(PAD_BUTTON_B));
+}
+
+TEST(NetPlayRollback, ResimulationRefreshesRemainingPredictions)
+{
+  RollbackTimeline timeline = MakeTimeline();
+  timeline.AddInput(0, MakePad(0));
+  BeginFrame(timeline);
+  BeginFrame(timeline);
+  BeginFrame(timeline);
+
+  timeline.AddInput(0, MakePad(PAD_BUTTON_A));
+  ASSERT_NE(timeline.TakeRollback(), nullptr);
+
+  BeginFrame(timeline);
+  const RollbackFrame* entry = BeginFrame(timeline);
+  EXPECT_EQ(entry->frame, 2u);
+  EXPECT_TRUE(entry->predicted[0]);
+  EXPECT_EQ(entry->inputs[0], MakePad(PAD_BUTTON_A));
+}
+
+TEST(NetPlayRollback, InputForFrameNotYetResimulatedNeedsNoRollback)
+{
+  RollbackTimeline timeline = MakeTimeline();
+  timeline.AddInput(0, MakePad(0));
+  BeginFrame(timeline);
+  BeginFrame(timeline);
+  BeginFrame(timeline);
+
+  timeline.AddInput(0, MakePad(PAD_BUTTON_A));
+  ASSERT_NE(timeline.TakeRollback(), nullptr);
+
+  // Frame 2 hasn't been re-simulated yet, so it just picks up the input.
+  timeline.AddInput(0, MakePad(PAD_BUTTON_B));
+  EXPECT_FALSE(timeline.IsRollbackPending());
+
+  BeginFrame(timeline);
+  const RollbackFrame* entry = BeginFrame(timeline);
+  EXPECT_FALSE(entry->predicted[0]);
+  EXPECT_EQ(entry->inputs[0], MakePad(PAD_BUTTON_B));
+}
+
+TEST(NetPlayRollback, PredictionStopsAtRollbackWindow)
+{
+  RollbackTimeline timeline = MakeTimeline();
+  timeline.AddInput(0, MakePad(0));
+  BeginFrame(timeline);
+
+  int predicted_frames = 0;
+  while (BeginFrame(timeline))
+    ++predicted_frames;
+
+  // The state from before the oldest predicted frame has to stay around.
+  EXPECT_EQ(predicted_frames, rollback_frames_supported - 1);
+
+  timeline.AddInput(0, MakePad(0));
+  EXPECT_NE(BeginFrame(timeline), nullptr);
+  EXPECT_EQ(BeginFrame(timeline), nullptr);
+}
@@ -0,0 +1,80 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include <SFML/Network/Packet.hpp>
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/SFMLHelper.h"
+#include "Core/NetPlayProto.h"
+#include "Core/NetPlaySendQueue.h"
+
+using namespace NetPlay;
+
+namespace
+{
+sf::Packet MakePacket(MessageID id)
+{
+  sf::Packet packet;
+  packet << id;
+  return packet;
+}
+}  // namespace
+
+TEST(NetPlaySendQueue, Priority)
+{
+  EXPECT_EQ(GetSendPriority(MakePacket(MessageID::PadData), DEFAULT_CHANNEL), SendPriority::Input);
+  EXPECT_EQ(GetSendPriority(MakePacket(MessageID::WiimoteData), DEFAULT_CHANNEL),
+            SendPriority::Input);
+  EXPECT_EQ(GetSendPriority(MakePacket(MessageID::ChatMessage), DEFAULT_CHANNEL),
+            SendPriority::Default);
+  EXPECT_EQ(GetSendPriority(MakePacket(MessageID::ChunkedDataPayload), CHUNKED_DATA_CHANNEL),
+            SendPriority::Bulk);
+  EXPECT_EQ(GetSendPriority(sf::Packet(), DEFAULT_CHANNEL), SendPriority::Default);
+}
+
+TEST(NetPlaySendQueue, InputsPreemptBulk)
+{
+  SendQueue<u32> queue;
+  queue.Push(SendPriority::Bulk, 10);
+  queue.Push(SendPriority::Bulk, 11);
+  queue.Push(SendPriority::Default, 5);
+  queue.Push(SendPriority::Input, 0);
+  queue.Push(SendPriority::Bulk, 12);
+  queue.Push(SendPriority::Input, 1);
+
+  // An input queued while bulk data goes out is sent before the next bulk packet
+  std::vector<u32> sent;
+  queue.Drain(
+      [&](u32 entry) {
+        sent.push_back(entry);
+        if (entry == 10)
+          queue.Push(SendPriority::Input, 2);
+      },
+      [](u32) { return true; });
+
+  EXPECT_EQ(sent, (std::vector<u32>{0, 1, 5, 10, 2, 11, 12}));
+  EXPECT_FALSE(queue.HasBulk());
+}
+
+TEST(NetPlaySendQueue, BulkIsHeldBack)
+{
+  SendQueue<u32> queue;
+  queue.Push(SendPriority::Bulk, 10);
+  queue.Push(SendPriority::Bulk, 11);
+  queue.Push(SendPriority::Input, 0);
+
+  std::vector<u32> sent;
+  const auto send = [&](u32 entry) { sent.push_back(entry); };
+
+  u32 allowed = 1;
+  queue.Drain(send, [&](u32) { return allowed-- > 0; });
+  EXPECT_EQ(sent, (std::vector<u32>{0, 10}));
+  EXPECT_TRUE(queue.HasBulk());
+
+  queue.Drain(send, [](u32) { return true; });
+  EXPECT_EQ(sent, (std::vector<u32>{0, 10, 11}));
+  EXPECT_FALSE(queue.HasBulk());
+}
@@ -0,0 +1,100 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <numeric>
+
+#include <gtest/gtest.h>
+
+#include "Common/Buffer.h"
+#include "Common/CommonTypes.h"
+#include "Core/StateDelta.h"
+
+namespace
+{
+Common::UniqueBuffer<u8> MakeBuffer(size_t size)
+{
+  Common::UniqueBuffer<u8> buffer(size);
+  std::iota(buffer.begin(), buffer.end(), u8(0));
+  return buffer;
+}
+
+bool Equal(const Common::UniqueBuffer<u8>& a, const Common::UniqueBuffer<u8>& b)
+{
+  return std::ranges::equal(a, b);
+}
+}  // namespace
+
+TEST(StateDelta, UnchangedStateIsSmall)
+{
+  const Common::UniqueBuffer<u8> base = MakeBuffer(64 * State::DELTA_PAGE_SIZE);
+  Common::UniqueBuffer<u8> delta;
+  State::MakeStateDelta(base, base, delta);
+  EXPECT_LT(delta.size(), State::DELTA_PAGE_SIZE);
+
+  Common::UniqueBuffer<u8> restored;
+  ASSERT_TRUE(State::ApplyStateDelta(base, delta, restored));
+  EXPECT_TRUE(Equal(restored, base));
+}
+
+TEST(StateDelta, StoresOnlyChangedPages)
+{
+  const Common::UniqueBuffer<u8> base = MakeBuffer(64 * State::DELTA_PAGE_SIZE);
+  Common::UniqueBuffer<u8> state = MakeBuffer(base.size());
+  state[5] ^= 1;
+  state[10 * State::DELTA_PAGE_SIZE] ^= 1;
+  state[11 * State::DELTA_PAGE_SIZE + 7] ^= 1;
+
+  Common::UniqueBuffer<u8> delta;
+  State::MakeStateDelta(base, state, delta);
+  EXPECT_GE(delta.size(), 3 * State::DELTA_PAGE_SIZE);
+  EXPECT_LT(delta.size(), 4 * State::DELTA_PAGE_SIZE);
+
+  Common::UniqueBuffer<u8> restored;
+  ASSERT_TRUE(State::ApplyStateDelta(base, delta, restored));
+  EXPECT_TRUE(Equal(restored, state));
+}
+
+TEST(StateDelta, StateSizeChanges)
+{
+  const Common::UniqueBuffer<u8> base = MakeBuffer(10 * State::DELTA_PAGE_SIZE + 100);
+  Common::UniqueBuffer<u8> restored;
+  Common::UniqueBuffer<u8> delta;
+
+  const Common::UniqueBuffer<u8> grown = MakeBuffer(12 * State::DELTA_PAGE_SIZE + 3);
+  State::MakeStateDelta(base, grown, delta);
+  ASSERT_TRUE(State::ApplyStateDelta(base, delta, restored));
+  EXPECT_TRUE(Equal(restored, grown));
+
+  const Common::UniqueBuffer<u8> shrunk = MakeBuffer(3 * State::DELTA_PAGE_SIZE + 1);
+  State::MakeStateDelta(base, shrunk, delta);
+  ASSERT_TRUE(State::ApplyStateDelta(base, delta, restored));
+  EXPECT_TRUE(Equal(restored, shrunk));
+}
+
+TEST(StateDelta, RejectsWrongBase)
+{
+  const Common::UniqueBuffer<u8> base = MakeBuffer(8 * State::DELTA_PAGE_SIZE);
+  Common::UniqueBuffer<u8> state = MakeBuffer(base.size());
+  state[0] ^= 1;
+
+  Common::UniqueBuffer<u8> delta;
+  State::MakeStateDelta(base, state, delta);
+
+  const Common::UniqueBuffer<u8> other_base = MakeBuffer(base.size() + 1);
+  Common::UniqueBuffer<u8> restored;
+  EXPECT_FALSE(State::ApplyStateDelta(other_base, delta, restored));
+}
+
+TEST(StateDelta, RejectsTruncatedDelta)
+{
+  const Common::UniqueBuffer<u8> base = MakeBuffer(8 * State::DELTA_PAGE_SIZE);
+  Common::UniqueBuffer<u8> state = MakeBuffer(base.size());
+  state[3 * State::DELTA_PAGE_SIZE] ^= 1;
+
+  Common::UniqueBuffer<u8> delta;
+  State::MakeStateDelta(base, state, delta);
+
+  Common::UniqueBuffer<u8> restored;
+  EXPECT_FALSE(State::ApplyStateDelta(base, std::span(delta.data(), delta.size() - 1), restored));
+}
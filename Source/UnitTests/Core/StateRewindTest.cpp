@@ -0,0 +1,109 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "Common/Buffer.h"
+#include "Common/CommonTypes.h"
+#include "Core/StateDelta.h"
+#include "Core/StateRewind.h"
+
+namespace
+{
+constexpr size_t STATE_SIZE = 64 * State::DELTA_PAGE_SIZE;
+
+// A state that differs from the others in one page and a counter at the start. The rest is the
+// same noise in all of them, which doesn't compress, so the memory budget is actually reached.
+Common::UniqueBuffer<u8> MakeState(u32 index)
+{
+  Common::UniqueBuffer<u8> state(STATE_SIZE);
+  u32 seed = 1;
+  std::ranges::generate(state, [&seed] {
+    seed = seed * 1664525 + 1013904223;
+    return static_cast<u8>(seed >> 24);
+  });
+  std::copy_n(reinterpret_cast<const u8*>(&index), sizeof(index), state.begin());
+  state[(index % 64) * State::DELTA_PAGE_SIZE + 100] ^= 0xff;
+  return state;
+}
+
+bool Equal(const Common::UniqueBuffer<u8>& a, const Common::UniqueBuffer<u8>& b)
+{
+  return std::ranges::equal(a, b);
+}
+}  // namespace
+
+TEST(StateRewind, StepsBackThroughEverySnapshot)
+{
+  State::RewindBuffer buffer(256 * 1024 * 1024, 4);
+  for (u32 i = 0; i < 10; ++i)
+    buffer.Push(MakeState(i));
+  EXPECT_EQ(buffer.GetSnapshotCount(), 10u);
+
+  Common::UniqueBuffer<u8> state;
+  for (u32 i = 10; i-- > 0;)
+  {
+    ASSERT_TRUE(buffer.PopNewest(state));
+    EXPECT_TRUE(Equal(state, MakeState(i)));
+  }
+  EXPECT_FALSE(buffer.PopNewest(state));
+}
+
+TEST(StateRewind, PushAfterPop)
+{
+  State::RewindBuffer buffer(256 * 1024 * 1024, 4);
+  for (u32 i = 0; i < 6; ++i)
+    buffer.Push(MakeState(i));
+
+  Common::UniqueBuffer<u8> state;
+  ASSERT_TRUE(buffer.PopNewest(state));
+  ASSERT_TRUE(buffer.PopNewest(state));
+  ASSERT_TRUE(buffer.PopNewest(state));
+  EXPECT_TRUE(Equal(state, MakeState(3)));
+
+  buffer.Push(MakeState(100));
+  buffer.Push(MakeState(101));
+
+  ASSERT_TRUE(buffer.PopNewest(state));
+  EXPECT_TRUE(Equal(state, MakeState(101)));
+  ASSERT_TRUE(buffer.PopNewest(state));
+  EXPECT_TRUE(Equal(state, MakeState(100)));
+  ASSERT_TRUE(buffer.PopNewest(state));
+  EXPECT_TRUE(Equal(state, MakeState(2)));
+}
+
+TEST(StateRewind, StaysWithinBudget)
+{
+  // Enough for the uncompressed keyframe and a few compressed groups
+  constexpr size_t budget = 4 * STATE_SIZE;
+  State::RewindBuffer buffer(budget, 4);
+  for (u32 i = 0; i < 200; ++i)
+  {
+    buffer.Push(MakeState(i));
+    EXPECT_LE(buffer.GetMemoryUsage(), budget);
+  }
+  EXPECT_LT(buffer.GetSnapshotCount(), 200u);
+
+  // The oldest snapshots were the ones dropped
+  Common::UniqueBuffer<u8> state;
+  ASSERT_TRUE(buffer.PopNewest(state));
+  EXPECT_TRUE(Equal(state, MakeState(199)));
+}
+
+TEST(StateRewind, LoweringBudgetDropsOldestSnapshots)
+{
+  State::RewindBuffer buffer(256 * 1024 * 1024, 4);
+  for (u32 i = 0; i < 40; ++i)
+    buffer.Push(MakeState(i));
+
+  constexpr size_t budget = 4 * STATE_SIZE;
+  buffer.SetMemoryBudget(budget);
+  EXPECT_LE(buffer.GetMemoryUsage(), budget);
+  EXPECT_LT(buffer.GetSnapshotCount(), 40u);
+
+  Common::UniqueBuffer<u8> state;
+  ASSERT_TRUE(buffer.PopNewest(state));
+  EXPECT_TRUE(Equal(state, MakeState(39)));
+}
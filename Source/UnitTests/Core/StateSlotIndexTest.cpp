@@ -0,0 +1,162 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Core/StateSlotIndex.h"
+
+namespace
+{
+constexpr int SLOT_COUNT = 10;
+constexpr char GAME_ID[] = "GALE01";
+}  // namespace
+
+class StateSlotIndexTest : public testing::Test
+{
+protected:
+  StateSlotIndexTest() : m_directory(File::CreateTempDir() + "/") {}
+
+  ~StateSlotIndexTest() override
+  {
+    if (m_directory.size() > 1)
+      File::DeleteDirRecursively(m_directory);
+  }
+
+  void SetUp() override
+  {
+    if (m_directory.size() <= 1)
+      FAIL();
+  }
+
+  std::string GetSlotPath(int slot) const
+  {
+    return m_directory + State::MakeSlotFilename(GAME_ID, slot);
+  }
+
+  // The fake header time of a slot is the size of its file, and empty files can't be read. The
+  // fake thumbnail is the first byte of the file.
+  void WriteSlot(int slot, size_t size, u8 first_byte = 0) const
+  {
+    File::IOFile f(GetSlotPath(slot), "wb");
+    std::vector<u8> data(size);
+    if (!data.empty())
+      data[0] = first_byte;
+    f.WriteBytes(data.data(), data.size());
+  }
+
+  std::unique_ptr<State::SlotIndex> MakeIndex()
+  {
+    return std::make_unique<State::SlotIndex>(
+        m_directory, GAME_ID, SLOT_COUNT,
+        [this](const std::string& path) -> std::optional<State::SlotHeader> {
+          ++m_read_count;
+          File::IOFile f(path, "rb");
+          u8 first_byte;
+          if (!f.ReadArray(&first_byte, 1))
+            return std::nullopt;
+          return State::SlotHeader{static_cast<double>(f.GetSize()), {first_byte}};
+        });
+  }
+
+  const std::string m_directory;
+  int m_read_count = 0;
+};
+
+TEST_F(StateSlotIndexTest, ReadsEachSlotOnce)
+{
+  WriteSlot(1, 10);
+  WriteSlot(3, 30);
+
+  const auto index = MakeIndex();
+  const auto used_slots = index->GetUsedSlots();
+  ASSERT_EQ(used_slots.size(), 2u);
+  EXPECT_EQ(used_slots[0].first, 1);
+  EXPECT_EQ(used_slots[0].second.time, 10.0);
+  EXPECT_EQ(used_slots[1].first, 3);
+  EXPECT_EQ(used_slots[1].second.file_size, 30u);
+  EXPECT_EQ(m_read_count, 2);
+
+  EXPECT_FALSE(index->GetSlotInfo(2));
+  EXPECT_EQ(index->GetSlotInfo(1)->time, 10.0);
+  EXPECT_FALSE(index->GetSlotInfo(0));
+  EXPECT_FALSE(index->GetSlotInfo(SLOT_COUNT + 1));
+  EXPECT_EQ(m_read_count, 2);
+}
+
+TEST_F(StateSlotIndexTest, UnreadableSlot)
+{
+  WriteSlot(2, 0);
+
+  const auto index = MakeIndex();
+  const std::optional<State::SlotInfo> info = index->GetSlotInfo(2);
+  ASSERT_TRUE(info);
+  EXPECT_FALSE(info->time);
+  EXPECT_TRUE(index->GetUsedSlots().empty());
+}
+
+TEST_F(StateSlotIndexTest, WrittenStateIsNotRead)
+{
+  const auto index = MakeIndex();
+  EXPECT_TRUE(index->GetUsedSlots().empty());
+
+  WriteSlot(4, 40);
+  index->OnStateWritten(GetSlotPath(4), {1234.0, {1, 2, 3}});
+  index->OnStateWritten(m_directory + "lastState.sav", {1.0, {}});
+
+  EXPECT_EQ(index->GetSlotInfo(4)->time, 1234.0);
+  EXPECT_EQ(index->GetThumbnail(4), std::vector<u8>({1, 2, 3}));
+  EXPECT_EQ(m_read_count, 0);
+}
+
+TEST_F(StateSlotIndexTest, IndexFileIsReused)
+{
+  WriteSlot(1, 10);
+  WriteSlot(5, 50);
+  MakeIndex()->GetUsedSlots();
+  ASSERT_EQ(m_read_count, 2);
+
+  m_read_count = 0;
+  const auto index = MakeIndex();
+  EXPECT_EQ(index->GetUsedSlots().size(), 2u);
+  EXPECT_EQ(index->GetSlotInfo(5)->time, 50.0);
+  EXPECT_EQ(m_read_count, 0);
+}
+
+TEST_F(StateSlotIndexTest, ChangedSlotIsReadAgain)
+{
+  WriteSlot(1, 10);
+  WriteSlot(2, 20);
+  MakeIndex()->GetUsedSlots();
+
+  WriteSlot(2, 25);
+  File::Delete(GetSlotPath(1));
+
+  m_read_count = 0;
+  const auto index = MakeIndex();
+  EXPECT_FALSE(index->GetSlotInfo(1));
+  EXPECT_EQ(index->GetSlotInfo(2)->time, 25.0);
+  EXPECT_EQ(m_read_count, 1);
+}
+
+TEST_F(StateSlotIndexTest, ThumbnailsAreIndexed)
+{
+  WriteSlot(1, 10, 42);
+  WriteSlot(2, 20, 43);
+  MakeIndex()->GetUsedSlots();
+  ASSERT_EQ(m_read_count, 2);
+
+  m_read_count = 0;
+  const auto index = MakeIndex();
+  EXPECT_EQ(index->GetThumbnail(1), std::vector<u8>({42}));
+  EXPECT_EQ(index->GetThumbnail(2), std::vector<u8>({43}));
+  EXPECT_TRUE(index->GetThumbnail(3).empty());
+  EXPECT_EQ(m_read_count, 0);
+}
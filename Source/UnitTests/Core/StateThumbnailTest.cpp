@@ -0,0 +1,69 @@
+// Copyright 2025 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/StateThumbnail.h"
+
+TEST(StateThumbnail, Size)
+{
+  const State::ThumbnailSize small = State::GetThumbnailSize(100, 50);
+  EXPECT_EQ(small.width, 100u);
+  EXPECT_EQ(small.height, 50u);
+
+  const State::ThumbnailSize standard = State::GetThumbnailSize(640, 480);
+  EXPECT_EQ(standard.width, State::THUMBNAIL_MAX_WIDTH);
+  EXPECT_EQ(standard.height, State::THUMBNAIL_MAX_HEIGHT);
+
+  const State::ThumbnailSize wide = State::GetThumbnailSize(320, 180);
+  EXPECT_EQ(wide.width, State::THUMBNAIL_MAX_WIDTH);
+  EXPECT_EQ(wide.height, 90u);
+
+  const State::ThumbnailSize tall = State::GetThumbnailSize(100, 1000);
+  EXPECT_EQ(tall.width, 12u);
+  EXPECT_EQ(tall.height, State::THUMBNAIL_MAX_HEIGHT);
+}
+
+TEST(StateThumbnail, AveragesCoveredPixels)
+{
+  // Every 2x2 block of the image has the same pixels, with an alpha that must be dropped
+  constexpr u32 WIDTH = State::THUMBNAIL_MAX_WIDTH * 2;
+  constexpr u32 HEIGHT = State::THUMBNAIL_MAX_HEIGHT * 2;
+  std::vector<u8> rgba(WIDTH * HEIGHT * 4);
+  for (u32 y = 0; y < HEIGHT; ++y)
+  {
+    for (u32 x = 0; x < WIDTH; ++x)
+    {
+      u8* pixel = &rgba[(y * WIDTH + x) * 4];
+      pixel[0] = x % 2 == 0 ? 10 : 20;
+      pixel[1] = y % 2 == 0 ? 100 : 201;
+      pixel[2] = 255;
+      pixel[3] = 0;
+    }
+  }
+
+  const std::vector<u8> rgb = State::ScaleThumbnail(rgba, WIDTH, HEIGHT);
+  ASSERT_EQ(rgb.size(), size_t(State::THUMBNAIL_MAX_WIDTH) * State::THUMBNAIL_MAX_HEIGHT * 3);
+  for (size_t i = 0; i < rgb.size(); i += 3)
+  {
+    EXPECT_EQ(rgb[i], 15);
+    EXPECT_EQ(rgb[i + 1], 151);
+    EXPECT_EQ(rgb[i + 2], 255);
+  }
+}
+
+TEST(StateThumbnail, KeepsSmallImages)
+{
+  const std::vector<u8> rgba = {1, 2, 3, 4, 5, 6, 7, 8};
+  EXPECT_EQ(State::ScaleThumbnail(rgba, 2, 1), std::vector<u8>({1, 2, 3, 5, 6, 7}));
+}
+
+TEST(StateThumbnail, RejectsShortImages)
+{
+  const std::vector<u8> rgba(4 * 4 * 4 - 1);
+  EXPECT_TRUE(State::ScaleThumbnail(rgba, 4, 4).empty());
+  EXPECT_TRUE(State::ScaleThumbnail({}, 0, 0).empty());
+}